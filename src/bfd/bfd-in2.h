@@ -1712,6 +1712,33 @@ bfd_boolean bfd_generic_discard_group (bfd *abfd, asection *group);
 /* Extracted from cache.c.  */
 void bfd_set_cache_max_open(unsigned int nmax);
 
+/* Counters describing how the BFD file cache has been used.  */
+
+struct bfd_cache_statistics
+{
+  /* The most files the cache will keep open at once, how many it
+     has open now, and the most it has ever had open.  */
+  unsigned int max_open;
+  unsigned int open_files;
+  unsigned int peak_open_files;
+
+  /* The number of times a file was opened for a cached BFD, and how
+     many of those reopened a file the cache had closed.  */
+  unsigned long opens;
+  unsigned long reopens;
+
+  /* The number of files closed to make room for another.  */
+  unsigned long evictions;
+
+  /* The number of reopened files that were no longer the file first
+     opened for their BFD.  */
+  unsigned long changed_files;
+};
+
+void bfd_cache_get_statistics (struct bfd_cache_statistics *stats);
+
+bfd_boolean bfd_cache_file_p (bfd *abfd);
+
 bfd_boolean bfd_cache_close_all (void);
 
 /* Extracted from archures.c.  */
@@ -4233,6 +4260,11 @@ struct bfd
   /* ... and here: (``once'' means at least once).  */
   bfd_boolean opened_once;
 
+  /* What the file looked like when the caching routines first
+     opened it, so they can tell if it is replaced before they
+     reopen it.  */
+  struct bfd_cache_file_id *cache_file_id;
+
   /* Set if we have a locally maintained mtime value, rather than
      getting it from the file each time.  */
   bfd_boolean mtime_set;
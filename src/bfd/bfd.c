@@ -70,6 +70,11 @@ CODE_FRAGMENT
 .  {* ... and here: (``once'' means at least once).  *}
 .  bfd_boolean opened_once;
 .
+.  {* What the file looked like when the caching routines first
+.     opened it, so they can tell if it is replaced before they
+.     reopen it.  *}
+.  struct bfd_cache_file_id *cache_file_id;
+.
 .  {* Set if we have a locally maintained mtime value, rather than
 .     getting it from the file each time.  *}
 .  bfd_boolean mtime_set;
@@ -36,6 +36,12 @@ SECTION
 	close, closes it and opens the one wanted, returning its file
 	handle.
 
+	Unless the application sets a limit with
+	<<bfd_set_cache_max_open>>, the cache sizes itself from the
+	process's open file limit.  When a file that was closed to make
+	room is reopened, the cache checks that it is still the file it
+	first opened.
+
 */
 
 #include "bfd.h"
@@ -43,8 +49,22 @@ SECTION
 #include "libbfd.h"
 #include "libiberty.h"
 
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+
 static bfd_boolean bfd_cache_delete (bfd *);
 
+/* What a cached file looked like when the cache first opened it.  */
+
+struct bfd_cache_file_id
+{
+  dev_t dev;
+  ino_t ino;
+  off_t size;
+  time_t mtime;
+};
+
 
 static file_ptr
 cache_btell (struct bfd *abfd)
@@ -153,8 +173,8 @@ INTERNAL_FUNCTION
 	BFD_CACHE_MAX_OPEN macro
 
 DESCRIPTION
-	The maximum number of files which the cache will keep open at
-	one time.
+	The smallest number of files which the cache will keep open
+	at one time, whatever the process's open file limit.
 
 .#define BFD_CACHE_MAX_OPEN 10
 
@@ -163,7 +183,46 @@ DESCRIPTION
 /* The number of BFD files we have open.  */
 
 static unsigned int open_files;
-static unsigned int bfd_cache_max_open = BFD_CACHE_MAX_OPEN;
+
+/* The maximum number of BFD files we will keep open, or zero if it
+   has not been worked out yet.  */
+
+static unsigned int bfd_cache_max_open;
+
+/* How the cache has been doing; see bfd_cache_get_statistics.  */
+
+static struct bfd_cache_statistics cache_stats;
+
+/* Return the maximum number of files the cache may keep open.  Unless
+   the application has set one, use an eighth of the process's open
+   file limit, leaving the rest for the application and for files
+   BFD does not cache.  */
+
+static unsigned int
+max_open_files (void)
+{
+  if (bfd_cache_max_open == 0)
+    {
+      unsigned long max = BFD_CACHE_MAX_OPEN;
+
+#if defined (HAVE_GETRLIMIT) && defined (RLIMIT_NOFILE)
+      struct rlimit rlim;
+
+      if (getrlimit (RLIMIT_NOFILE, &rlim) == 0)
+	{
+	  if (rlim.rlim_cur == RLIM_INFINITY)
+	    max = 1024;
+	  else
+	    max = rlim.rlim_cur / 8;
+	}
+#endif
+      if (max < BFD_CACHE_MAX_OPEN)
+	max = BFD_CACHE_MAX_OPEN;
+      bfd_cache_max_open = max;
+    }
+
+  return bfd_cache_max_open;
+}
 
 /*
 FUNCTION
@@ -174,7 +233,8 @@ SYNOPSIS
 
 DESCRIPTION
 	Set the maximum number of files which the cache will keep
-	open at one time.
+	open at one time.  If @var{nmax} is zero, go back to sizing
+	the cache from the process's open file limit.
 
 */
 
@@ -185,6 +245,77 @@ bfd_set_cache_max_open (nmax)
   bfd_cache_max_open = nmax;
 }
 
+/*
+CODE_FRAGMENT
+.
+.{* Counters describing how the BFD file cache has been used.  *}
+.
+.struct bfd_cache_statistics
+.{
+.  {* The most files the cache will keep open at once, how many it
+.     has open now, and the most it has ever had open.  *}
+.  unsigned int max_open;
+.  unsigned int open_files;
+.  unsigned int peak_open_files;
+.
+.  {* The number of times a file was opened for a cached BFD, and how
+.     many of those reopened a file the cache had closed.  *}
+.  unsigned long opens;
+.  unsigned long reopens;
+.
+.  {* The number of files closed to make room for another.  *}
+.  unsigned long evictions;
+.
+.  {* The number of reopened files that were no longer the file first
+.     opened for their BFD.  *}
+.  unsigned long changed_files;
+.};
+.
+*/
+
+/*
+FUNCTION
+	bfd_cache_get_statistics
+
+SYNOPSIS
+	void bfd_cache_get_statistics (struct bfd_cache_statistics *stats);
+
+DESCRIPTION
+	Fill in @var{stats} with the file cache's counters.
+
+*/
+
+void
+bfd_cache_get_statistics (struct bfd_cache_statistics *stats)
+{
+  *stats = cache_stats;
+  stats->max_open = max_open_files ();
+  stats->open_files = open_files;
+}
+
+/*
+FUNCTION
+	bfd_cache_file_p
+
+SYNOPSIS
+	bfd_boolean bfd_cache_file_p (bfd *abfd);
+
+DESCRIPTION
+	Return TRUE if @var{abfd}, or the archive it is a member of, is
+	read from a file that the cache opens, so that the file can be
+	mapped by <<bfd_get_file_window>>.  BFDs opened with
+	<<bfd_openr_iovec>> are not.
+
+*/
+
+bfd_boolean
+bfd_cache_file_p (bfd *abfd)
+{
+  while (abfd->my_archive != NULL)
+    abfd = abfd->my_archive;
+  return abfd->iovec == &cache_iovec;
+}
+
 /*
 INTERNAL_FUNCTION
 	bfd_last_cache
@@ -276,6 +407,7 @@ close_one (void)
       if (kill->cacheable)
 	{
 	  kill->where = real_ftell ((FILE *) kill->iostream);
+	  cache_stats.evictions++;
 	  return bfd_cache_delete (kill);
 	}
     }
@@ -283,6 +415,82 @@ close_one (void)
   return TRUE;
 }
 
+/* Close files until fewer than MAX_OPEN_FILES () - RESERVE are open,
+   or until there is nothing left we are allowed to close.  Return
+   FALSE if closing a file failed.  */
+
+static bfd_boolean
+make_room (unsigned int reserve)
+{
+  while (open_files + reserve >= max_open_files ())
+    {
+      unsigned int prev_open = open_files;
+
+      if (! close_one ())
+	return FALSE;
+      if (open_files == prev_open)
+	break;
+    }
+
+  return TRUE;
+}
+
+/* Remember what the file just opened for ABFD is, so that we can tell
+   if it has been replaced when we come to reopen it.  This is only
+   done for the first open, while the BFD's memory holds nothing that
+   a failed format check could release.  Files being written change
+   under us, so we do not track those.  */
+
+static void
+record_file_id (bfd *abfd)
+{
+  struct stat buf;
+
+  if (abfd->opened_once
+      || abfd->cache_file_id != NULL
+      || abfd->direction == write_direction
+      || abfd->direction == both_direction
+      || fstat (fileno ((FILE *) abfd->iostream), &buf) != 0)
+    return;
+
+  abfd->cache_file_id = bfd_alloc (abfd, sizeof (struct bfd_cache_file_id));
+  if (abfd->cache_file_id == NULL)
+    return;
+  abfd->cache_file_id->dev = buf.st_dev;
+  abfd->cache_file_id->ino = buf.st_ino;
+  abfd->cache_file_id->size = buf.st_size;
+  abfd->cache_file_id->mtime = buf.st_mtime;
+}
+
+/* ABFD's file has just been reopened.  Warn if it is not the file we
+   opened the first time; the data we have already read from it, and
+   the offsets we are about to read at, no longer describe it.  */
+
+static void
+check_file_id (bfd *abfd)
+{
+  struct bfd_cache_file_id *id = abfd->cache_file_id;
+  struct stat buf;
+
+  if (id == NULL
+      || fstat (fileno ((FILE *) abfd->iostream), &buf) != 0)
+    return;
+
+  if (buf.st_dev != id->dev
+      || buf.st_ino != id->ino
+      || buf.st_size != id->size
+      || buf.st_mtime != id->mtime)
+    {
+      cache_stats.changed_files++;
+      (*_bfd_error_handler) (_("warning: %s has changed since it was "
+			       "first opened"), abfd->filename);
+      id->dev = buf.st_dev;
+      id->ino = buf.st_ino;
+      id->size = buf.st_size;
+      id->mtime = buf.st_mtime;
+    }
+}
+
 /* Close a BFD and remove it from the cache.  */
 
 static bfd_boolean
@@ -326,14 +534,16 @@ bfd_cache_init (bfd *abfd)
   BFD_ASSERT (abfd->iostream != NULL);
   BFD_ASSERT ((abfd->flags & BFD_IN_MEMORY) == 0);
   
-  while (open_files >= bfd_cache_max_open)
-    {
-      if (! close_one ())
-	return FALSE;
-    }
+  if (! make_room (0))
+    return FALSE;
   abfd->iovec = &cache_iovec;
   insert (abfd);
   ++open_files;
+  record_file_id (abfd);
+
+  cache_stats.opens++;
+  if (open_files > cache_stats.peak_open_files)
+    cache_stats.peak_open_files = open_files;
   return TRUE;
 }
 
@@ -411,13 +621,12 @@ DESCRIPTION
 FILE *
 bfd_open_file (bfd *abfd)
 {
+  bfd_boolean reopen = abfd->opened_once;
+
   abfd->cacheable = TRUE;	/* Allow it to be closed later.  */
 
-  while ((open_files + 1) >= bfd_cache_max_open)
-    {
-      if (! close_one ())
-	return NULL;
-    }
+  if (! make_room (1))
+    return NULL;
 
   switch (abfd->direction)
     {
@@ -469,6 +678,16 @@ bfd_open_file (bfd *abfd)
 
   if (abfd->iostream != NULL)
     {
+      /* APPLE LOCAL: Don't let this fd get inherited when we exec a
+	 child proc.  */
+      fcntl (fileno ((FILE *) abfd->iostream), F_SETFD, 1);
+
+      if (reopen)
+	{
+	  cache_stats.reopens++;
+	  check_file_id (abfd);
+	}
+
       if (! bfd_cache_init (abfd))
 	return NULL;
     }
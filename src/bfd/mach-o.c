@@ -39,7 +39,6 @@
 #define bfd_mach_o_get_elt_at_index                   _bfd_noarchive_get_elt_at_index
 #define bfd_mach_o_generic_stat_arch_elt              _bfd_noarchive_generic_stat_arch_elt
 #define bfd_mach_o_update_armap_timestamp             _bfd_noarchive_update_armap_timestamp
-#define bfd_mach_o_close_and_cleanup                  _bfd_generic_close_and_cleanup
 #define bfd_mach_o_new_section_hook                   _bfd_generic_new_section_hook
 #define bfd_mach_o_get_section_contents_in_window     _bfd_generic_get_section_contents_in_window
 #define bfd_mach_o_get_section_contents_in_window_with_mode _bfd_generic_get_section_contents_in_window_with_mode
@@ -1171,17 +1170,18 @@ bfd_mach_o_scan_read_section (bfd *abfd,
     return bfd_mach_o_scan_read_section_32 (abfd, section, offset);
 }
 
-int
-bfd_mach_o_scan_read_symtab_symbol (bfd *abfd,
-				    bfd_mach_o_symtab_command *sym,
-				    asymbol *s,
-				    unsigned long i)
+/* APPLE LOCAL begin mapped symtab */
+/* Fill in S from the raw nlist entry in BUF, which belongs to the
+   symbol table SYM.  */
+
+static int
+bfd_mach_o_decode_symtab_symbol (bfd *abfd,
+				 bfd_mach_o_symtab_command *sym,
+				 asymbol *s,
+				 const unsigned char *buf)
 {
   bfd_mach_o_data_struct *mdata = abfd->tdata.mach_o_data;
   unsigned int wide = (mdata->header.version == 2);
-  unsigned int symwidth = wide ? 16 : 12;
-  bfd_vma symoff = sym->symoff + (i * symwidth);
-  unsigned char buf[16];
   unsigned char type = -1;
   unsigned char section = -1;
   short desc = -1;
@@ -1191,14 +1191,6 @@ bfd_mach_o_scan_read_symtab_symbol (bfd *abfd,
 
   BFD_ASSERT (sym->strtab != NULL);
 
-  bfd_seek (abfd, symoff, SEEK_SET);
-  if (bfd_bread ((PTR) buf, symwidth, abfd) != symwidth)
-    {
-      fprintf (stderr, "bfd_mach_o_scan_read_symtab_symbol: unable to read %d bytes at %lu\n",
-	       symwidth, (unsigned long) symoff);
-      return -1;
-    }
-
   stroff = bfd_h_get_32 (abfd, buf);
   type = bfd_h_get_8 (abfd, buf + 4);
   symtype = (type & 0x0e);
@@ -1289,6 +1281,43 @@ bfd_mach_o_scan_read_symtab_symbol (bfd *abfd,
   return 0;
 }
 
+int
+bfd_mach_o_scan_read_symtab_symbol (bfd *abfd,
+				    bfd_mach_o_symtab_command *sym,
+				    asymbol *s,
+				    unsigned long i)
+{
+  bfd_mach_o_data_struct *mdata = abfd->tdata.mach_o_data;
+  unsigned int symwidth = (mdata->header.version == 2) ? 16 : 12;
+  bfd_vma symoff = sym->symoff + (i * symwidth);
+  unsigned char buf[16];
+
+  /* Once the nlist array is mapped, decode the entry in place rather
+     than seeking and reading twelve or sixteen bytes at a time.  */
+  if (sym->nlists != NULL)
+    {
+      if (i >= sym->nsyms)
+	{
+	  fprintf (stderr, "bfd_mach_o_scan_read_symtab_symbol: symbol index out of range (%lu >= %lu)\n",
+		   i, sym->nsyms);
+	  return -1;
+	}
+      return bfd_mach_o_decode_symtab_symbol (abfd, sym, s,
+					      sym->nlists + (i * symwidth));
+    }
+
+  bfd_seek (abfd, symoff, SEEK_SET);
+  if (bfd_bread ((PTR) buf, symwidth, abfd) != symwidth)
+    {
+      fprintf (stderr, "bfd_mach_o_scan_read_symtab_symbol: unable to read %d bytes at %lu\n",
+	       symwidth, (unsigned long) symoff);
+      return -1;
+    }
+
+  return bfd_mach_o_decode_symtab_symbol (abfd, sym, s, buf);
+}
+/* APPLE LOCAL end mapped symtab */
+
 int
 bfd_mach_o_scan_read_symtab_strtab (bfd *abfd,
 				    bfd_mach_o_symtab_command *sym)
@@ -1310,21 +1339,75 @@ bfd_mach_o_scan_read_symtab_strtab (bfd *abfd,
       return 0;
     }
 
-  sym->strtab = bfd_alloc (abfd, sym->strsize);
-  if (sym->strtab == NULL)
-    return -1;
+  /* APPLE LOCAL begin mapped symtab */
+  /* BFDs read through some other iovec, such as the ones GDB makes
+     for images in the inferior's memory, can't be mapped; read the
+     string table the old way.  */
+  if (! bfd_cache_file_p (abfd))
+    {
+      sym->strtab = bfd_alloc (abfd, sym->strsize);
+      if (sym->strtab == NULL)
+	return -1;
 
-  bfd_seek (abfd, sym->stroff, SEEK_SET);
-  if (bfd_bread ((PTR) sym->strtab, sym->strsize, abfd) != sym->strsize)
+      bfd_seek (abfd, sym->stroff, SEEK_SET);
+      if (bfd_bread ((PTR) sym->strtab, sym->strsize, abfd) != sym->strsize)
+	{
+	  fprintf (stderr, "bfd_mach_o_scan_read_symtab_strtab: unable to read %lu bytes at %lu\n",
+		   sym->strsize, sym->stroff);
+	  return -1;
+	}
+      return 0;
+    }
+
+  /* Map the string table rather than copying it; the symbol names
+     point straight into it.  The window is released when the BFD is
+     closed.  */
+  if (! bfd_get_file_window (abfd, sym->stroff, sym->strsize,
+			     &sym->strtab_window, FALSE))
     {
       fprintf (stderr, "bfd_mach_o_scan_read_symtab_strtab: unable to read %lu bytes at %lu\n",
 	       sym->strsize, sym->stroff);
+      bfd_free_window (&sym->strtab_window);
       return -1;
     }
+  sym->strtab = (char *) sym->strtab_window.data;
+  /* APPLE LOCAL end mapped symtab */
 
   return 0;
 }
 
+/* APPLE LOCAL begin mapped symtab */
+/* Map the nlist array of SYM, so that symbols can be decoded
+   directly from it instead of being read one at a time.  */
+
+int
+bfd_mach_o_scan_read_symtab_nlists (bfd *abfd,
+				    bfd_mach_o_symtab_command *sym)
+{
+  unsigned int symwidth = (bfd_mach_o_version (abfd) > 1) ? 16 : 12;
+
+  if (sym->nlists != NULL)
+    return 0;
+
+  /* Leave SYM->nlists NULL for BFDs that can't be mapped, so that
+     symbols are read one at a time with bfd_seek and bfd_bread.  */
+  if (! (abfd->flags & BFD_IN_MEMORY) && ! bfd_cache_file_p (abfd))
+    return 0;
+
+  if (! bfd_get_file_window (abfd, sym->symoff, sym->nsyms * symwidth,
+			     &sym->nlists_window, FALSE))
+    {
+      fprintf (stderr, "bfd_mach_o_scan_read_symtab_nlists: unable to read %lu bytes at %lu\n",
+	       sym->nsyms * symwidth, sym->symoff);
+      bfd_free_window (&sym->nlists_window);
+      return -1;
+    }
+  sym->nlists = sym->nlists_window.data;
+
+  return 0;
+}
+/* APPLE LOCAL end mapped symtab */
+
 int
 bfd_mach_o_scan_read_symtab_symbols (bfd *abfd,
 				     bfd_mach_o_symtab_command *sym)
@@ -1341,9 +1424,18 @@ bfd_mach_o_scan_read_symtab_symbols (bfd *abfd,
       return -1;
     }
 
-  ret = bfd_mach_o_scan_read_symtab_strtab (abfd, sym);
+  /* APPLE LOCAL begin mapped symtab */
+  if (sym->strtab == NULL)
+    {
+      ret = bfd_mach_o_scan_read_symtab_strtab (abfd, sym);
+      if (ret != 0)
+	return ret;
+    }
+
+  ret = bfd_mach_o_scan_read_symtab_nlists (abfd, sym);
   if (ret != 0)
     return ret;
+  /* APPLE LOCAL end mapped symtab */
 
   for (i = 0; i < sym->nsyms; i++)
     {
@@ -1916,6 +2008,11 @@ bfd_mach_o_scan_read_symtab (bfd *abfd, bfd_mach_o_load_command *command)
   seg->strsize = bfd_h_get_32 (abfd, buf + 12);
   seg->symbols = NULL;
   seg->strtab = NULL;
+  /* APPLE LOCAL begin mapped symtab */
+  seg->nlists = NULL;
+  bfd_init_window (&seg->nlists_window);
+  bfd_init_window (&seg->strtab_window);
+  /* APPLE LOCAL end mapped symtab */
 
   sname = (char *) bfd_alloc (abfd, strlen (prefix) + 1);
   if (sname == NULL)
@@ -2974,6 +3071,37 @@ bfd_mach_o_encrypted_binary (bfd *abfd)
     return TRUE;
 }
 
+/* APPLE LOCAL begin mapped symtab */
+/* Release the windows holding the mapped symbol and string tables.  */
+
+static bfd_boolean
+bfd_mach_o_close_and_cleanup (bfd *abfd)
+{
+  if ((bfd_get_format (abfd) == bfd_object
+       || bfd_get_format (abfd) == bfd_core)
+      && bfd_mach_o_valid (abfd))
+    {
+      bfd_mach_o_data_struct *mdata = abfd->tdata.mach_o_data;
+      unsigned long i;
+
+      for (i = 0; i < mdata->header.ncmds; i++)
+	if (mdata->commands[i].type == BFD_MACH_O_LC_SYMTAB)
+	  {
+	    bfd_mach_o_symtab_command *sym
+	      = &mdata->commands[i].command.symtab;
+
+	    if (sym->strtab == (char *) sym->strtab_window.data)
+	      sym->strtab = NULL;
+	    bfd_free_window (&sym->strtab_window);
+	    bfd_free_window (&sym->nlists_window);
+	    sym->nlists = NULL;
+	  }
+    }
+
+  return _bfd_generic_close_and_cleanup (abfd);
+}
+/* APPLE LOCAL end mapped symtab */
+
 /* Add free_cached_info functions so we can actually close the
    bfd's that we opened when looking through archives.  Since we
    leave the debug info in the .a files, gdb ends up accessing .a
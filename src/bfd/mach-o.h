@@ -286,6 +286,13 @@ typedef struct bfd_mach_o_symtab_command
   char *strtab;
   asection *stabs_segment;
   asection *stabstr_segment;
+  /* APPLE LOCAL begin mapped symtab */
+  /* The raw nlist array, mapped straight from the file; NULL until
+     bfd_mach_o_scan_read_symtab_nlists is called.  */
+  unsigned char *nlists;
+  bfd_window nlists_window;
+  bfd_window strtab_window;
+  /* APPLE LOCAL end mapped symtab */
 }
 bfd_mach_o_symtab_command;
 
@@ -536,6 +543,8 @@ bfd_boolean        bfd_mach_o_valid  (bfd *);
 int                bfd_mach_o_scan_read_symtab_symbol        (bfd *, bfd_mach_o_symtab_command *, asymbol *, unsigned long);
 int                bfd_mach_o_scan_read_symtab_strtab        (bfd *, bfd_mach_o_symtab_command *);
 int                bfd_mach_o_scan_read_symtab_symbols       (bfd *, bfd_mach_o_symtab_command *);
+/* APPLE LOCAL mapped symtab */
+int                bfd_mach_o_scan_read_symtab_nlists        (bfd *, bfd_mach_o_symtab_command *);
 int                bfd_mach_o_scan_read_dysymtab_symbol      (bfd *, bfd_mach_o_dysymtab_command *, bfd_mach_o_symtab_command *, asymbol *, unsigned long);
 int                bfd_mach_o_scan_start_address             (bfd *);
 int                bfd_mach_o_scan                           (bfd *, bfd_mach_o_header *, bfd_mach_o_data_struct *);
@@ -368,6 +368,55 @@ child_post_startup_inferior (ptid_t ptid)
 }
 
 
+/* APPLE LOCAL begin page watchpoints */
+/* Have the stopped LWP LWPID call mprotect (ADDR, LEN, PROT) with a
+   system call instruction placed at SCRATCH; `syscall' for 64-bit
+   code, `int $0x80' for 32-bit code.  */
+
+/* The code segment selector of 32-bit user code.  */
+#define AMD64_LINUX_USER32_CS 0x23
+
+static int
+amd64_linux_inferior_mprotect (int lwpid, CORE_ADDR scratch,
+			       CORE_ADDR addr, ULONGEST len, int prot)
+{
+  static const gdb_byte syscall_insn[] = { 0x0f, 0x05 };
+  static const gdb_byte int80[] = { 0xcd, 0x80 };
+  elf_gregset_t regs;
+  const gdb_byte *insn;
+
+  if (ptrace (PTRACE_GETREGS, lwpid, 0, (long) &regs) < 0)
+    return -1;
+
+  if (regs[CS] == AMD64_LINUX_USER32_CS)
+    {
+      /* The i386 system call number; see <asm-i386/unistd.h>.  */
+      regs[RAX] = 125;
+      regs[RBX] = addr;
+      regs[RCX] = len;
+      regs[RDX] = prot;
+      insn = int80;
+    }
+  else
+    {
+      regs[RAX] = SYS_mprotect;
+      regs[RDI] = addr;
+      regs[RSI] = len;
+      regs[RDX] = prot;
+      insn = syscall_insn;
+    }
+  regs[RIP] = scratch;
+  /* Don't let the kernel restart a system call LWPID was in.  */
+  regs[ORIG_RAX] = -1;
+
+  if (linux_nat_execute_insn (lwpid, scratch, insn, 2, &regs) != 0)
+    return -1;
+
+  return (int) regs[RAX];
+}
+/* APPLE LOCAL end page watchpoints */
+
+
 /* Provide a prototype to silence -Wmissing-prototypes.  */
 void _initialize_amd64_linux_nat (void);
 
@@ -377,6 +426,8 @@ _initialize_amd64_linux_nat (void)
   amd64_native_gregset32_reg_offset = amd64_linux_gregset32_reg_offset;
   amd64_native_gregset32_num_regs = I386_LINUX_NUM_REGS;
   amd64_native_gregset64_reg_offset = amd64_linux_gregset64_reg_offset;
+  /* APPLE LOCAL page watchpoints */
+  linux_nat_inferior_mprotect = amd64_linux_inferior_mprotect;
 
   gdb_assert (ARRAY_SIZE (amd64_linux_gregset32_reg_offset)
 	      == amd64_native_gregset32_num_regs);
@@ -37,6 +37,8 @@
 #include "complaints.h"
 
 #include "gdb_assert.h"
+/* APPLE LOCAL displaced stepping */
+#include "dis-asm.h"
 
 #include "amd64-tdep.h"
 #include "i387-tdep.h"
@@ -1052,6 +1054,307 @@ amd64_regset_from_core_section (struct gdbarch *gdbarch,
 }
 
 
+/* APPLE LOCAL begin displaced stepping */
+/* Displaced stepping.  This follows the i386 scheme in i386-tdep.c,
+   with one addition: an instruction that addresses memory relative to
+   %rip would see the wrong %rip at the copy, so it is rewritten to
+   address relative to a spare general register that holds the
+   original %rip for the duration of the step.  */
+
+/* Does a one-byte opcode, or a two-byte 0x0f opcode, take a ModRM
+   byte?  Indexed by the (last) opcode byte.  */
+
+static const unsigned char onebyte_has_modrm[256] = {
+  /*       0 1 2 3 4 5 6 7 8 9 a b c d e f  */
+  /* 0 */  1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,0,
+  /* 1 */  1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,0,
+  /* 2 */  1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,0,
+  /* 3 */  1,1,1,1,0,0,0,0,1,1,1,1,0,0,0,0,
+  /* 4 */  0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+  /* 5 */  0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+  /* 6 */  0,0,1,1,0,0,0,0,0,1,0,1,0,0,0,0,
+  /* 7 */  0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+  /* 8 */  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  /* 9 */  0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+  /* a */  0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+  /* b */  0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+  /* c */  1,1,0,0,1,1,1,1,0,0,0,0,0,0,0,0,
+  /* d */  1,1,1,1,0,0,0,0,1,1,1,1,1,1,1,1,
+  /* e */  0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+  /* f */  0,0,0,0,0,0,1,1,0,0,0,0,0,0,1,1
+};
+
+static const unsigned char twobyte_has_modrm[256] = {
+  /*       0 1 2 3 4 5 6 7 8 9 a b c d e f  */
+  /* 0 */  1,1,1,1,0,0,0,0,0,0,0,0,0,1,0,1,
+  /* 1 */  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  /* 2 */  1,1,1,1,0,0,0,0,1,1,1,1,1,1,1,1,
+  /* 3 */  0,0,0,0,0,0,0,0,1,0,1,0,0,0,0,0,
+  /* 4 */  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  /* 5 */  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  /* 6 */  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  /* 7 */  1,1,1,1,1,1,1,0,1,1,1,1,1,1,1,1,
+  /* 8 */  0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+  /* 9 */  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  /* a */  0,0,0,1,1,1,0,0,0,0,0,1,1,1,1,1,
+  /* b */  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  /* c */  1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,
+  /* d */  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  /* e */  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  /* f */  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1
+};
+
+#define REX_PREFIX_P(b)	(((b) & 0xf0) == 0x40)
+#define REX_B		0x01
+
+/* GDB register numbers of the general registers, in the order the
+   hardware encodes them in ModRM and SIB bytes.  */
+
+static const int amd64_arch_regmap[8] =
+{
+  AMD64_RAX_REGNUM, AMD64_RCX_REGNUM, AMD64_RDX_REGNUM, AMD64_RBX_REGNUM,
+  AMD64_RSP_REGNUM, AMD64_RBP_REGNUM, AMD64_RSI_REGNUM, AMD64_RDI_REGNUM
+};
+
+/* Where the parts of an instruction are, as offsets into its bytes;
+   -1 for an absent REX prefix or ModRM byte.  */
+
+struct amd64_insn
+{
+  int opcode_len;
+  int rex_offset;
+  int opcode_offset;
+  int modrm_offset;
+};
+
+struct displaced_step_closure
+{
+  /* The register standing in for %rip, and its value before the
+     step; TMP_USED is zero if the instruction wasn't %rip-relative.  */
+  int tmp_used;
+  int tmp_regno;
+  ULONGEST tmp_save;
+
+  struct amd64_insn details;
+
+  /* The (possibly rewritten) instruction that was copied.  */
+  gdb_byte insn_buf[1];
+};
+
+static void
+amd64_get_insn_details (const gdb_byte *insn, size_t max_len,
+			struct amd64_insn *details)
+{
+  const gdb_byte *start = insn;
+  const gdb_byte *end = insn + max_len;
+  int need_modrm;
+
+  details->rex_offset = -1;
+  details->modrm_offset = -1;
+
+  /* Legacy prefixes.  */
+  while (insn < end)
+    {
+      switch (*insn)
+	{
+	case 0x26: case 0x2e: case 0x36: case 0x3e:
+	case 0x64: case 0x65: case 0x66: case 0x67:
+	case 0xf0: case 0xf2: case 0xf3:
+	  insn++;
+	  continue;
+	}
+      break;
+    }
+
+  if (insn < end && REX_PREFIX_P (*insn))
+    {
+      details->rex_offset = insn - start;
+      insn++;
+    }
+
+  details->opcode_offset = insn - start;
+
+  if (insn + 1 < end && insn[0] == 0x0f)
+    {
+      if (insn[1] == 0x38 || insn[1] == 0x3a)
+	{
+	  /* Three-byte opcodes all take a ModRM byte.  */
+	  details->opcode_len = 3;
+	  need_modrm = 1;
+	}
+      else
+	{
+	  details->opcode_len = 2;
+	  need_modrm = twobyte_has_modrm[insn[1]];
+	}
+    }
+  else
+    {
+      details->opcode_len = 1;
+      need_modrm = onebyte_has_modrm[insn[0]];
+    }
+
+  if (need_modrm)
+    details->modrm_offset = details->opcode_offset + details->opcode_len;
+}
+
+/* Return the hardware number of a general register, other than %rax,
+   %rdx and %rsp, that the instruction described by DETAILS doesn't
+   use.  %rax and %rdx are implicit operands of too many instructions
+   to be worth tracking.  */
+
+static int
+amd64_get_unused_input_int_reg (const gdb_byte *insn,
+				const struct amd64_insn *details)
+{
+  int used_regs_mask = (1 << 0) | (1 << 2) | (1 << 4);
+  int i;
+
+  /* A one-byte opcode without a ModRM byte may encode a register in
+     its low bits.  */
+  if (details->opcode_len == 1 && details->modrm_offset == -1)
+    used_regs_mask |= 1 << (insn[details->opcode_offset] & 7);
+
+  if (details->modrm_offset != -1)
+    {
+      int modrm = insn[details->modrm_offset];
+      int mod = (modrm >> 6) & 3;
+      int reg = (modrm >> 3) & 7;
+      int rm = modrm & 7;
+
+      used_regs_mask |= 1 << reg;
+      if (mod != 3 && rm == 4)
+	{
+	  int sib = insn[details->modrm_offset + 1];
+
+	  used_regs_mask |= 1 << (sib & 7);
+	  used_regs_mask |= 1 << ((sib >> 3) & 7);
+	}
+      else
+	used_regs_mask |= 1 << rm;
+    }
+
+  for (i = 0; i < 8; i++)
+    if (! (used_regs_mask & (1 << i)))
+      return i;
+
+  internal_error (__FILE__, __LINE__, _("unable to find free reg"));
+}
+
+/* APPLE LOCAL begin non-stop */
+static int ATTR_FORMAT (printf, 2, 3)
+amd64_insn_length_fprintf (void *stream, const char *format, ...)
+{
+  return 0;
+}
+
+/* Return the length of the instruction in INSN, the LEN bytes copied
+   from ADDR, by disassembling it.  The bytes are decoded from INSN
+   rather than read back from the target, where a breakpoint may be
+   inserted over the instruction.  */
+
+static int
+amd64_insn_length (struct gdbarch *gdbarch,
+		   gdb_byte *insn, int len, CORE_ADDR addr)
+{
+  struct disassemble_info di;
+
+  init_disassemble_info (&di, NULL, amd64_insn_length_fprintf);
+  di.buffer = insn;
+  di.buffer_length = len;
+  di.buffer_vma = addr;
+  di.arch = gdbarch_bfd_arch_info (gdbarch)->arch;
+  di.mach = gdbarch_bfd_arch_info (gdbarch)->mach;
+  di.endian = gdbarch_byte_order (gdbarch);
+  disassemble_init_for_target (&di);
+
+  return gdbarch_print_insn (gdbarch, addr, &di);
+}
+/* APPLE LOCAL end non-stop */
+
+/* If the copied instruction addresses memory relative to %rip,
+   rewrite it to use a spare register holding the %rip it would have
+   seen at FROM.  */
+
+static void
+amd64_displaced_step_fixup_riprel (struct gdbarch *gdbarch,
+				   struct displaced_step_closure *dsc,
+				   int len, CORE_ADDR from,
+				   struct regcache *regs)
+{
+  const struct amd64_insn *details = &dsc->details;
+  int modrm_offset = details->modrm_offset;
+  int arch_tmp_regno;
+  CORE_ADDR rip_base;
+
+  if (modrm_offset == -1 || (dsc->insn_buf[modrm_offset] & 0xc7) != 0x05)
+    return;
+
+  rip_base = from + amd64_insn_length (gdbarch, dsc->insn_buf, len, from);
+  arch_tmp_regno = amd64_get_unused_input_int_reg (dsc->insn_buf, details);
+
+  /* The spare register is one of the first eight, so REX.B must be
+     clear; it should be already, with %rip-relative addressing.  */
+  if (details->rex_offset != -1)
+    dsc->insn_buf[details->rex_offset] &= ~REX_B;
+
+  dsc->tmp_used = 1;
+  dsc->tmp_regno = amd64_arch_regmap[arch_tmp_regno];
+  regcache_cooked_read_unsigned (regs, dsc->tmp_regno, &dsc->tmp_save);
+
+  /* Turn disp32(%rip) into disp32(%tmp); the length is unchanged.  */
+  dsc->insn_buf[modrm_offset] &= ~0xc7;
+  dsc->insn_buf[modrm_offset] |= 0x80 | arch_tmp_regno;
+
+  regcache_cooked_write_unsigned (regs, dsc->tmp_regno, rip_base);
+}
+
+struct displaced_step_closure *
+amd64_displaced_step_copy_insn (struct gdbarch *gdbarch,
+				CORE_ADDR from, CORE_ADDR to,
+				struct regcache *regs)
+{
+  int len = gdbarch_max_insn_length (gdbarch);
+  /* Leave a zeroed byte past the instruction, in case a truncated
+     ModRM byte sends the decoder looking for a SIB byte.  */
+  struct displaced_step_closure *dsc
+    = xcalloc (1, sizeof (*dsc) + len + 1);
+  int status;
+
+  /* APPLE LOCAL non-stop: Read what is underneath any breakpoint
+     inserted at FROM; in non-stop mode they stay in.  */
+  status = deprecated_read_memory_nobpt (from, dsc->insn_buf, len);
+  if (status != 0)
+    {
+      xfree (dsc);
+      memory_error (status, from);
+    }
+
+  amd64_get_insn_details (dsc->insn_buf, len, &dsc->details);
+  amd64_displaced_step_fixup_riprel (gdbarch, dsc, len, from, regs);
+
+  write_memory (to, dsc->insn_buf, len);
+
+  return dsc;
+}
+
+void
+amd64_displaced_step_fixup (struct gdbarch *gdbarch,
+			    struct displaced_step_closure *dsc,
+			    CORE_ADDR from, CORE_ADDR to,
+			    struct regcache *regs)
+{
+  if (dsc->tmp_used)
+    regcache_cooked_write_unsigned (regs, dsc->tmp_regno, dsc->tmp_save);
+
+  i386_displaced_step_relocate (regs, dsc->insn_buf,
+				dsc->insn_buf + dsc->details.opcode_offset,
+				from, to,
+				AMD64_RIP_REGNUM, AMD64_RSP_REGNUM, 8);
+}
+/* APPLE LOCAL end displaced stepping */
+
+
 void
 amd64_init_abi (struct gdbarch_info info, struct gdbarch *gdbarch)
 {
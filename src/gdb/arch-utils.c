@@ -32,6 +32,8 @@
 #include "sim-regno.h"
 #include "gdbcore.h"
 #include "osabi.h"
+/* APPLE LOCAL displaced stepping */
+#include "objfiles.h"
 
 #include "version.h"
 
@@ -228,6 +230,26 @@ default_adjust_ehframe_regnum (struct gdbarch *gdbarch, int regnum, int eh_frame
   return regnum;
 }
 
+/* APPLE LOCAL begin displaced stepping */
+/* The default place to put displaced instructions: just past the
+   program's entry point, which is not executed again once the
+   program has started.  Inferior function calls may also plant a
+   breakpoint at the entry point, so leave room for that.  */
+
+CORE_ADDR
+displaced_step_at_entry_point (struct gdbarch *gdbarch)
+{
+  CORE_ADDR addr;
+  int bp_len;
+
+  addr = entry_point_address ();
+  gdbarch_breakpoint_from_pc (gdbarch, &addr, &bp_len);
+  addr += bp_len * 2;
+
+  return addr;
+}
+/* APPLE LOCAL end displaced stepping */
+
 void
 default_elf_make_msymbol_special (asymbol *sym, struct minimal_symbol *msym)
 {
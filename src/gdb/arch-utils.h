@@ -74,6 +74,13 @@ extern int no_op_reg_to_regnum (int reg);
 
 int default_adjust_ehframe_regnum (struct gdbarch *gdbarch, int regnum, int eh_frame_p);
 
+/* APPLE LOCAL begin displaced stepping */
+/* Use the program's entry point as the displaced stepping scratch
+   area.  */
+
+extern CORE_ADDR displaced_step_at_entry_point (struct gdbarch *gdbarch);
+/* APPLE LOCAL end displaced stepping */
+
 /* Do nothing version of elf_make_msymbol_special. */
 
 void default_elf_make_msymbol_special (asymbol *sym, struct minimal_symbol *msym);
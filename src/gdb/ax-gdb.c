@@ -35,6 +35,10 @@
 #include "gdb_string.h"
 #include "block.h"
 #include "regcache.h"
+/* APPLE LOCAL begin compiled breakpoint conditions */
+#include "gdbcore.h"
+#include "dwarf2loc.h"
+/* APPLE LOCAL end compiled breakpoint conditions */
 
 /* To make sense of this file, you should read doc/agentexpr.texi.
    Then look at the types and enums in ax-gdb.h.  For the code itself,
@@ -116,6 +120,15 @@ static void gen_binop (struct agent_expr *ax,
 		       enum agent_op op,
 		       enum agent_op op_unsigned, int may_carry, char *name);
 static void gen_logical_not (struct agent_expr *ax, struct axs_value *value);
+/* APPLE LOCAL begin compiled breakpoint conditions */
+static void gen_compare (struct agent_expr *ax, struct axs_value *value,
+			 struct axs_value *value1, struct axs_value *value2,
+			 enum exp_opcode op);
+static void gen_logical_and_or (union exp_element **pc,
+				struct agent_expr *ax,
+				struct axs_value *value,
+				enum exp_opcode op);
+/* APPLE LOCAL end compiled breakpoint conditions */
 static void gen_complement (struct agent_expr *ax, struct axs_value *value);
 static void gen_deref (struct agent_expr *, struct axs_value *);
 static void gen_address_of (struct agent_expr *, struct axs_value *);
@@ -391,6 +404,8 @@ gen_fetch (struct agent_expr *ax, struct type *type)
     case TYPE_CODE_ENUM:
     case TYPE_CODE_INT:
     case TYPE_CODE_CHAR:
+    /* APPLE LOCAL compiled breakpoint conditions */
+    case TYPE_CODE_BOOL:
       /* It's a scalar value, so we know how to dereference it.  How
          many bytes long is it?  */
       switch (TYPE_LENGTH (type))
@@ -420,6 +435,11 @@ gen_fetch (struct agent_expr *ax, struct type *type)
       gen_sign_extend (ax, type);
       break;
 
+    /* APPLE LOCAL begin compiled breakpoint conditions */
+    case TYPE_CODE_FLT:
+      error (_("GDB agent expressions cannot use floating-point values."));
+    /* APPLE LOCAL end compiled breakpoint conditions */
+
     default:
       /* Either our caller shouldn't have asked us to dereference that
          pointer (other code's fault), or we're not implementing
@@ -461,6 +481,15 @@ gen_frame_args_address (struct agent_expr *ax)
   int frame_reg;
   LONGEST frame_offset;
 
+  /* APPLE LOCAL begin compiled breakpoint conditions */
+  /* GDB knows the real frame, and needn't guess at it.  */
+  if (ax->host)
+    {
+      ax_simple (ax, aop_frame_args_address);
+      return;
+    }
+  /* APPLE LOCAL end compiled breakpoint conditions */
+
   TARGET_VIRTUAL_FRAME_POINTER (ax->scope, &frame_reg, &frame_offset);
   ax_reg (ax, frame_reg);
   gen_offset (ax, frame_offset);
@@ -475,6 +504,15 @@ gen_frame_locals_address (struct agent_expr *ax)
   int frame_reg;
   LONGEST frame_offset;
 
+  /* APPLE LOCAL begin compiled breakpoint conditions */
+  /* GDB knows the real frame, and needn't guess at it.  */
+  if (ax->host)
+    {
+      ax_simple (ax, aop_frame_locals_address);
+      return;
+    }
+  /* APPLE LOCAL end compiled breakpoint conditions */
+
   TARGET_VIRTUAL_FRAME_POINTER (ax->scope, &frame_reg, &frame_offset);
   ax_reg (ax, frame_reg);
   gen_offset (ax, frame_offset);
@@ -538,8 +576,8 @@ gen_var_ref (struct agent_expr *ax, struct axs_value *value, struct symbol *var)
       break;
 
     case LOC_CONST_BYTES:
-      internal_error (__FILE__, __LINE__,
-		      _("gen_var_ref: LOC_CONST_BYTES symbols are not supported"));
+      /* APPLE LOCAL compiled breakpoint conditions: Not a GDB bug.  */
+      error (_("GDB agent expressions cannot use LOC_CONST_BYTES symbols."));
 
       /* Variable at a fixed location in memory.  Easy.  */
     case LOC_STATIC:
@@ -682,6 +720,12 @@ require_rvalue (struct agent_expr *ax, struct axs_value *value)
 
          When we add floating-point support, this is going to have to
          change.  What about SPARC register pairs, for example?  */
+      /* APPLE LOCAL begin compiled breakpoint conditions */
+      if (TYPE_CODE (value->type) == TYPE_CODE_FLT
+	  || TYPE_LENGTH (value->type) > sizeof (LONGEST))
+	error (_("GDB agent expressions cannot use the value of register %d."),
+	       value->u.reg);
+      /* APPLE LOCAL end compiled breakpoint conditions */
       ax_reg (ax, value->u.reg);
       gen_extend (ax, value->type);
       break;
@@ -1086,6 +1130,121 @@ gen_logical_not (struct agent_expr *ax, struct axs_value *value)
 }
 
 
+/* APPLE LOCAL begin compiled breakpoint conditions */
+/* Generate code for the comparison OP of the two operands described
+   by VALUE1 and VALUE2, which have undergone the usual binary
+   conversions.  Set VALUE to describe the int result.  */
+static void
+gen_compare (struct agent_expr *ax, struct axs_value *value,
+	     struct axs_value *value1, struct axs_value *value2,
+	     enum exp_opcode op)
+{
+  enum agent_op less;
+
+  if ((TYPE_CODE (value1->type) != TYPE_CODE_INT
+       && TYPE_CODE (value1->type) != TYPE_CODE_PTR
+       && TYPE_CODE (value1->type) != TYPE_CODE_BOOL)
+      || (TYPE_CODE (value2->type) != TYPE_CODE_INT
+	  && TYPE_CODE (value2->type) != TYPE_CODE_PTR
+	  && TYPE_CODE (value2->type) != TYPE_CODE_BOOL))
+    error (_("Invalid combination of types in comparison."));
+
+  /* Integers have been promoted to a common type; pointers are
+     compared as addresses.  */
+  if (TYPE_CODE (value1->type) == TYPE_CODE_PTR
+      || TYPE_CODE (value2->type) == TYPE_CODE_PTR
+      || TYPE_UNSIGNED (value1->type))
+    less = aop_less_unsigned;
+  else
+    less = aop_less_signed;
+
+  switch (op)
+    {
+    case BINOP_EQUAL:
+      ax_simple (ax, aop_equal);
+      break;
+    case BINOP_NOTEQUAL:
+      ax_simple (ax, aop_equal);
+      ax_simple (ax, aop_log_not);
+      break;
+    case BINOP_LESS:
+      ax_simple (ax, less);
+      break;
+    case BINOP_GTR:
+      ax_simple (ax, aop_swap);
+      ax_simple (ax, less);
+      break;
+    case BINOP_LEQ:
+      ax_simple (ax, aop_swap);
+      ax_simple (ax, less);
+      ax_simple (ax, aop_log_not);
+      break;
+    case BINOP_GEQ:
+      ax_simple (ax, less);
+      ax_simple (ax, aop_log_not);
+      break;
+    default:
+      internal_error (__FILE__, __LINE__,
+		      _("gen_compare: not a comparison"));
+    }
+
+  value->type = builtin_type_int;
+  value->kind = axs_rvalue;
+}
+
+/* Generate code for the short-circuiting operator OP, which is
+   BINOP_LOGICAL_AND or BINOP_LOGICAL_OR, whose operands are at *PC.
+   Set VALUE to describe the int result.  */
+static void
+gen_logical_and_or (union exp_element **pc, struct agent_expr *ax,
+		    struct axs_value *value, enum exp_opcode op)
+{
+  struct axs_value value1, value2;
+  int if_nonzero, to_end;
+
+  gen_expr (pc, ax, &value1);
+  gen_usual_unary (ax, &value1);
+  if (TYPE_CODE (value1.type) != TYPE_CODE_INT
+      && TYPE_CODE (value1.type) != TYPE_CODE_PTR
+      && TYPE_CODE (value1.type) != TYPE_CODE_BOOL)
+    error (_("Invalid type of operand to `%s'."),
+	   op == BINOP_LOGICAL_AND ? "&&" : "||");
+  if_nonzero = ax_goto (ax, aop_if_goto);
+
+  if (op == BINOP_LOGICAL_AND)
+    {
+      /* The left operand was zero, and so is the result.  */
+      ax_const_l (ax, 0);
+      to_end = ax_goto (ax, aop_goto);
+      ax_label (ax, if_nonzero, ax->len);
+    }
+
+  gen_expr (pc, ax, &value2);
+  gen_usual_unary (ax, &value2);
+  if (TYPE_CODE (value2.type) != TYPE_CODE_INT
+      && TYPE_CODE (value2.type) != TYPE_CODE_PTR
+      && TYPE_CODE (value2.type) != TYPE_CODE_BOOL)
+    error (_("Invalid type of operand to `%s'."),
+	   op == BINOP_LOGICAL_AND ? "&&" : "||");
+  /* Reduce the right operand to 0 or 1.  */
+  ax_simple (ax, aop_log_not);
+  ax_simple (ax, aop_log_not);
+
+  if (op == BINOP_LOGICAL_OR)
+    {
+      to_end = ax_goto (ax, aop_goto);
+      /* The left operand was non-zero, and so is the result.  */
+      ax_label (ax, if_nonzero, ax->len);
+      ax_const_l (ax, 1);
+    }
+
+  ax_label (ax, to_end, ax->len);
+  value->type = builtin_type_int;
+  value->kind = axs_rvalue;
+}
+/* APPLE LOCAL end compiled breakpoint conditions */
+
+
 static void
 gen_complement (struct agent_expr *ax, struct axs_value *value)
 {
@@ -1163,22 +1322,33 @@ find_field (struct type *type, char *name)
 
   CHECK_TYPEDEF (type);
 
-  /* Make sure this isn't C++.  */
+  /* APPLE LOCAL begin struct field index */
+  /* Make sure this isn't C++.  Breakpoint conditions are compiled
+     through here too, so these have to be ordinary errors that the
+     caller can fall back from.  */
   if (TYPE_N_BASECLASSES (type) != 0)
-    internal_error (__FILE__, __LINE__,
-		    _("find_field: derived classes supported"));
+    error (_("find_field: derived classes not supported"));
 
-  for (i = 0; i < TYPE_NFIELDS (type); i++)
+  if (lookup_struct_field_index (type, name, 0, &i))
+    {
+      if (i >= 0)
+	return i;
+      i = TYPE_NFIELDS (type);
+    }
+  else
+    i = 0;
+
+  for (; i < TYPE_NFIELDS (type); i++)
     {
       char *this_name = TYPE_FIELD_NAME (type, i);
 
       if (this_name && strcmp (name, this_name) == 0)
 	return i;
 
-      if (this_name[0] == '\0')
-	internal_error (__FILE__, __LINE__,
-			_("find_field: anonymous unions not supported"));
+      if (this_name == NULL || this_name[0] == '\0')
+	error (_("find_field: anonymous unions not supported"));
     }
+  /* APPLE LOCAL end struct field index */
 
   error (_("Couldn't find member named `%s' in struct/union `%s'"),
 	 name, TYPE_TAG_NAME (type));
@@ -1566,6 +1736,29 @@ gen_expr (union exp_element **pc, struct agent_expr *ax,
 	}
       break;
 
+      /* APPLE LOCAL begin compiled breakpoint conditions */
+    case BINOP_EQUAL:
+    case BINOP_NOTEQUAL:
+    case BINOP_LESS:
+    case BINOP_GTR:
+    case BINOP_LEQ:
+    case BINOP_GEQ:
+      (*pc)++;
+      gen_expr (pc, ax, &value1);
+      gen_usual_unary (ax, &value1);
+      gen_expr (pc, ax, &value2);
+      gen_usual_unary (ax, &value2);
+      gen_usual_arithmetic (ax, &value1, &value2);
+      gen_compare (ax, value, &value1, &value2, op);
+      break;
+
+    case BINOP_LOGICAL_AND:
+    case BINOP_LOGICAL_OR:
+      (*pc)++;
+      gen_logical_and_or (pc, ax, value, op);
+      break;
+      /* APPLE LOCAL end compiled breakpoint conditions */
+
       /* Note that we need to be a little subtle about generating code
          for comma.  In C, we can do some optimizations here because
          we know the left operand is only being evaluated for effect.
@@ -1635,10 +1828,11 @@ gen_expr (union exp_element **pc, struct agent_expr *ax,
 	   it's just a hack for dealing with minsyms; you take some
 	   integer constant, pretend it's the address of an lvalue of
 	   the given type, and dereference it.  */
-	if (value->kind != axs_rvalue)
-	  /* This would be weird.  */
-	  internal_error (__FILE__, __LINE__,
-			  _("gen_expr: OP_MEMVAL operand isn't an rvalue???"));
+	/* APPLE LOCAL begin compiled breakpoint conditions */
+	/* The operand is an address, as in "{int} ptr"; the operand
+	   needn't be a constant.  */
+	require_rvalue (ax, value);
+	/* APPLE LOCAL end compiled breakpoint conditions */
 	value->type = type;
 	value->kind = axs_lvalue_memory;
       }
@@ -1812,6 +2006,267 @@ gen_trace_for_expr (CORE_ADDR scope, struct expression *expr)
   return ax;
 }
 
+/* APPLE LOCAL begin compiled breakpoint conditions */
+/* The most values ax_eval's stack can hold.  gen_eval_for_expr
+   refuses expressions that need more.  */
+#define AX_EVAL_STACK_SIZE 32
+
+/* Given a GDB expression EXPR, return bytecode for GDB to compute its
+   value with ax_eval, in a frame whose pc is SCOPE.  Signal an error
+   if EXPR uses anything the bytecode can't express, or if its value
+   isn't an integer or a pointer.  The addresses of static variables
+   and minimal symbols are built into the bytecode, so callers must
+   throw it away when the symbols change.  */
+struct agent_expr *
+gen_eval_for_expr (CORE_ADDR scope, struct expression *expr)
+{
+  struct cleanup *old_chain = 0;
+  struct agent_expr *ax = new_agent_expr (scope);
+  union exp_element *pc;
+  struct axs_value value;
+  struct agent_reqs reqs;
+
+  old_chain = make_cleanup_free_agent_expr (ax);
+  ax->host = 1;
+
+  pc = expr->elts;
+  trace_kludge = 0;
+  gen_expr (&pc, ax, &value);
+  if (pc != expr->elts + expr->nelts)
+    error (_("Unsupported operator in expression."));
+
+  gen_usual_unary (ax, &value);
+  if (TYPE_CODE (value.type) != TYPE_CODE_INT
+      && TYPE_CODE (value.type) != TYPE_CODE_PTR
+      && TYPE_CODE (value.type) != TYPE_CODE_BOOL)
+    error (_("Expression does not have a scalar value."));
+  ax_simple (ax, aop_end);
+
+  ax_reqs (ax, &reqs);
+  xfree (reqs.reg_mask);
+  if (reqs.flaw != agent_flaw_none
+      || reqs.min_height < 0
+      || reqs.max_height > AX_EVAL_STACK_SIZE
+      || reqs.final_height != 1)
+    error (_("Expression is too complex to compile."));
+
+  discard_cleanups (old_chain);
+  return ax;
+}
+
+/* Run the bytecode AX, made by gen_eval_for_expr, in FRAME and return
+   the value it leaves on the stack.  This allocates nothing, so it
+   is cheap enough to run every time a breakpoint is hit.  */
+LONGEST
+ax_eval (struct agent_expr *ax, struct frame_info *frame)
+{
+  LONGEST stack[AX_EVAL_STACK_SIZE];
+  LONGEST a, b;
+  int sp = 0;
+  int i = 0;
+  int n;
+
+  /* gen_eval_for_expr checked the stack heights and jump targets, so
+     we need not check them again here.  */
+  for (;;)
+    {
+      enum agent_op op = ax->buf[i++];
+
+      switch (op)
+	{
+	case aop_add:
+	  b = stack[--sp];
+	  stack[sp - 1] = (ULONGEST) stack[sp - 1] + (ULONGEST) b;
+	  break;
+
+	case aop_sub:
+	  b = stack[--sp];
+	  stack[sp - 1] = (ULONGEST) stack[sp - 1] - (ULONGEST) b;
+	  break;
+
+	case aop_mul:
+	  b = stack[--sp];
+	  stack[sp - 1] = (ULONGEST) stack[sp - 1] * (ULONGEST) b;
+	  break;
+
+	case aop_div_signed:
+	case aop_rem_signed:
+	  b = stack[--sp];
+	  a = stack[sp - 1];
+	  if (b == 0)
+	    error (_("Division by zero"));
+	  /* Don't trap on the most negative number divided by -1.  */
+	  if (b == -1)
+	    stack[sp - 1] = op == aop_div_signed ? - (ULONGEST) a : 0;
+	  else
+	    stack[sp - 1] = op == aop_div_signed ? a / b : a % b;
+	  break;
+
+	case aop_div_unsigned:
+	case aop_rem_unsigned:
+	  b = stack[--sp];
+	  a = stack[sp - 1];
+	  if (b == 0)
+	    error (_("Division by zero"));
+	  stack[sp - 1] = (op == aop_div_unsigned
+			   ? (ULONGEST) a / (ULONGEST) b
+			   : (ULONGEST) a % (ULONGEST) b);
+	  break;
+
+	case aop_lsh:
+	case aop_rsh_signed:
+	case aop_rsh_unsigned:
+	  b = stack[--sp];
+	  a = stack[sp - 1];
+	  if (b < 0 || b >= sizeof (LONGEST) * 8)
+	    stack[sp - 1] = op == aop_rsh_signed && a < 0 ? -1 : 0;
+	  else if (op == aop_lsh)
+	    stack[sp - 1] = (ULONGEST) a << b;
+	  else if (op == aop_rsh_signed)
+	    stack[sp - 1] = a < 0 ? ~(~a >> b) : a >> b;
+	  else
+	    stack[sp - 1] = (ULONGEST) a >> b;
+	  break;
+
+	case aop_log_not:
+	  stack[sp - 1] = !stack[sp - 1];
+	  break;
+
+	case aop_bit_and:
+	  b = stack[--sp];
+	  stack[sp - 1] &= b;
+	  break;
+
+	case aop_bit_or:
+	  b = stack[--sp];
+	  stack[sp - 1] |= b;
+	  break;
+
+	case aop_bit_xor:
+	  b = stack[--sp];
+	  stack[sp - 1] ^= b;
+	  break;
+
+	case aop_bit_not:
+	  stack[sp - 1] = ~stack[sp - 1];
+	  break;
+
+	case aop_equal:
+	  b = stack[--sp];
+	  stack[sp - 1] = stack[sp - 1] == b;
+	  break;
+
+	case aop_less_signed:
+	  b = stack[--sp];
+	  stack[sp - 1] = stack[sp - 1] < b;
+	  break;
+
+	case aop_less_unsigned:
+	  b = stack[--sp];
+	  stack[sp - 1] = (ULONGEST) stack[sp - 1] < (ULONGEST) b;
+	  break;
+
+	case aop_ext:
+	  n = ax->buf[i++];
+	  if (n < sizeof (LONGEST) * 8)
+	    {
+	      ULONGEST sign = (ULONGEST) 1 << (n - 1);
+	      ULONGEST mask = ((ULONGEST) 1 << n) - 1;
+
+	      stack[sp - 1] = (((ULONGEST) stack[sp - 1] & mask) ^ sign) - sign;
+	    }
+	  break;
+
+	case aop_zero_ext:
+	  n = ax->buf[i++];
+	  if (n < sizeof (LONGEST) * 8)
+	    stack[sp - 1] &= ((ULONGEST) 1 << n) - 1;
+	  break;
+
+	case aop_ref8:
+	  stack[sp - 1] = read_memory_unsigned_integer (stack[sp - 1], 1);
+	  break;
+
+	case aop_ref16:
+	  stack[sp - 1] = read_memory_unsigned_integer (stack[sp - 1], 2);
+	  break;
+
+	case aop_ref32:
+	  stack[sp - 1] = read_memory_unsigned_integer (stack[sp - 1], 4);
+	  break;
+
+	case aop_ref64:
+	  stack[sp - 1] = read_memory_unsigned_integer (stack[sp - 1], 8);
+	  break;
+
+	case aop_if_goto:
+	  if (stack[--sp] != 0)
+	    i = (ax->buf[i] << 8) | ax->buf[i + 1];
+	  else
+	    i += 2;
+	  break;
+
+	case aop_goto:
+	  i = (ax->buf[i] << 8) | ax->buf[i + 1];
+	  break;
+
+	case aop_const8:
+	case aop_const16:
+	case aop_const32:
+	case aop_const64:
+	  {
+	    ULONGEST k = 0;
+
+	    for (n = 1 << (op - aop_const8); n > 0; n--)
+	      k = (k << 8) | ax->buf[i++];
+	    stack[sp++] = k;
+	  }
+	  break;
+
+	case aop_reg:
+	  n = (ax->buf[i] << 8) | ax->buf[i + 1];
+	  i += 2;
+	  stack[sp++] = get_frame_register_unsigned (frame, n);
+	  break;
+
+	case aop_frame_args_address:
+	  stack[sp++] = get_frame_args_address (frame);
+	  break;
+
+	case aop_frame_locals_address:
+	  stack[sp++] = get_frame_locals_address (frame);
+	  break;
+
+	case aop_frame_base:
+	  stack[sp++] = dwarf2_frame_base_address (frame);
+	  break;
+
+	case aop_dup:
+	  stack[sp] = stack[sp - 1];
+	  sp++;
+	  break;
+
+	case aop_pop:
+	  sp--;
+	  break;
+
+	case aop_swap:
+	  a = stack[sp - 1];
+	  stack[sp - 1] = stack[sp - 2];
+	  stack[sp - 2] = a;
+	  break;
+
+	case aop_end:
+	  return stack[sp - 1];
+
+	default:
+	  error (_("GDB can't evaluate the `%s' bytecode itself."),
+		 op < aop_last && aop_map[op].name ? aop_map[op].name : "?");
+	}
+    }
+}
+/* APPLE LOCAL end compiled breakpoint conditions */
+
 static void
 agent_command (char *exp, int from_tty)
 {
@@ -110,4 +110,18 @@ extern struct agent_expr *expr_to_address_and_size (struct expression *EXPR);
    function to discover which registers the expression uses.  */
 extern struct agent_expr *gen_trace_for_expr (CORE_ADDR, struct expression *);
 
+/* APPLE LOCAL begin compiled breakpoint conditions */
+struct frame_info;
+
+/* Given a GDB expression EXPR with an integer or pointer value, return
+   bytecode for GDB itself to compute that value, in a frame whose pc
+   is SCOPE.  Signal an error if the expression can't be compiled.  */
+extern struct agent_expr *gen_eval_for_expr (CORE_ADDR SCOPE,
+					     struct expression *EXPR);
+
+/* Run the bytecode AX, from gen_eval_for_expr, in FRAME, and return
+   its value.  */
+extern LONGEST ax_eval (struct agent_expr *AX, struct frame_info *FRAME);
+/* APPLE LOCAL end compiled breakpoint conditions */
+
 #endif /* AX_GDB_H */
@@ -49,6 +49,8 @@ new_agent_expr (CORE_ADDR scope)
 				   reallocation code is tested.  */
   x->buf = xmalloc (x->size);
   x->scope = scope;
+  /* APPLE LOCAL compiled breakpoint conditions */
+  x->host = 0;
 
   return x;
 }
@@ -326,6 +328,11 @@ struct aop_map aop_map[] =
   {0, 0, 0, 0, 0},		/* 0x2e */
   {0, 0, 0, 0, 0},		/* 0x2f */
   {"trace16", 2, 0, 1, 1},	/* 0x30 */
+  /* APPLE LOCAL begin compiled breakpoint conditions */
+  {"frame_args_address", 0, 0, 0, 1},	/* 0x31 */
+  {"frame_locals_address", 0, 0, 0, 1},	/* 0x32 */
+  {"frame_base", 0, 0, 0, 1},	/* 0x33 */
+  /* APPLE LOCAL end compiled breakpoint conditions */
 };
 
 
@@ -72,6 +72,12 @@ struct agent_expr
     int len;			/* number of characters used */
     int size;			/* allocated size */
     CORE_ADDR scope;
+    /* APPLE LOCAL begin compiled breakpoint conditions */
+    /* Non-zero if GDB itself will evaluate this expression, with
+       ax_eval, rather than sending it to an agent.  Only host
+       expressions may use the host-only opcodes below.  */
+    int host;
+    /* APPLE LOCAL end compiled breakpoint conditions */
   };
 
 
@@ -133,6 +139,15 @@ enum agent_op
     aop_zero_ext = 0x2a,
     aop_swap = 0x2b,
     aop_trace16 = 0x30,
+    /* APPLE LOCAL begin compiled breakpoint conditions */
+    /* Host-only opcodes: push the base address of the arguments or
+       locals, or the DWARF frame base, of the frame the expression is
+       evaluated in.  An agent has no notion of frames, so these never
+       go over the wire.  */
+    aop_frame_args_address = 0x31,
+    aop_frame_locals_address = 0x32,
+    aop_frame_base = 0x33,
+    /* APPLE LOCAL end compiled breakpoint conditions */
     aop_last
   };
 
@@ -26,6 +26,8 @@
 #include "bcache.h"
 #include "gdb_string.h"		/* For memcpy declaration */
 #include "gdb_assert.h"
+/* APPLE LOCAL sharded bcache */
+#include "gdbcmd.h"
 
 #include <stddef.h>
 #include <stdlib.h>
@@ -57,6 +59,32 @@ struct bstring
 };
 
 
+/* APPLE LOCAL begin sharded bcache */
+/* A bcache's strings are spread over BCACHE_SHARDS hash tables,
+   picked by bits of the hash value that the bucket index hardly
+   depends on.  Each shard grows by itself, so growing one only
+   rehashes a fraction of the bcache's strings, and the tables of a
+   large bcache are never allocated in one piece.  */
+
+#define BCACHE_SHARDS (16)
+
+/* Which shard of a bcache the string with hash value H goes in.  */
+#define BCACHE_SHARD(h) (((h) >> 8) % BCACHE_SHARDS)
+
+struct bcache_shard
+{
+  /* How many hash buckets we're using.  */
+  unsigned int num_buckets;
+
+  /* Hash buckets.  This table is allocated using malloc, so when we
+     grow the table we can return the old table to the system.  */
+  struct bstring **bucket;
+
+  /* Number of unique strings in this shard.  */
+  unsigned long unique_count;
+};
+/* APPLE LOCAL end sharded bcache */
+
 /* The structure for a bcache itself.  The bcache is initialized, in
    bcache_xmalloc(), by filling it with zeros and then setting the
    corresponding obstack's malloc() and free() methods.  */
@@ -69,12 +97,8 @@ struct bcache
   /* APPLE LOCAL bcache pool */
   void *pool;
 
-  /* How many hash buckets we're using.  */
-  unsigned int num_buckets;
-  
-  /* Hash buckets.  This table is allocated using malloc, so when we
-     grow the table we can return the old table to the system.  */
-  struct bstring **bucket;
+  /* APPLE LOCAL sharded bcache */
+  struct bcache_shard shard[BCACHE_SHARDS];
 
   /* Statistics.  */
   unsigned long unique_count;	/* number of unique strings */
@@ -95,25 +119,65 @@ struct bcache
   unsigned long half_hash_miss_count;
 };
 
-/* The old hash function was stolen from SDBM. This is what DB 3.0 uses now,
- * and is better than the old one. 
- */
-
+/* APPLE LOCAL begin sharded bcache */
+/* The hash function.  This used to multiply in one byte at a time,
+   the way the FNV hash does (which replaced the one from SDBM); most
+   of what we hash is whole structures, so now we take a word at a
+   time and mix the bits well at the end instead.  The loads go
+   through memcpy since ADDR needn't be aligned.  */
+
+#define HASH_MULTIPLIER (0x9e3779b1UL)
+
 unsigned long
-hash(const void *addr, int length)
+hash (const void *addr, int length)
 {
-		const unsigned char *k, *e;
-		unsigned long h;
-		
-		k = (const unsigned char *)addr;
-		e = k+length;
-		for (h=0; k< e;++k)
-		{
-				h *=16777619;
-				h ^= *k;
-		}
-		return (h);
+  const unsigned char *k = (const unsigned char *) addr;
+  unsigned long h = (unsigned long) length * HASH_MULTIPLIER;
+  unsigned long w;
+
+  while (length >= (int) sizeof (w))
+    {
+      memcpy (&w, k, sizeof (w));
+      h = (h ^ w) * HASH_MULTIPLIER;
+      h ^= h >> 15;
+      k += sizeof (w);
+      length -= sizeof (w);
+    }
+
+  if (length > 0)
+    {
+      w = 0;
+      memcpy (&w, k, length);
+      h = (h ^ w) * HASH_MULTIPLIER;
+    }
+
+  h ^= h >> 16;
+  h *= 0x85ebca6bUL;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35UL;
+  h ^= h >> 16;
+  return h;
 }
+
+/* The hash function as it was, kept only to compare against in
+   "maint bcache-benchmark".  */
+
+static unsigned long
+bytewise_hash (const void *addr, int length)
+{
+  const unsigned char *k, *e;
+  unsigned long h;
+
+  k = (const unsigned char *) addr;
+  e = k + length;
+  for (h = 0; k < e; ++k)
+    {
+      h *= 16777619;
+      h ^= *k;
+    }
+  return h;
+}
+/* APPLE LOCAL end sharded bcache */
 
 /* Growing the bcache's hash table.  */
 
@@ -121,15 +185,21 @@ hash(const void *addr, int length)
    resize our hash table.  */
 #define CHAIN_LENGTH_THRESHOLD (5)
 
+/* APPLE LOCAL sharded bcache: Grow the hash table of SHARD, one of
+   BCACHE's shards.  */
+
 static void
-expand_hash_table (struct bcache *bcache)
+expand_hash_table (struct bcache *bcache, struct bcache_shard *shard)
 {
   /* A table of good hash table sizes.  Whenever we grow, we pick the
-     next larger size from this table.  sizes[i] is close to 1 << (i+10),
+     next larger size from this table.  sizes[i] is close to 1 << (i+6),
      so we roughly double the table size each time.  After we fall off 
      the end of this table, we just double.  Don't laugh --- there have
      been executables sighted with a gigabyte of debug info.  */
+  /* APPLE LOCAL sharded bcache: Start small, since a bcache now has
+     BCACHE_SHARDS tables.  */
   static unsigned long sizes[] = { 
+    61, 127, 251, 509,
     1021, 2053, 4099, 8191, 16381, 32771,
     65537, 131071, 262144, 524287, 1048573, 2097143,
     4194301, 8388617, 16777213, 33554467, 67108859, 134217757,
@@ -142,12 +212,12 @@ expand_hash_table (struct bcache *bcache)
   /* Count the stats.  Every unique item needs to be re-hashed and
      re-entered.  */
   bcache->expand_count++;
-  bcache->expand_hash_count += bcache->unique_count;
+  bcache->expand_hash_count += shard->unique_count;
 
   /* Find the next size.  */
-  new_num_buckets = bcache->num_buckets * 2;
+  new_num_buckets = shard->num_buckets * 2;
   for (i = 0; i < (sizeof (sizes) / sizeof (sizes[0])); i++)
-    if (sizes[i] > bcache->num_buckets)
+    if (sizes[i] > shard->num_buckets)
       {
 	new_num_buckets = sizes[i];
 	break;
@@ -160,17 +230,17 @@ expand_hash_table (struct bcache *bcache)
     new_buckets = (struct bstring **) xmmalloc (bcache->pool, new_size);
     memset (new_buckets, 0, new_size);
 
-    bcache->structure_size -= (bcache->num_buckets
-			       * sizeof (bcache->bucket[0]));
+    bcache->structure_size -= (shard->num_buckets
+			       * sizeof (shard->bucket[0]));
     bcache->structure_size += new_size;
   }
 
   /* Rehash all existing strings.  */
-  for (i = 0; i < bcache->num_buckets; i++)
+  for (i = 0; i < shard->num_buckets; i++)
     {
       struct bstring *s, *next;
 
-      for (s = bcache->bucket[i]; s; s = next)
+      for (s = shard->bucket[i]; s; s = next)
 	{
 	  struct bstring **new_bucket;
 	  next = s->next;
@@ -183,11 +253,11 @@ expand_hash_table (struct bcache *bcache)
     }
 
   /* Plug in the new table.  */
-  if (bcache->bucket)
+  if (shard->bucket)
     /* APPLE LOCAL bcache pool */
-    xmfree (bcache->pool, bcache->bucket);
-  bcache->bucket = new_buckets;
-  bcache->num_buckets = new_num_buckets;
+    xmfree (bcache->pool, shard->bucket);
+  shard->bucket = new_buckets;
+  shard->num_buckets = new_num_buckets;
 }
 
 
@@ -207,22 +277,29 @@ bcache_data (const void *addr, int length, struct bcache *bcache)
   unsigned short half_hash;
   int hash_index;
   struct bstring *s;
-
-  /* If our average chain length is too high, expand the hash table.  */
-  if (bcache->unique_count >= bcache->num_buckets * CHAIN_LENGTH_THRESHOLD)
-    expand_hash_table (bcache);
+  /* APPLE LOCAL sharded bcache */
+  struct bcache_shard *shard;
 
   bcache->total_count++;
   bcache->total_size += length;
 
   full_hash = hash (addr, length);
   half_hash = (full_hash >> 16);
-  hash_index = full_hash % bcache->num_buckets;
+
+  /* APPLE LOCAL begin sharded bcache */
+  shard = &bcache->shard[BCACHE_SHARD (full_hash)];
+
+  /* If our average chain length is too high, expand the hash table.  */
+  if (shard->unique_count >= shard->num_buckets * CHAIN_LENGTH_THRESHOLD)
+    expand_hash_table (bcache, shard);
+
+  hash_index = full_hash % shard->num_buckets;
+  /* APPLE LOCAL end sharded bcache */
 
   /* Search the hash bucket for a string identical to the caller's.
      As a short-circuit first compare the upper part of each hash
      values.  */
-  for (s = bcache->bucket[hash_index]; s; s = s->next)
+  for (s = shard->bucket[hash_index]; s; s = s->next)
     {
       if (s->half_hash == half_hash)
 	{
@@ -240,10 +317,12 @@ bcache_data (const void *addr, int length, struct bcache *bcache)
       = obstack_alloc (&bcache->cache, BSTRING_SIZE (length));
     memcpy (&new->d.data, addr, length);
     new->length = length;
-    new->next = bcache->bucket[hash_index];
+    new->next = shard->bucket[hash_index];
     new->half_hash = half_hash;
-    bcache->bucket[hash_index] = new;
+    shard->bucket[hash_index] = new;
 
+    /* APPLE LOCAL sharded bcache */
+    shard->unique_count++;
     bcache->unique_count++;
     bcache->unique_size += length;
     bcache->structure_size += BSTRING_SIZE (length);
@@ -303,11 +382,17 @@ bcache_xmalloc (void *pool)
 void
 bcache_xfree (struct bcache *bcache)
 {
+  /* APPLE LOCAL sharded bcache */
+  int i;
+
   if (bcache == NULL)
     return;
   obstack_free (&bcache->cache, 0);
   /* APPLE LOCAL begin bcache pool */
-  xmfree (bcache->pool, bcache->bucket);
+  /* APPLE LOCAL sharded bcache */
+  for (i = 0; i < BCACHE_SHARDS; i++)
+    if (bcache->shard[i].bucket != NULL)
+      xmfree (bcache->pool, bcache->shard[i].bucket);
   xmfree (bcache->pool, bcache);
   /* APPLE LOCAL end bcache pool */
 }
@@ -348,48 +433,61 @@ print_bcache_statistics (struct bcache *c, char *type)
   int median_chain_length;
   int max_entry_size;
   int median_entry_size;
+  /* APPLE LOCAL begin sharded bcache */
+  /* The buckets of all the shards, taken together.  */
+  unsigned int num_buckets;
+  int i;
+
+  num_buckets = 0;
+  for (i = 0; i < BCACHE_SHARDS; i++)
+    num_buckets += c->shard[i].num_buckets;
+  /* APPLE LOCAL end sharded bcache */
 
   /* Count the number of occupied buckets, tally the various string
      lengths, and measure chain lengths.  */
   {
     unsigned int b;
-    int *chain_length = XCALLOC (c->num_buckets + 1, int);
+    int *chain_length = XCALLOC (num_buckets + 1, int);
     int *entry_size = XCALLOC (c->unique_count + 1, int);
     int stringi = 0;
+    /* APPLE LOCAL sharded bcache */
+    int chaini = 0;
 
     occupied_buckets = 0;
 
-    for (b = 0; b < c->num_buckets; b++)
-      {
-	struct bstring *s = c->bucket[b];
-
-	chain_length[b] = 0;
-
-	if (s)
-	  {
-	    occupied_buckets++;
-	    
-	    while (s)
-	      {
-		gdb_assert (b < c->num_buckets);
-		chain_length[b]++;
-		gdb_assert (stringi < c->unique_count);
-		entry_size[stringi++] = s->length;
-		s = s->next;
-	      }
-	  }
-      }
+    /* APPLE LOCAL sharded bcache */
+    for (i = 0; i < BCACHE_SHARDS; i++)
+      for (b = 0; b < c->shard[i].num_buckets; b++, chaini++)
+	{
+	  struct bstring *s = c->shard[i].bucket[b];
+
+	  chain_length[chaini] = 0;
+
+	  if (s)
+	    {
+	      occupied_buckets++;
+
+	      while (s)
+		{
+		  gdb_assert (chaini < num_buckets);
+		  chain_length[chaini]++;
+		  gdb_assert (stringi < c->unique_count);
+		  entry_size[stringi++] = s->length;
+		  s = s->next;
+		}
+	    }
+	}
 
     /* To compute the median, we need the set of chain lengths sorted.  */
-    qsort (chain_length, c->num_buckets, sizeof (chain_length[0]),
+    qsort (chain_length, num_buckets, sizeof (chain_length[0]),
 	   compare_ints);
     qsort (entry_size, c->unique_count, sizeof (entry_size[0]),
 	   compare_ints);
 
-    if (c->num_buckets > 0)
+    if (num_buckets > 0)
       {
-	max_chain_length = chain_length[c->num_buckets - 1];
-	median_chain_length = chain_length[c->num_buckets / 2];
+	max_chain_length = chain_length[num_buckets - 1];
+	median_chain_length = chain_length[num_buckets / 2];
       }
     else
       {
@@ -442,7 +540,9 @@ print_bcache_statistics (struct bcache *c, char *type)
   print_percentage (c->total_size - c->structure_size, c->total_size);
   printf_filtered ("\n");
 
-  printf_filtered (_("    Hash table size:           %3d\n"), c->num_buckets);
+  printf_filtered (_("    Hash table size:           %3d\n"), num_buckets);
+  /* APPLE LOCAL sharded bcache */
+  printf_filtered (_("    Hash table shards:         %3d\n"), BCACHE_SHARDS);
   printf_filtered (_("    Hash table expands:        %lu\n"),
 		   c->expand_count);
   printf_filtered (_("    Hash table hashes:         %lu\n"),
@@ -450,12 +550,12 @@ print_bcache_statistics (struct bcache *c, char *type)
   printf_filtered (_("    Half hash misses:          %lu\n"),
 		   c->half_hash_miss_count);
   printf_filtered (_("    Hash table population:     "));
-  print_percentage (occupied_buckets, c->num_buckets);
+  print_percentage (occupied_buckets, num_buckets);
   printf_filtered (_("    Median hash chain length:  %3d\n"),
 		   median_chain_length);
   printf_filtered (_("    Average hash chain length: "));
-  if (c->num_buckets > 0)
-    printf_filtered ("%3lu\n", c->unique_count / c->num_buckets);
+  if (num_buckets > 0)
+    printf_filtered ("%3lu\n", c->unique_count / num_buckets);
   else
     /* i18n: "Average hash chain length: (not applicable)" */
     printf_filtered (_("(not applicable)\n"));
@@ -468,3 +568,78 @@ bcache_memory_used (struct bcache *bcache)
 {
   return obstack_memory_used (&bcache->cache);
 }
+
+/* APPLE LOCAL begin sharded bcache */
+/* Measure how quickly a bcache takes in partial-symbol-sized records,
+   half of which are duplicates, and how quickly the hash function
+   hashes them compared to the byte-at-a-time one it replaced.  ARGS
+   is the number of records, a million by default.  */
+
+#define BENCHMARK_RECORD_SIZE (24)
+
+static void
+maintenance_bcache_benchmark (char *args, int from_tty)
+{
+  char record[BENCHMARK_RECORD_SIZE];
+  struct bcache *b;
+  long count = 1000000;
+  long i, key, start, word_time, byte_time, enter_time;
+  volatile unsigned long sink = 0;
+
+  if (args != NULL && *args != '\0')
+    count = strtol (args, NULL, 10);
+  if (count <= 0)
+    error (_("The number of records must be positive."));
+
+  memset (record, 0, sizeof (record));
+
+  start = get_run_time ();
+  for (i = 0; i < count; i++)
+    {
+      key = i / 2;
+      memcpy (record + 8, &key, sizeof (key));
+      sink ^= hash (record, sizeof (record));
+    }
+  word_time = get_run_time () - start;
+
+  start = get_run_time ();
+  for (i = 0; i < count; i++)
+    {
+      key = i / 2;
+      memcpy (record + 8, &key, sizeof (key));
+      sink ^= bytewise_hash (record, sizeof (record));
+    }
+  byte_time = get_run_time () - start;
+
+  b = bcache_xmalloc (NULL);
+  start = get_run_time ();
+  for (i = 0; i < count; i++)
+    {
+      key = i / 2;
+      memcpy (record + 8, &key, sizeof (key));
+      bcache (record, sizeof (record), b);
+    }
+  enter_time = get_run_time () - start;
+
+  printf_filtered (_("Hashed %ld records in %ld usec "
+		     "(%ld usec a byte at a time).\n"),
+		   count, word_time, byte_time);
+  printf_filtered (_("Entered %ld records, %lu unique, in %ld usec.\n"),
+		   count, b->unique_count, enter_time);
+  if (from_tty)
+    print_bcache_statistics (b, "benchmark");
+  bcache_xfree (b);
+}
+
+extern initialize_file_ftype _initialize_bcache; /* -Wmissing-prototypes */
+
+void
+_initialize_bcache (void)
+{
+  add_cmd ("bcache-benchmark", class_maintenance,
+	   maintenance_bcache_benchmark, _("\
+Time hashing and caching records in a bcache.\n\
+The argument is the number of records, a million by default."),
+	   &maintenancelist);
+}
+/* APPLE LOCAL end sharded bcache */
@@ -175,7 +175,8 @@ extern struct bcache *bcache_xmalloc (void *);
 extern void print_bcache_statistics (struct bcache *bcache, char *type);
 extern int bcache_memory_used (struct bcache *bcache);
 
-/* The hash function */
+/* The hash function.  APPLE LOCAL sharded bcache: It reads ADDR a
+   word at a time, so its values differ between hosts.  */
 extern unsigned long hash(const void *addr, int length);
 
 #endif /* BCACHE_H */
@@ -25,6 +25,8 @@
 #include "symfile.h"
 #include "gdb_obstack.h"
 #include "cp-support.h"
+/* APPLE LOCAL lazy function bodies  */
+#include "exceptions.h"
 /* APPLE LOCAL cache lookup values for improved performance  */
 #include "inferior.h"
 
@@ -313,6 +315,23 @@ blockvector_for_pc_sect (CORE_ADDR pc, struct bfd_section *section,
       if (block_contains_pc (b, pc))
       /* APPLE LOCAL end address ranges  */
 	{
+	  /* APPLE LOCAL begin lazy function bodies  */
+	  /* If PC is in a function whose body hasn't been read yet,
+	     read it in now.  The blocks inside a function read in that
+	     way are in a blockvector of their own, in the usual order,
+	     so the last one there that contains PC is the innermost.
+	     The function block itself is at FIRST_LOCAL_BLOCK.  */
+	  if (BLOCK_LAZY (b) != NULL && !currently_reading_symtab)
+	    block_expand_lazy (b);
+	  if (BLOCK_NESTED (b) != NULL)
+	    {
+	      bl = BLOCK_NESTED (b);
+	      for (bot = BLOCKVECTOR_NBLOCKS (bl) - 1;
+		   bot > FIRST_LOCAL_BLOCK; bot--)
+		if (block_contains_pc (BLOCKVECTOR_BLOCK (bl, bot), pc))
+		  break;
+	    }
+	  /* APPLE LOCAL end lazy function bodies  */
 	  if (pindex)
 	    *pindex = bot;
 	  /* APPLE LOCAL begom cache lookup values for improved 
@@ -331,6 +350,51 @@ blockvector_for_pc_sect (CORE_ADDR pc, struct bfd_section *section,
   return 0;
 }
 
+/* APPLE LOCAL begin lazy function bodies  */
+/* Read in the symbols of BLOCK if it is a function block whose body
+   was skipped when its symtab was built.  Code that is about to look
+   at the symbols of a function block it didn't get from
+   blockvector_for_pc_sect calls this first; until then BLOCK_DICT
+   only has a placeholder.  Nothing is read while another symtab is
+   being read in.  An error while reading leaves the block with the
+   placeholder for good.  */
+
+void
+block_expand_lazy (struct block *block)
+{
+  struct block_lazy *lazy = BLOCK_LAZY (block);
+  volatile struct gdb_exception e;
+  volatile int done = 0;
+
+  if (lazy == NULL || currently_reading_symtab)
+    return;
+
+  BLOCK_LAZY (block) = NULL;
+  currently_reading_symtab++;
+  TRY_CATCH (e, RETURN_MASK_ALL)
+    {
+      done = lazy->expand (block, lazy->data);
+    }
+  currently_reading_symtab--;
+
+  if (e.reason == RETURN_QUIT)
+    {
+      BLOCK_LAZY (block) = lazy;
+      throw_exception (e);
+    }
+  else if (e.reason < 0)
+    exception_fprintf (gdb_stderr, e,
+		       _("warning: reading symbols for %s: "),
+		       SYMBOL_PRINT_NAME (BLOCK_FUNCTION (block)));
+  else if (!done)
+    BLOCK_LAZY (block) = lazy;
+  else
+    /* The blockvector lookups cached for pcs in this function missed
+       its nested blocks.  */
+    symtab_clear_cached_lookup_values ();
+}
+/* APPLE LOCAL end lazy function bodies  */
+
 /* Return the blockvector immediately containing the innermost lexical block
    containing the specified pc value, or 0 if there is none.
    Backward compatibility, no section.  */
@@ -511,6 +575,10 @@ allocate_block (struct obstack *obstack)
   BLOCK_END (bl) = 0;
   BLOCK_FUNCTION (bl) = NULL;
   BLOCK_SUPERBLOCK (bl) = NULL;
+  /* APPLE LOCAL begin lazy function bodies  */
+  BLOCK_LAZY (bl) = NULL;
+  BLOCK_NESTED (bl) = NULL;
+  /* APPLE LOCAL end lazy function bodies  */
   BLOCK_DICT (bl) = NULL;
   BLOCK_NAMESPACE (bl) = NULL;
   BLOCK_GCC_COMPILED (bl) = 0;
@@ -30,6 +30,8 @@ struct block_namespace_info;
 struct using_direct;
 struct obstack;
 struct dictionary;
+/* APPLE LOCAL lazy function bodies  */
+struct block;
 
 /* APPLE LOCAL begin address ranges  */
 struct address_range
@@ -45,6 +47,19 @@ struct address_range_list
 };
 /* APPLE LOCAL end address ranges  */
 
+/* APPLE LOCAL begin lazy function bodies  */
+/* How to read in the symbols and nested blocks of a function block
+   whose body was skipped when its symtab was built.  EXPAND fills in
+   BLOCK from DATA and returns non-zero, or returns zero if the body
+   can't be read right now and should be tried again later.  */
+
+struct block_lazy
+{
+  int (*expand) (struct block *block, void *data);
+  void *data;
+};
+/* APPLE LOCAL end lazy function bodies  */
+
 /* All of the name-scope contours of the program
    are represented by `struct block' objects.
    All of these objects are pointed to by the blockvector.
@@ -105,6 +120,21 @@ struct block
 
   struct dictionary *dict;
 
+  /* APPLE LOCAL begin lazy function bodies  */
+  /* If non-NULL, DICT only holds a placeholder, and the symbols of
+     this function block are read in through LAZY by the first
+     block_expand_lazy call.  */
+
+  struct block_lazy *lazy;
+
+  /* If this is a function block whose body was read in by
+     block_expand_lazy, the blockvector of the lexical blocks inside
+     it, with this block itself at FIRST_LOCAL_BLOCK; otherwise NULL.
+     Those blocks are not in the symtab's blockvector.  */
+
+  struct blockvector *nested;
+  /* APPLE LOCAL end lazy function bodies  */
+
   /* Used for language-specific info.  */
 
   union
@@ -140,6 +170,10 @@ struct block
 #define BLOCK_SUPERBLOCK(bl)	(bl)->superblock
 #define BLOCK_GCC_COMPILED(bl)	(bl)->gcc_compile_flag
 #define BLOCK_DICT(bl)		(bl)->dict
+/* APPLE LOCAL begin lazy function bodies  */
+#define BLOCK_LAZY(bl)		(bl)->lazy
+#define BLOCK_NESTED(bl)	(bl)->nested
+/* APPLE LOCAL end lazy function bodies  */
 #define BLOCK_NAMESPACE(bl)   (bl)->language_specific.cplus_specific.namespace
 /* APPLE LOCAL begin address ranges  */
 #define BLOCK_RANGES(bl)        (bl)->ranges
@@ -210,4 +244,7 @@ extern int block_starts_and_ends (struct block *, CORE_ADDR, CORE_ADDR);
 extern CORE_ADDR block_highest_pc (const struct block *bl);
 /* APPLE LOCAL end address ranges  */
 
+/* APPLE LOCAL lazy function bodies  */
+extern void block_expand_lazy (struct block *block);
+
 #endif /* BLOCK_H */
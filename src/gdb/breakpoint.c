@@ -59,6 +59,9 @@
 #include "solist.h"
 #include "observer.h"
 #include "exceptions.h"
+/* APPLE LOCAL compiled breakpoint conditions */
+#include "ax.h"
+#include "ax-gdb.h"
 /* APPLE LOCAL: for exception catching regex */
 #include "gdb_regex.h"
 
@@ -104,7 +107,8 @@ static void catch_command (char *, int);
 
 static void watch_command (char *, int);
 
-static int can_use_hardware_watchpoint (struct value *);
+/* APPLE LOCAL page watchpoints */
+static int can_use_hardware_watchpoint (struct value *, int);
 
 /* APPLE LOCAL begin handle duplicate breakpoints  */
 /* APPLE LOCAL radar 6067785 - Remove static qualifier */
@@ -192,6 +196,19 @@ static void condition_command (char *, int);
 static void condition_command_1 (struct breakpoint *b, char *condition, int from_tty);
 /* APPLE LOCAL end refactor condition_command */
 
+/* APPLE LOCAL begin compiled breakpoint conditions */
+static void breakpoint_forget_cond_bytecode (struct breakpoint *b);
+static void breakpoint_compile_cond (struct breakpoint *b);
+static void print_condition_benchmark (const char *method, long count,
+				       long usecs);
+static void maintenance_breakpoint_condition_benchmark (char *args,
+							 int from_tty);
+
+/* Non-zero if breakpoint conditions should be compiled to bytecode,
+   which is quicker to evaluate than the expression itself.  */
+static int compile_breakpoint_conditions = 1;
+/* APPLE LOCAL end compiled breakpoint conditions */
+
 static int get_number_trailer (char **, int);
 
 static void do_captured_parse_breakpoint (struct ui_out *, void *);
@@ -359,6 +376,18 @@ Debugger's behavior regarding pending breakpoints is %s.\n"),
 		    value);
 }
 
+/* APPLE LOCAL begin compiled breakpoint conditions */
+static void
+show_compile_breakpoint_conditions (struct ui_file *file, int from_tty,
+				    struct cmd_list_element *c,
+				    const char *value)
+{
+  fprintf_filtered (file, _("\
+Compiling breakpoint conditions to bytecode is %s.\n"),
+		    value);
+}
+/* APPLE LOCAL end compiled breakpoint conditions */
+
 void _initialize_breakpoint (void);
 
 extern int addressprint;	/* Print machine addresses? */
@@ -728,6 +757,8 @@ static void
 condition_command_1 (struct breakpoint *b, char *condition, int from_tty)
 {
 
+  /* APPLE LOCAL compiled breakpoint conditions */
+  breakpoint_forget_cond_bytecode (b);
   if (b->cond)
     {
       xfree (b->cond);
@@ -765,12 +796,133 @@ condition_command_1 (struct breakpoint *b, char *condition, int from_tty)
 		       "Will try again when we hit the breakpoint.");
 	  else if (*condition)
 	    error ("Junk at end of expression.");
+	  /* APPLE LOCAL compiled breakpoint conditions */
+	  breakpoint_compile_cond (b);
 	}
     }
   return;
 }
 /* APPLE LOCAL end refactor condition_command */
 
+/* APPLE LOCAL begin compiled breakpoint conditions */
+/* Throw away the bytecode compiled from B's condition; call this
+   whenever the condition itself goes away.  */
+
+static void
+breakpoint_forget_cond_bytecode (struct breakpoint *b)
+{
+  if (b->cond_bytecode != NULL)
+    free_agent_expr (b->cond_bytecode);
+  b->cond_bytecode = NULL;
+  b->cond_compiled = 0;
+}
+
+/* Try to compile B's condition to bytecode, if we haven't tried
+   already since the symbols last changed.  Conditions that use
+   anything the bytecode can't express -- function calls, floating
+   point, convenience variables and so on -- are left for
+   evaluate_expression.  */
+
+static void
+breakpoint_compile_cond (struct breakpoint *b)
+{
+  struct agent_expr *ax = NULL;
+  volatile struct gdb_exception e;
+
+  if (b->cond_compiled && b->cond_generation != symbol_generation)
+    breakpoint_forget_cond_bytecode (b);
+  if (b->cond == NULL || b->cond_compiled || !compile_breakpoint_conditions)
+    return;
+  b->cond_compiled = 1;
+  b->cond_generation = symbol_generation;
+
+  TRY_CATCH (e, RETURN_MASK_ERROR)
+    {
+      ax = gen_eval_for_expr (b->loc->address, b->cond);
+    }
+  if (e.reason < 0)
+    return;
+  b->cond_bytecode = ax;
+}
+
+/* Print how long evaluating a condition COUNT times by METHOD took,
+   if USECS microseconds.  */
+
+static void
+print_condition_benchmark (const char *method, long count, long usecs)
+{
+  printf_filtered (_("Evaluated %ld times %s in %ld usec"),
+		   count, method, usecs);
+  if (usecs > 0)
+    printf_filtered (_(", %.0f hits a second"),
+		     (double) count * 1000000.0 / usecs);
+  printf_filtered (".\n");
+}
+
+/* Implement "maint breakpoint-condition-benchmark BPNUM [COUNT]".  */
+
+static void
+maintenance_breakpoint_condition_benchmark (char *args, int from_tty)
+{
+  struct breakpoint *b;
+  struct frame_info *frame;
+  struct value *mark;
+  char *p = args;
+  long count = 100000;
+  long i, start;
+  int bnum;
+  /* APPLE LOCAL value free list */
+  unsigned long values_before, heap_before, values_after, heap_after;
+
+  if (args == NULL || *args == '\0')
+    error_no_arg (_("breakpoint number"));
+  bnum = get_number (&p);
+  if (*p != '\0')
+    count = strtol (p, NULL, 10);
+  if (count <= 0)
+    error (_("The number of evaluations must be positive."));
+
+  ALL_BREAKPOINTS (b)
+    if (b->number == bnum)
+      break;
+  if (b == NULL)
+    error (_("No breakpoint number %d."), bnum);
+  if (b->cond == NULL)
+    error (_("Breakpoint %d has no parsed condition."), bnum);
+  frame = get_selected_frame (_("No frame selected."));
+
+  value_allocation_counts (&values_before, &heap_before);
+  start = get_run_time ();
+  for (i = 0; i < count; i++)
+    {
+      mark = value_mark ();
+      value_true (evaluate_expression (b->cond));
+      value_free_to_mark (mark);
+    }
+  print_condition_benchmark ("as an expression", count,
+			     get_run_time () - start);
+  /* APPLE LOCAL begin value free list */
+  value_allocation_counts (&values_after, &heap_after);
+  printf_filtered (_("Each evaluation made %.1f values, "
+		     "%.1f of them with malloc.\n"),
+		   (double) (values_after - values_before) / count,
+		   (double) (heap_after - heap_before) / count);
+  /* APPLE LOCAL end value free list */
+
+  breakpoint_compile_cond (b);
+  if (b->cond_bytecode == NULL)
+    {
+      printf_filtered (_("The condition was not compiled to bytecode.\n"));
+      return;
+    }
+
+  start = get_run_time ();
+  for (i = 0; i < count; i++)
+    ax_eval (b->cond_bytecode, frame);
+  print_condition_benchmark ("as bytecode", count, get_run_time () - start);
+}
+/* APPLE LOCAL end compiled breakpoint conditions */
+
 static void
 commands_command (char *arg, int from_tty)
 {
@@ -1530,6 +1682,12 @@ reattach_breakpoints (int pid)
   inferior_ptid = pid_to_ptid (pid);
   ALL_BP_LOCATIONS (b)
   {
+    /* APPLE LOCAL begin page watchpoints */
+    /* Putting a watchpoint back takes more than its address; the
+       target puts back the page protections it watches with itself.  */
+    if (b->loc_type == bp_loc_hardware_watchpoint)
+      continue;
+    /* APPLE LOCAL end page watchpoints */
     if (b->inserted)
       {
 	remove_breakpoint (b, mark_inserted);
@@ -2843,19 +3001,31 @@ bpstat_print (bpstat bs)
   return PRINT_UNKNOWN;
 }
 
-/* Evaluate the expression EXP and return 1 if value is zero.
-   This is used inside a catch_errors to evaluate the breakpoint condition. 
-   The argument is a "struct expression *" that has been cast to char * to 
-   make it pass through catch_errors.  */
+/* APPLE LOCAL begin compiled breakpoint conditions */
+/* Evaluate the condition of the breakpoint BPT and return 1 if value
+   is zero.  This is used inside a catch_errors to evaluate the
+   breakpoint condition.  The argument is a "struct breakpoint *" that
+   has been cast to void * to make it pass through catch_errors.  Use
+   the compiled form of the condition if there is one and it is still
+   current.  */
 
 static int
-breakpoint_cond_eval (void *exp)
+breakpoint_cond_eval (void *bpt)
 {
-  struct value *mark = value_mark ();
-  int i = !value_true (evaluate_expression ((struct expression *) exp));
+  struct breakpoint *b = (struct breakpoint *) bpt;
+  struct value *mark;
+  int i;
+
+  if (b->cond_bytecode != NULL && compile_breakpoint_conditions
+      && b->cond_generation == symbol_generation)
+    return ax_eval (b->cond_bytecode, get_selected_frame (NULL)) == 0;
+
+  mark = value_mark ();
+  i = !value_true (evaluate_expression (b->cond));
   value_free_to_mark (mark);
   return i;
 }
+/* APPLE LOCAL end compiled breakpoint conditions */
 
 /* Allocate a new bpstat and chain it to the current one.  */
 
@@ -3416,10 +3586,13 @@ bpstat_stop_status (CORE_ADDR bp_addr, ptid_t ptid, int stopped_by_watchpoint)
 	    
             if (parse_succeeded)
               {
+		/* APPLE LOCAL begin compiled breakpoint conditions */
+		breakpoint_compile_cond (b);
 		value_is_zero
-		  = catch_errors (breakpoint_cond_eval, (b->cond),
+		  = catch_errors (breakpoint_cond_eval, b,
 				  "Error in testing breakpoint condition:\n",
 				  RETURN_MASK_ALL);
+		/* APPLE LOCAL end compiled breakpoint conditions */
 		/* FIXME-someday, should give breakpoint # */
 		free_all_values ();
 	      }
@@ -4473,6 +4646,62 @@ set_default_breakpoint (int valid, CORE_ADDR addr, struct symtab *symtab,
   default_breakpoint_line = line;
 }
 
+/* APPLE LOCAL begin symbol memory limit */
+/* Return the symtab of the default place for the `break' command, or
+   NULL if there is none.  */
+
+struct symtab *
+get_default_breakpoint_symtab (void)
+{
+  return default_breakpoint_valid ? default_breakpoint_symtab : NULL;
+}
+
+/* Return non-zero if EXP points into the obstack of OBJFILE; see
+   displays_use_objfile.  */
+
+static int
+expression_uses_objfile (struct expression *exp, struct objfile *objfile)
+{
+  int i;
+
+  if (exp == NULL)
+    return 0;
+  for (i = 0; i < exp->nelts; i++)
+    if (objfile_obstack_contains (objfile, exp->elts[i].symbol))
+      return 1;
+  return 0;
+}
+
+/* Return non-zero if the condition of a breakpoint, or the expression
+   a watchpoint watches, its block or the values it remembers, point
+   into the symbols of OBJFILE.  breakpoint_re_set only parses them
+   again the next time breakpoints are inserted, and until then the
+   old ones are still used.  */
+
+int
+breakpoints_use_objfile (struct objfile *objfile)
+{
+  struct breakpoint *b;
+  struct value *v;
+
+  ALL_BREAKPOINTS (b)
+    {
+      if (expression_uses_objfile (b->cond, objfile)
+	  || expression_uses_objfile (b->exp, objfile))
+	return 1;
+      if (b->exp_valid_block != NULL
+	  && objfile_obstack_contains (objfile, b->exp_valid_block))
+	return 1;
+      if (b->val != NULL && value_uses_objfile (b->val, objfile))
+	return 1;
+      for (v = b->val_chain; v != NULL; v = value_next (v))
+	if (value_uses_objfile (v, objfile))
+	  return 1;
+    }
+  return 0;
+}
+/* APPLE LOCAL end symbol memory limit */
+
 /* Return true iff it is meaningful to use the address member of
    BPT.  For some breakpoint types, the address member is irrelevant
    and it makes no sense to attempt to compare it to other addresses
@@ -5204,6 +5433,22 @@ disable_breakpoints_in_unloaded_shlib (struct so_list *solib)
   }
 }
 
+/* APPLE LOCAL begin deferred solib symbols */
+/* Return non-zero if some enabled breakpoint is still waiting for the
+   shared library it belongs in to be loaded.  */
+
+int
+pending_breakpoints_p (void)
+{
+  struct breakpoint *b;
+
+  ALL_BREAKPOINTS (b)
+    if (b->pending && b->enable_state == bp_enabled)
+      return 1;
+  return 0;
+}
+/* APPLE LOCAL end deferred solib symbols */
+
 /* Try to reenable any breakpoints in shared libraries.  */
 void
 /* APPLE LOCAL control silencing of breakpoint re-enable */
@@ -7518,7 +7763,8 @@ watch_command_1 (char *arg, int accessflag, int by_location, int from_tty)
   else
     bp_type = bp_hardware_watchpoint;
 
-  mem_cnt = can_use_hardware_watchpoint (val);
+  /* APPLE LOCAL page watchpoints */
+  mem_cnt = can_use_hardware_watchpoint (val, accessflag);
   if (mem_cnt == 0 && bp_type != bp_hardware_watchpoint)
     error (_("Expression cannot be implemented with read/access watchpoint."));
   if (mem_cnt != 0)
@@ -7633,8 +7879,18 @@ watch_command_1 (char *arg, int accessflag, int by_location, int from_tty)
      (TARGET_REGION_SIZE_OK_FOR_HW_WATCHPOINT(LEN))
 #endif
 
+/* APPLE LOCAL begin page watchpoints */
+/* Targets that can watch some regions only for some kinds of access
+   define this to see the target_hw_bp_type TYPE too.  */
+#if !defined(TARGET_REGION_OK_FOR_HW_WATCHPOINT_TYPE)
+#define TARGET_REGION_OK_FOR_HW_WATCHPOINT_TYPE(ADDR,LEN,TYPE) \
+     TARGET_REGION_OK_FOR_HW_WATCHPOINT(ADDR,LEN)
+#endif
+/* APPLE LOCAL end page watchpoints */
+
 static int
-can_use_hardware_watchpoint (struct value *v)
+/* APPLE LOCAL page watchpoints */
+can_use_hardware_watchpoint (struct value *v, int accessflag)
 {
   int found_memory_cnt = 0;
   struct value *head = v;
@@ -7687,7 +7943,9 @@ can_use_hardware_watchpoint (struct value *v)
 		  CORE_ADDR vaddr = VALUE_ADDRESS (v) + value_offset (v);
 		  int       len   = TYPE_LENGTH (value_type (v));
 
-		  if (!TARGET_REGION_OK_FOR_HW_WATCHPOINT (vaddr, len))
+		  /* APPLE LOCAL page watchpoints */
+		  if (!TARGET_REGION_OK_FOR_HW_WATCHPOINT_TYPE (vaddr, len,
+								accessflag))
 		    return 0;
 		  else
 		    found_memory_cnt++;
@@ -9114,6 +9372,8 @@ delete_breakpoint (struct breakpoint *bpt)
     }
 
   free_command_lines (&bpt->commands);
+  /* APPLE LOCAL compiled breakpoint conditions */
+  breakpoint_forget_cond_bytecode (bpt);
   if (bpt->cond)
     xfree (bpt->cond);
   if (bpt->cond_string != NULL)
@@ -9505,6 +9765,8 @@ breakpoint_re_set_one (void *bint)
 	  if (b->cond_string != NULL)
 	    {
 	      s = b->cond_string;
+	      /* APPLE LOCAL compiled breakpoint conditions */
+	      breakpoint_forget_cond_bytecode (b);
 	      if (b->cond)
 		{
 		  xfree (b->cond);
@@ -9670,6 +9932,8 @@ breakpoint_re_set_one (void *bint)
       if (b->cond_string != NULL)
 	{
 	  s = b->cond_string;
+	  /* APPLE LOCAL compiled breakpoint conditions */
+	  breakpoint_forget_cond_bytecode (b);
 	  if (b->cond)
 	    {
 	      xfree (b->cond);
@@ -10188,7 +10452,12 @@ is valid is not currently in scope.\n"), bpt->number);
 	      bpt->type == bp_access_watchpoint)
 	    {
 	      int i = hw_watchpoint_used_count (bpt->type, &other_type_used);
-	      int mem_cnt = can_use_hardware_watchpoint (bpt->val);
+	      /* APPLE LOCAL begin page watchpoints */
+	      int accessflag = (bpt->type == bp_read_watchpoint ? hw_read
+				: bpt->type == bp_access_watchpoint ? hw_access
+				: hw_write);
+	      int mem_cnt = can_use_hardware_watchpoint (bpt->val, accessflag);
+	      /* APPLE LOCAL end page watchpoints */
 
 	      /* APPLE LOCAL don't dummy-use locals */
 	      target_resources_ok = TARGET_CAN_USE_HARDWARE_WATCHPOINT (
@@ -11151,4 +11420,28 @@ user-query to see if a pending breakpoint should be created."),
 				&breakpoint_show_cmdlist);
 
   pending_break_support = AUTO_BOOLEAN_AUTO;
+
+  /* APPLE LOCAL begin compiled breakpoint conditions */
+  add_setshow_boolean_cmd ("compile-conditions", class_breakpoint,
+			   &compile_breakpoint_conditions, _("\
+Set whether breakpoint conditions are compiled to bytecode."), _("\
+Show whether breakpoint conditions are compiled to bytecode."), _("\
+If on, a breakpoint condition that uses only integer and pointer\n\
+arithmetic, comparisons and variables is compiled to bytecode when it\n\
+is set, and the bytecode is run each time the breakpoint is hit.  Other\n\
+conditions, and all conditions if this is off, are evaluated as\n\
+expressions."),
+			   NULL,
+			   show_compile_breakpoint_conditions,
+			   &breakpoint_set_cmdlist,
+			   &breakpoint_show_cmdlist);
+
+  add_cmd ("breakpoint-condition-benchmark", class_maintenance,
+	   maintenance_breakpoint_condition_benchmark, _("\
+Time evaluating a breakpoint's condition in the selected frame.\n\
+Usage: maint breakpoint-condition-benchmark BPNUM [COUNT]\n\
+The condition is evaluated COUNT times, a hundred thousand by default,\n\
+both as an expression and, if it compiles, as bytecode."),
+	   &maintenancelist);
+  /* APPLE LOCAL end compiled breakpoint conditions */
 }
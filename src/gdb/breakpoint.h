@@ -355,6 +355,17 @@ struct breakpoint
     struct frame_id frame_id;
     /* Conditional.  Break only if this expression's value is nonzero.  */
     struct expression *cond;
+    /* APPLE LOCAL begin compiled breakpoint conditions */
+    /* COND compiled to bytecode that GDB can run without making any
+       values, or NULL if it hasn't been or couldn't be.  */
+    struct agent_expr *cond_bytecode;
+    /* Non-zero once we have tried to compile COND.  */
+    int cond_compiled;
+    /* The symbol_generation when we tried.  The bytecode has the
+       addresses of static variables and minimal symbols built in, so
+       it is stale once the symbols change.  */
+    int cond_generation;
+    /* APPLE LOCAL end compiled breakpoint conditions */
 
     /* String we used to set the breakpoint (malloc'd).  */
     char *addr_string;
@@ -714,6 +725,9 @@ extern void set_ignore_count (int, int, int);
 
 extern void set_default_breakpoint (int, CORE_ADDR, struct symtab *, int);
 
+/* APPLE LOCAL symbol memory limit */
+extern struct symtab *get_default_breakpoint_symtab (void);
+
 extern void mark_breakpoints_out (void);
 
 extern void breakpoint_init_inferior (enum inf_context);
@@ -832,6 +846,12 @@ extern void disable_display (int);
 
 extern void clear_displays (void);
 
+/* APPLE LOCAL begin symbol memory limit */
+extern int displays_use_objfile (struct objfile *objfile);
+
+extern int breakpoints_use_objfile (struct objfile *objfile);
+/* APPLE LOCAL end symbol memory limit */
+
 extern void disable_breakpoint (struct breakpoint *);
 
 extern void enable_breakpoint (struct breakpoint *);
@@ -855,6 +875,10 @@ extern void disable_breakpoints_in_shlibs (int silent);
 /* APPLE LOCAL breakpoints */
 extern void re_enable_breakpoints_in_shlibs (int silent);
 
+/* APPLE LOCAL deferred solib symbols: Non-zero if an enabled
+   breakpoint is pending on a shared library load.  */
+extern int pending_breakpoints_p (void);
+
 extern void create_solib_load_event_breakpoint (char *, int, char *, char *);
 
 extern void create_solib_unload_event_breakpoint (char *, int,
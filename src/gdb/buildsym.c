@@ -660,6 +660,73 @@ make_blockvector (struct objfile *objfile)
 
   return (blockvector);
 }
+
+/* APPLE LOCAL begin lazy function bodies  */
+/* BLOCK is a function block in SYMTAB's blockvector whose body was
+   skipped when the blockvector was made.  The body has since been
+   read into the pending lists and closed with finish_block, as if
+   BLOCK were being made for the first time.  Move the symbols of
+   that new block into BLOCK, and put the lexical blocks of the body
+   in a blockvector of BLOCK's own, BLOCK_NESTED.  The symtab's
+   blockvector is left alone: copying it for every function read in
+   would cost memory in proportion to the whole compilation unit
+   each time.  */
+
+void
+finish_lazy_block (struct block *block, struct symtab *symtab,
+		   struct objfile *objfile)
+{
+  struct blockvector *bv;
+  struct pending_block *next;
+  struct block *body = NULL;
+  int nnested = 0;
+  int i;
+
+  for (next = pending_blocks; next; next = next->next)
+    if (BLOCK_SUPERBLOCK (next->block) == NULL)
+      body = next->block;
+    else
+      nnested++;
+  gdb_assert (body != NULL && BLOCK_FUNCTION (body) == BLOCK_FUNCTION (block));
+
+  BLOCK_DICT (block) = BLOCK_DICT (body);
+  SYMBOL_BLOCK_VALUE (BLOCK_FUNCTION (block)) = block;
+
+  if (nnested > 0)
+    {
+      bv = (struct blockvector *)
+	obstack_alloc (&objfile->objfile_obstack,
+		       (sizeof (struct blockvector)
+			+ (FIRST_LOCAL_BLOCK + nnested)
+			* sizeof (struct block *)));
+      BLOCKVECTOR_NBLOCKS (bv) = FIRST_LOCAL_BLOCK + 1 + nnested;
+      BLOCKVECTOR_BLOCK (bv, GLOBAL_BLOCK)
+	= BLOCKVECTOR_BLOCK (BLOCKVECTOR (symtab), GLOBAL_BLOCK);
+      BLOCKVECTOR_BLOCK (bv, STATIC_BLOCK)
+	= BLOCKVECTOR_BLOCK (BLOCKVECTOR (symtab), STATIC_BLOCK);
+      BLOCKVECTOR_BLOCK (bv, FIRST_LOCAL_BLOCK) = block;
+
+      /* pending_blocks is in the reverse of blockvector order.  BLOCK
+	 stays ahead of the blocks inside it, even those that start at
+	 the same address.  */
+      i = BLOCKVECTOR_NBLOCKS (bv);
+      for (next = pending_blocks; next; next = next->next)
+	if (next->block != body)
+	  {
+	    if (BLOCK_SUPERBLOCK (next->block) == body)
+	      BLOCK_SUPERBLOCK (next->block) = block;
+	    BLOCKVECTOR_BLOCK (bv, --i) = next->block;
+	  }
+      qsort (&BLOCKVECTOR_BLOCK (bv, FIRST_LOCAL_BLOCK + 1), nnested,
+	     sizeof (struct block *), compare_blocks);
+
+      BLOCK_NESTED (block) = bv;
+    }
+
+  pending_blocks = NULL;
+}
+/* APPLE LOCAL end lazy function bodies  */
+
 
 /* Start recording information about source code that came from an
    included (or otherwise merged-in) source file with a different
@@ -245,6 +245,10 @@ extern void finish_block (struct symbol *symbol,
 			  struct objfile *objfile);
 /* APPLE LOCAL end address ranges  */
 
+/* APPLE LOCAL lazy function bodies  */
+extern void finish_lazy_block (struct block *block, struct symtab *symtab,
+			       struct objfile *objfile);
+
 extern void really_free_pendings (void *dummy);
 
 extern void start_subfile (char *name, char *dirname);
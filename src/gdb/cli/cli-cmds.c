@@ -248,6 +248,8 @@ cli_interpreter_complete (void *data, char *word, char *command_buffer,
 {
   char **completions;
   struct cleanup *old_chain;
+  /* APPLE LOCAL max-completions */
+  int limited = 0;
 
   completions = complete_line (word, command_buffer, cursor);
   old_chain = make_cleanup_ui_out_list_begin_end (uiout, "completions");
@@ -299,6 +301,8 @@ cli_interpreter_complete (void *data, char *word, char *command_buffer,
               size = item;
               if (ui_out_is_mi_like_p (uiout))
                 ui_out_field_string (uiout, "limited", "true");
+	      /* APPLE LOCAL max-completions */
+	      limited = 1;
               break;
             }
         }
@@ -308,6 +312,19 @@ cli_interpreter_complete (void *data, char *word, char *command_buffer,
 
   /* APPLE LOCAL begin refactor command completion */
   do_cleanups (old_chain);
+  /* APPLE LOCAL begin max-completions */
+  if (max_completions_reached)
+    {
+      if (ui_out_is_mi_like_p (uiout))
+	{
+	  if (!limited)
+	    ui_out_field_string (uiout, "limited", "true");
+	}
+      else
+	ui_out_text (uiout, _("\
+*** List may be truncated, max-completions reached. ***\n"));
+    }
+  /* APPLE LOCAL end max-completions */
   return 1;
   /* APPLE LOCAL end refactor command completion */
 }
@@ -2139,6 +2139,8 @@ static struct sym_fns coff_sym_fns =
   coff_symfile_read,		/* sym_read: read a symbol file into symtab */
   coff_symfile_finish,		/* sym_finish: finished with file, cleanup */
   default_symfile_offsets,	/* sym_offsets:  xlate external to internal form */
+  /* APPLE LOCAL deferred solib symbols */
+  NULL,				/* sym_read_psymtabs: no separate debug info pass */
   NULL				/* next: pointer to next struct sym_fns */
 };
 
@@ -89,6 +89,12 @@ static char *gdb_completer_file_name_break_characters = " \t\n*|\"';:?><";
 char *gdb_completer_filename_word_break_characters = " ";
 /* APPLE LOCAL end completer */
 
+/* APPLE LOCAL begin max-completions */
+/* Set when the symbol names offered by the last complete_line were
+   cut short by "set max-completions".  */
+int max_completions_reached;
+/* APPLE LOCAL end max-completions */
+
 /* Characters that can be used to quote completion strings.  Note that we
    can't include '"' because the gdb C parser treats such quoted sequences
    as strings. */
@@ -401,6 +407,9 @@ complete_line (const char *text, char *line_buffer, int point)
   rl_completer_word_break_characters =
     current_language->la_word_break_characters();
 
+  /* APPLE LOCAL max-completions */
+  max_completions_reached = 0;
+
       /* Decide whether to complete on a list of gdb commands or on symbols. */
   tmp_command = (char *) alloca (point + 1);
   p = tmp_command;
@@ -657,6 +666,17 @@ line_completion_function (const char *text, int matches, char *line_buffer, int
 	}
       index = 0;
       list = complete_line (text, line_buffer, point);
+
+      /* APPLE LOCAL begin max-completions */
+      /* Readline only knows about the names it is given; say that
+	 there were more before it lists them.  */
+      if (max_completions_reached)
+	{
+	  printf_unfiltered (_("\n\
+*** List may be truncated, max-completions reached. ***\n"));
+	  rl_on_new_line ();
+	}
+      /* APPLE LOCAL end max-completions */
     }
 
   /* If we found a list of potential completions during initialization then
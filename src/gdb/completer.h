@@ -35,6 +35,7 @@ extern char *get_gdb_completer_quote_characters (void);
 
 /* APPLE LOCAL begin completer */
 extern char *gdb_completer_word_break_characters;
+extern int max_completions_reached;
 extern char *gdb_completer_filename_word_break_characters;
 /* APPLE LOCAL end completer */
 
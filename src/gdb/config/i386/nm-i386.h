@@ -115,6 +115,45 @@ extern int i386_stopped_by_watchpoint (void);
    reset all debug registers by calling i386_cleanup_dregs ().  */ 
 #define CHILD_POST_STARTUP_INFERIOR
 
+/* APPLE LOCAL begin page watchpoints */
+/* Targets should define this to fall back on write-protecting pages,
+   through linux-nat.c, for write watchpoints the debug registers
+   can't hold.  */
+#ifdef I386_USE_PAGE_WATCHPOINTS
+
+extern int i386_page_region_ok_for_watchpoint (CORE_ADDR addr, int len,
+					       int type);
+extern int i386_page_insert_watchpoint (CORE_ADDR addr, int len, int type);
+extern int i386_page_remove_watchpoint (CORE_ADDR addr, int len, int type);
+extern int i386_page_stopped_data_address (CORE_ADDR *);
+extern int i386_page_stopped_by_watchpoint (void);
+
+#undef TARGET_REGION_OK_FOR_HW_WATCHPOINT
+#define TARGET_REGION_OK_FOR_HW_WATCHPOINT(addr, len) \
+  i386_page_region_ok_for_watchpoint (addr, len, hw_write)
+
+/* Only write watchpoints can fall back on page protection.  */
+#define TARGET_REGION_OK_FOR_HW_WATCHPOINT_TYPE(addr, len, type) \
+  i386_page_region_ok_for_watchpoint (addr, len, type)
+
+#undef STOPPED_BY_WATCHPOINT
+#define STOPPED_BY_WATCHPOINT(W) (i386_page_stopped_by_watchpoint () != 0)
+
+#undef target_stopped_data_address
+#define target_stopped_data_address(target, x) \
+  i386_page_stopped_data_address (x)
+
+#undef target_insert_watchpoint
+#define target_insert_watchpoint(addr, len, type) \
+  i386_page_insert_watchpoint (addr, len, type)
+
+#undef target_remove_watchpoint
+#define target_remove_watchpoint(addr, len, type) \
+  i386_page_remove_watchpoint (addr, len, type)
+
+#endif /* I386_USE_PAGE_WATCHPOINTS */
+/* APPLE LOCAL end page watchpoints */
+
 #endif /* I386_USE_GENERIC_WATCHPOINTS */
 
 #endif /* NM_I386_H */
@@ -26,6 +26,11 @@
 
 /* GNU/Linux supports the i386 hardware debugging registers.  */
 #define I386_USE_GENERIC_WATCHPOINTS
+/* APPLE LOCAL begin page watchpoints */
+/* Watch for writes the debug registers can't hold by protecting
+   pages.  */
+#define I386_USE_PAGE_WATCHPOINTS
+/* APPLE LOCAL end page watchpoints */
 
 #include "i386/nm-i386.h"
 #include "config/nm-linux.h"
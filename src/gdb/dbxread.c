@@ -48,6 +48,8 @@ static int end_fun_absolute_p = 0;
 
 #include "gdb_obstack.h"
 #include "gdb_stat.h"
+/* APPLE LOCAL oso prefetch */
+#include <fcntl.h>
 #include "symtab.h"
 #include "breakpoint.h"
 /* APPLE LOCAL headers */
@@ -72,6 +74,8 @@ static int end_fun_absolute_p = 0;
 
 #include "gdb_assert.h"
 #include "gdb_string.h"
+/* APPLE LOCAL containing archive cache */
+#include "hashtab.h"
 
 #include "aout/aout64.h"
 #include "aout/stab_gnu.h"	/* We always use GNU stabs, not native, now */
@@ -288,6 +292,9 @@ static void read_dbx_dynamic_symtab (struct objfile *objfile);
 /* APPLE LOCAL add argument */
 static void read_dbx_symtab (struct objfile *, int);
 
+/* APPLE LOCAL map dbx symtab */
+static void map_dbx_symtab (struct objfile *, file_ptr, int);
+
 static void free_bincl_list (struct objfile *);
 
 static struct partial_symtab *find_corresponding_bincl_psymtab (char *, int);
@@ -709,6 +716,10 @@ dbx_symfile_read (struct objfile *objfile, int mainline)
   make_cleanup_discard_minimal_symbols ();
 #endif
 
+  /* APPLE LOCAL: Map the whole symbol table rather than reading it
+     through symbuf a chunk at a time.  */
+  map_dbx_symtab (objfile, dbx_symtab_offset, dbx_symtab_count);
+
   /* Read stabs data from executable file and define symbols. */
 
   read_dbx_symtab (objfile, dbx_symtab_count);
@@ -1024,6 +1035,65 @@ stabs_seek (int sym_offset)
     bfd_seek (processing_objfile->obfd, sym_offset, SEEK_CUR);
 }
 
+/* APPLE LOCAL begin map dbx symtab */
+/* Undo map_dbx_symtab.  */
+
+static void
+unmap_dbx_symtab (void *arg)
+{
+  bfd_window *window = (bfd_window *) arg;
+
+  bfd_free_window (window);
+  xfree (window);
+  stabs_data = NULL;
+}
+
+/* Point stabs_data at the COUNT symbols at OFFSET in OBJFILE's
+   symbol file, so that read_dbx_symtab indexes them directly instead
+   of copying them into symbuf with a bfd_bread for every few thousand
+   symbols.  The symbols are used where they are if the bfd is in
+   memory, and mapped if it is a file the BFD cache opens.  Other
+   bfds, such as the iovec ones made for images in the inferior's
+   memory, can't be mapped.  Without mmap, bfd_get_file_window would
+   malloc and read the whole symbol table, which may be tens of
+   megabytes, so we leave the file to the usual chunked reads then.
+   Nothing happens if the symbols can't be mapped.  The mapping is
+   undone by the cleanups.  */
+
+static void
+map_dbx_symtab (struct objfile *objfile, file_ptr offset, int count)
+{
+  bfd *abfd = objfile->obfd;
+  bfd_window *window;
+
+  if (stabs_data != NULL || symbuf_sections != NULL || count <= 0)
+    return;
+  if ((abfd->flags & BFD_IN_MEMORY) == 0)
+    {
+#ifndef HAVE_MMAP
+      return;
+#else
+      if (!bfd_cache_file_p (abfd))
+	return;
+#endif
+    }
+
+  window = (bfd_window *) xmalloc (sizeof (bfd_window));
+  bfd_init_window (window);
+  if (!bfd_get_file_window (abfd, offset,
+			    (bfd_size_type) count * DBX_SYMBOL_SIZE (objfile),
+			    window, 0))
+    {
+      bfd_free_window (window);
+      xfree (window);
+      return;
+    }
+
+  stabs_data = window->data;
+  make_cleanup (unmap_dbx_symtab, window);
+}
+/* APPLE LOCAL end map dbx symtab */
+
 /* APPLE LOCAL: We added INTERNALIZE SYMBOL because the nlist data gdb
    uses is different from what is in include/aout/stabs.def.  This
    function allows us to fix up the nlist entries so gdb will be happy
@@ -1105,8 +1175,11 @@ dbx_next_symbol_text (struct objfile *objfile)
 	 non-stab into its place; then return the stab, effectively
 	 swapping the two entries. */
 
-      memcpy (symbuf + ((symbuf_idx + 0) * symbol_size),
-	      symbuf + ((symbuf_idx + 1) * symbol_size), symbol_size);
+      /* APPLE LOCAL: stabs_data may be a read-only mapping, and
+	 symbuf_idx indexes it rather than symbuf.  */
+      if (stabs_data == NULL)
+	memcpy (symbuf + ((symbuf_idx + 0) * symbol_size),
+		symbuf + ((symbuf_idx + 1) * symbol_size), symbol_size);
       
       /* Now increment the various pointers as we normally would. */
       symbuf_idx++;
@@ -2278,6 +2351,8 @@ read_dbx_symtab (struct objfile *objfile, int dbx_symcount)
                                     strlen (namestring),
                                     &objfile->objfile_obstack);
             PSYMTAB_OSO_MTIME (pst) = (long) nlist.n_value;
+            /* APPLE LOCAL oso prefetch */
+            objfile->flags |= OBJF_DEBUG_MAP;
 
             /* Next, check to see if this is the symbol sep file... */
             if (strstr (namestring, ".gch.o") != NULL)
@@ -3286,68 +3361,173 @@ close_bfd_or_archive (bfd *abfd)
 
 /* For DWARF files with debug info in .o files, we scan all the .o's for type
    symbols in the "pubtypes" section.  If the debug info is from an archive file
-   we'll end up opening & closing that .a file MANY times.  So this array stores
+   we'll end up opening & closing that .a file MANY times.  So this table stores
    the a cache of the archives .a files that we've opened.  
    The use pattern should be that whenever you use find_bfd_from_oso, if CACHED is
    returned true, then don't close the bfd you were looking at, but rather when you're
    all done with the objfile you were looking in, call clear_containing_archive_cache.
-*/
-  
-#define PUBTYPE_ARCHIVES_CHUNK 10
-static struct bfd **pubtype_bfd_array;
-static int num_archives_for_pubtypes;
-static int max_num_archives_for_pubtypes;
 
-static bfd *
-find_in_containing_archive_cache (char *archive_name)
+   APPLE LOCAL: Static libraries can have thousands of members, and
+   an executable can reference thousands of them, so both the archives
+   and the members within each archive are looked up by hash.  The
+   member index is built by walking the archive once, the first time
+   a member is asked for.  */
+
+struct oso_archive
 {
-  int i;
-  for (i = 0; i < num_archives_for_pubtypes; i++)
-    {
-      if (strcmp (archive_name, pubtype_bfd_array[i]->filename) == 0)
-	{
-	  return pubtype_bfd_array[i];
-	}
-    }
-  return NULL;
+  /* The archive name, as it appears in the OSO string.  This is
+     owned by ARCHIVE, which uses it as its filename.  */
+  char *name;
+
+  /* The BFD we opened for NAME.  Closing it closes everything we
+     opened below it.  */
+  bfd *archive;
+
+  /* The archive to look for members in: ARCHIVE itself, or its fork
+     for the current architecture if ARCHIVE is a fat file.  NULL if
+     we haven't looked yet.  */
+  bfd *members_archive;
+
+  /* Set if NAME turned out not to be usable as an archive, so we
+     don't keep retrying (and warning) for each of its members.  */
+  int bad;
+
+  /* Maps a member name to the member's BFD.  NULL until the first
+     member lookup.  */
+  htab_t members;
+
+  struct oso_archive *next;
+};
+
+static htab_t oso_archive_table;
+static struct oso_archive *oso_archive_list;
+
+static hashval_t
+hash_oso_archive (const void *p)
+{
+  const struct oso_archive *entry = p;
+  return htab_hash_string (entry->name);
+}
+
+static int
+eq_oso_archive (const void *p, const void *name)
+{
+  const struct oso_archive *entry = p;
+  return strcmp (entry->name, name) == 0;
 }
 
-/* Adds CONTAINING_ARCHIVE to the archive cache.  */
+static hashval_t
+hash_oso_archive_member (const void *p)
+{
+  const bfd *member = p;
+  return htab_hash_string (member->filename);
+}
 
-static void
-add_to_containing_archive_cache (bfd *containing_archive)
+static int
+eq_oso_archive_member (const void *p, const void *name)
 {
-  
-  int i;
+  const bfd *member = p;
+  return strcmp (member->filename, name) == 0;
+}
 
-  /* This is a fast check, and if somebody inadvertently adds
-     the same bfd twice, we'll crash when we go to clear the
-     cache, it's worth doing it here.  */
+static struct oso_archive *
+find_in_containing_archive_cache (char *archive_name)
+{
+  if (oso_archive_table == NULL)
+    return NULL;
+  return htab_find_with_hash (oso_archive_table, archive_name,
+			      htab_hash_string (archive_name));
+}
 
-  for (i = 0; i < num_archives_for_pubtypes; i++)
-    if (pubtype_bfd_array[i] == containing_archive)
-      return;
+/* Adds CONTAINING_ARCHIVE, opened on ARCHIVE_NAME, to the archive
+   cache, and returns its cache entry.  */
+
+static struct oso_archive *
+add_to_containing_archive_cache (char *archive_name, bfd *containing_archive)
+{
+  struct oso_archive *entry;
+  void **slot;
+
+  if (oso_archive_table == NULL)
+    oso_archive_table = htab_create_alloc (16, hash_oso_archive,
+					   eq_oso_archive, NULL,
+					   xcalloc, xfree);
+
+  slot = htab_find_slot_with_hash (oso_archive_table, archive_name,
+				   htab_hash_string (archive_name), INSERT);
+
+  /* If somebody inadvertently adds the same archive twice, we'd
+     crash when we go to clear the cache, so hand back the entry we
+     already have.  */
+  if (*slot != NULL)
+    return *slot;
+
+  entry = xzalloc (sizeof (struct oso_archive));
+  entry->name = archive_name;
+  entry->archive = containing_archive;
+  entry->next = oso_archive_list;
+  oso_archive_list = entry;
+  *slot = entry;
+
+  return entry;
+}
 
-  if (num_archives_for_pubtypes == max_num_archives_for_pubtypes)
+/* Return the BFD for the member of ENTRY's archive called
+   MEMBER_NAME, or NULL if there is no such member.  The first call
+   for an archive walks all of its members to build the index; if a
+   name occurs more than once, the first member wins, as it always
+   has.  */
+
+static bfd *
+find_containing_archive_member (struct oso_archive *entry, char *member_name)
+{
+  if (entry->members == NULL)
     {
-      max_num_archives_for_pubtypes += PUBTYPE_ARCHIVES_CHUNK;
-      pubtype_bfd_array 
-	= xrealloc (pubtype_bfd_array, 
-		    max_num_archives_for_pubtypes * sizeof (struct bfd *)); 
+      bfd *member_bfd;
+
+      entry->members = htab_create_alloc (64, hash_oso_archive_member,
+					  eq_oso_archive_member, NULL,
+					  xcalloc, xfree);
+
+      for (member_bfd = bfd_openr_next_archived_file (entry->members_archive,
+						      NULL);
+	   member_bfd != NULL;
+	   member_bfd = bfd_openr_next_archived_file (entry->members_archive,
+						      member_bfd))
+	{
+	  void **slot;
+
+	  slot = htab_find_slot_with_hash (entry->members,
+					   member_bfd->filename,
+					   htab_hash_string (member_bfd->filename),
+					   INSERT);
+	  if (*slot == NULL)
+	    *slot = member_bfd;
+	}
     }
 
-  pubtype_bfd_array[num_archives_for_pubtypes++]
-    = containing_archive;
+  return htab_find_with_hash (entry->members, member_name,
+			      htab_hash_string (member_name));
 }
 
 void
 clear_containing_archive_cache ()
 {
-  while (num_archives_for_pubtypes > 0)
+  while (oso_archive_list != NULL)
+    {
+      struct oso_archive *entry = oso_archive_list;
+      oso_archive_list = entry->next;
+
+      if (entry->members != NULL)
+	htab_delete (entry->members);
+      close_containing_archive_and_contents (entry->archive);
+      xfree (entry);
+    }
+
+  if (oso_archive_table != NULL)
     {
-      struct bfd *archive = pubtype_bfd_array[--num_archives_for_pubtypes];
-      pubtype_bfd_array[num_archives_for_pubtypes] = NULL;
-      close_containing_archive_and_contents (archive);
+      htab_delete (oso_archive_table);
+      oso_archive_table = NULL;
     }
 }
 
@@ -3415,14 +3595,16 @@ open_bfd_from_oso (struct partial_symtab *pst, int *cached)
   else
     {
       struct bfd *archive_bfd, *member_bfd;
+      /* APPLE LOCAL */
+      struct oso_archive *entry;
       struct stat member_statbuf;
       int status;
       struct cleanup *free_archive_name, *free_member_name;
       free_member_name = make_cleanup (xfree, member_name);
       free_archive_name = make_cleanup (xfree, archive_name);
 
-      archive_bfd = find_in_containing_archive_cache (archive_name);
-      if (archive_bfd == NULL)
+      entry = find_in_containing_archive_cache (archive_name);
+      if (entry == NULL)
 	{
 	  archive_bfd = bfd_openr (archive_name, gnutarget);
 	  if (archive_bfd == NULL)
@@ -3431,66 +3613,76 @@ open_bfd_from_oso (struct partial_symtab *pst, int *cached)
 	      retval = NULL;
 	      goto do_cleanups;
 	    }
-	  add_to_containing_archive_cache (archive_bfd);
+	  entry = add_to_containing_archive_cache (archive_name, archive_bfd);
+
+	  /* If we got here, the archive_bfd archive_name now belongs to the 
+	     archive, so we can't free it.  */
+
+	  discard_cleanups (free_archive_name);
 	}
       *cached = 1;
 
-      /* If we got here, the archive_bfd archive_name now belongs to the 
-         archive, so we can't free it.  */
-
-      discard_cleanups (free_archive_name);
-      if (!bfd_check_format (archive_bfd, bfd_archive))
+      if (entry->bad)
 	{
-	  warning ("OSO archive file \"%s\" not an archive.",archive_name);
 	  retval = NULL;
 	  goto do_cleanups;
 	}
 
-      if (strcmp (archive_bfd->xvec->name, "mach-o-fat") == 0)
+      if (entry->members_archive == NULL)
 	{
-	  /* GRRR...  Archives of type mach-o-fat are fat files, not 
-	     .a files.  So look for the .a file matching the current'
-	     architecture.  */
-	  archive_bfd = open_bfd_matching_arch (archive_bfd, bfd_archive);
+	  archive_bfd = entry->archive;
+	  entry->bad = 1;
 
-	  if (archive_bfd == NULL)
+	  if (!bfd_check_format (archive_bfd, bfd_archive))
 	    {
-	      warning ("Could not open fork matching current "
-		       "architecture for OSO archive \"%s\"",
-		       archive_name);
+	      warning ("OSO archive file \"%s\" not an archive.",archive_name);
 	      retval = NULL;
 	      goto do_cleanups;
 	    }
-	  if (!bfd_check_format (archive_bfd, bfd_archive))
+
+	  if (strcmp (archive_bfd->xvec->name, "mach-o-fat") == 0)
+	    {
+	      /* GRRR...  Archives of type mach-o-fat are fat files, not 
+		 .a files.  So look for the .a file matching the current'
+		 architecture.  */
+	      archive_bfd = open_bfd_matching_arch (archive_bfd, bfd_archive);
+
+	      if (archive_bfd == NULL)
+		{
+		  warning ("Could not open fork matching current "
+			   "architecture for OSO archive \"%s\"",
+			   archive_name);
+		  retval = NULL;
+		  goto do_cleanups;
+		}
+	      if (!bfd_check_format (archive_bfd, bfd_archive))
+		{
+		  warning ("Current architecture fork of OSO archive "
+			   "file \"%s\" not an archive", archive_name);
+		  retval = NULL;
+		  goto do_cleanups;
+		}
+	    }
+
+	  if (bfd_openr_next_archived_file (archive_bfd, NULL) == NULL)
 	    {
-	      warning ("Current architecture fork of OSO archive "
-		       "file \"%s\" not an archive", archive_name);
+	      warning ("Could not read archive members out of OSO archive \"%s\"",
+		       archive_name);
 	      retval = NULL;
 	      goto do_cleanups;
 	    }
-	}
 
-      member_bfd = bfd_openr_next_archived_file (archive_bfd, NULL);
-
-      if (member_bfd == NULL)
-	{
-	  warning ("Could not read archive members out of OSO archive \"%s\"",
-		   archive_name);
-	  retval = NULL;
-	  goto do_cleanups;
+	  entry->members_archive = archive_bfd;
+	  entry->bad = 0;
 	}
 
-      while (member_bfd != NULL)
-	{
-	  if (strcmp (member_bfd->filename, member_name) == 0)
-	    break;
-          member_bfd = bfd_openr_next_archived_file (archive_bfd, member_bfd);
-	}
+      member_bfd = find_containing_archive_member (entry, member_name);
       if (member_bfd == NULL)
 	{
 	  warning ("Could not find specified archive member for OSO name \"%s\"",
 		   oso_name);
-	  return NULL;
+	  retval = NULL;
+	  goto do_cleanups;
 	}
 
       retval = member_bfd;
@@ -3524,6 +3716,65 @@ open_bfd_from_oso (struct partial_symtab *pst, int *cached)
 }
 /* END APPLE LOCAL */
 
+/* APPLE LOCAL begin oso prefetch */
+/* Return non-zero if any objfile gets its debug info through a debug
+   map, so that there are OSO files worth prefetching.  */
+
+int
+oso_objfiles_present (void)
+{
+  struct objfile *objfile;
+
+  ALL_OBJFILES (objfile)
+    if (objfile->flags & OBJF_DEBUG_MAP)
+      return 1;
+  return 0;
+}
+
+/* Tell the kernel that we are about to read the OSO object file for
+   PST, so that it can start reading it in while we are busy with
+   something else - typically expanding the psymtab of another frame
+   in a backtrace.  This only issues read-ahead advice; nothing is
+   read, and no BFD state is touched.  Archive members are skipped:
+   we don't know where in the archive the member lives without
+   reading the archive itself.  */
+
+void
+oso_prefetch_psymtab (struct partial_symtab *pst)
+{
+  char *oso_name;
+  int fd;
+
+  if (pst == NULL || pst->readin)
+    return;
+  oso_name = PSYMTAB_OSO_NAME (pst);
+  if (oso_name == NULL || parse_archive_name (oso_name, NULL, NULL))
+    return;
+
+  fd = open (oso_name, O_RDONLY);
+  if (fd < 0)
+    return;
+
+#if defined (POSIX_FADV_WILLNEED)
+  posix_fadvise (fd, 0, 0, POSIX_FADV_WILLNEED);
+#elif defined (F_RDADVISE)
+  {
+    struct stat sb;
+    struct radvisory ra;
+
+    if (fstat (fd, &sb) == 0 && sb.st_size > 0)
+      {
+	ra.ra_offset = 0;
+	ra.ra_count = sb.st_size > INT_MAX ? INT_MAX : (int) sb.st_size;
+	fcntl (fd, F_RDADVISE, &ra);
+      }
+  }
+#endif
+
+  close (fd);
+}
+/* APPLE LOCAL end oso prefetch */
+
 /* APPLE LOCAL: Scan the .o containing PST to build up the "dependencies"
    array for all the pst's contained in this .o file.  We also set the sym offset
    while we are at it, so we can find the separate .o's again more efficiently.  */
@@ -5906,6 +6157,8 @@ static struct sym_fns aout_sym_fns =
   dbx_symfile_read,		/* sym_read: read a symbol file into symtab */
   dbx_symfile_finish,		/* sym_finish: finished with file, cleanup */
   default_symfile_offsets,	/* sym_offsets: parse user's offsets to internal form */
+  /* APPLE LOCAL deferred solib symbols */
+  NULL,				/* sym_read_psymtabs: no separate debug info pass */
   NULL				/* next: pointer to next struct sym_fns */
 };
 
@@ -474,6 +474,55 @@ dwarf2_loc_desc_needs_frame (gdb_byte *data, unsigned short size)
   return baton.needs_frame || in_reg;
 }
 
+/* APPLE LOCAL begin compiled breakpoint conditions */
+/* Return the frame base (DW_AT_frame_base) of the function FRAME is
+   running, which DW_OP_fbreg locations are relative to.  This is how
+   ax_eval implements aop_frame_base.  */
+
+CORE_ADDR
+dwarf2_frame_base_address (struct frame_info *frame)
+{
+  struct dwarf_expr_baton baton;
+  struct dwarf_expr_context *ctx;
+  struct symbol *framefunc;
+  gdb_byte *data;
+  size_t size;
+  CORE_ADDR base;
+
+  framefunc = get_frame_function (frame);
+  if (framefunc == NULL)
+    error (_("Could not find the function of the selected frame."));
+  if (SYMBOL_OPS (framefunc) == &dwarf2_loclist_funcs)
+    baton.objfile = ((struct dwarf2_loclist_baton *)
+		     SYMBOL_LOCATION_BATON (framefunc))->objfile;
+  else if (SYMBOL_OPS (framefunc) == &dwarf2_locexpr_funcs)
+    baton.objfile = ((struct dwarf2_locexpr_baton *)
+		     SYMBOL_LOCATION_BATON (framefunc))->objfile;
+  else
+    error (_("\"%s\" has no DWARF frame base."),
+	   SYMBOL_PRINT_NAME (framefunc));
+  baton.frame = frame;
+
+  dwarf_expr_frame_base (&baton, &data, &size);
+
+  ctx = new_dwarf_expr_context ();
+  ctx->baton = &baton;
+  ctx->read_reg = dwarf_expr_read_reg;
+  ctx->read_mem = dwarf_expr_read_mem;
+  ctx->get_frame_base = dwarf_expr_frame_base;
+  ctx->get_tls_address = dwarf_expr_tls_address;
+
+  dwarf_expr_eval (ctx, data, size, 0);
+  base = dwarf_expr_fetch (ctx, 0);
+  if (ctx->in_reg)
+    base = dwarf_expr_read_reg (&baton, base);
+
+  free_dwarf_expr_context (ctx);
+
+  return base;
+}
+/* APPLE LOCAL end compiled breakpoint conditions */
+
 static void
 dwarf2_tracepoint_var_ref (struct symbol *symbol, struct agent_expr *ax,
 			   struct axs_value *value, gdb_byte *data,
@@ -488,14 +537,16 @@ dwarf2_tracepoint_var_ref (struct symbol *symbol, struct agent_expr *ax,
       && data[0] <= DW_OP_reg31)
     {
       value->kind = axs_lvalue_register;
-      value->u.reg = data[0] - DW_OP_reg0;
+      /* APPLE LOCAL compiled breakpoint conditions */
+      value->u.reg = DWARF2_REG_TO_REGNUM (data[0] - DW_OP_reg0);
     }
   else if (data[0] == DW_OP_regx)
     {
       ULONGEST reg;
       read_uleb128 (data + 1, data + size, &reg);
       value->kind = axs_lvalue_register;
-      value->u.reg = reg;
+      /* APPLE LOCAL compiled breakpoint conditions */
+      value->u.reg = DWARF2_REG_TO_REGNUM (reg);
     }
   else if (data[0] == DW_OP_fbreg)
     {
@@ -510,6 +561,20 @@ dwarf2_tracepoint_var_ref (struct symbol *symbol, struct agent_expr *ax,
 	error (_("Unexpected opcode after DW_OP_fbreg for symbol \"%s\"."),
 	       SYMBOL_PRINT_NAME (symbol));
 
+      /* APPLE LOCAL begin compiled breakpoint conditions */
+      /* The virtual frame pointer is only a guess at the frame base.
+	 GDB can find the real one when it evaluates the expression
+	 itself.  */
+      if (ax->host)
+	{
+	  ax_simple (ax, aop_frame_base);
+	  ax_const_l (ax, frame_offset);
+	  ax_simple (ax, aop_add);
+	  value->kind = axs_lvalue_memory;
+	  return;
+	}
+      /* APPLE LOCAL end compiled breakpoint conditions */
+
       TARGET_VIRTUAL_FRAME_POINTER (ax->scope, &frame_reg, &frame_offset);
       ax_reg (ax, frame_reg);
       ax_const_l (ax, frame_offset);
@@ -81,4 +81,11 @@ struct dwarf2_loclist_baton
 extern const struct symbol_ops dwarf2_locexpr_funcs;
 extern const struct symbol_ops dwarf2_loclist_funcs;
 
+/* APPLE LOCAL begin compiled breakpoint conditions */
+struct frame_info;
+
+/* Return the DW_AT_frame_base of the function FRAME is running.  */
+extern CORE_ADDR dwarf2_frame_base_address (struct frame_info *frame);
+/* APPLE LOCAL end compiled breakpoint conditions */
+
 #endif /* dwarf2loc.h */
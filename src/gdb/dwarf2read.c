@@ -862,6 +862,40 @@ The upper bound on the age of cached dwarf2 compilation units is %s.\n"),
 		    value);
 }
 
+/* APPLE LOCAL begin lazy function bodies  */
+/* When set, reading the full symbols of a compilation unit only makes
+   the blocks of its top-level functions; a function's parameters,
+   locals and lexical blocks are read from its DIE the first time the
+   block's symbols are used.  See dwarf2_lazy_function_p for which
+   functions qualify.  */
+static int dwarf2_lazy_function_bodies = 0;
+static void
+show_dwarf2_lazy_function_bodies (struct ui_file *file, int from_tty,
+				  struct cmd_list_element *c,
+				  const char *value)
+{
+  fprintf_filtered (file, _("\
+Lazy reading of dwarf2 function bodies is %s.\n"),
+		    value);
+}
+
+/* What a function block whose body was skipped needs to read the body
+   in later.  Allocated on the objfile's obstack; LAZY.DATA points back
+   to this.  */
+struct dwarf2_lazy_body
+{
+  struct block_lazy lazy;
+  struct objfile *objfile;
+  struct dwarf2_per_cu_data *per_cu;
+
+  /* Offset of the DW_TAG_subprogram DIE.  */
+  unsigned int offset;
+
+  /* processing_current_prefix when the function was read.  */
+  const char *prefix;
+};
+/* APPLE LOCAL end lazy function bodies  */
+
 /* APPLE LOCAL: A way to find out what how the DWARF debug map is translating
    addresses.  Results in a lot of output.  */
 static int debug_debugmap = 0;
@@ -1097,6 +1131,14 @@ static void read_file_scope (struct die_info *, struct dwarf2_cu *);
 
 static void read_func_scope (struct die_info *, struct dwarf2_cu *);
 
+/* APPLE LOCAL begin lazy function bodies  */
+static int dwarf2_lazy_function_p (struct die_info *, struct dwarf2_cu *);
+
+static void dwarf2_defer_function_body (struct block *, struct die_info *,
+					struct dwarf2_cu *);
+/* APPLE LOCAL end lazy function bodies  */
+
+
 static void read_lexical_block_scope (struct die_info *, struct dwarf2_cu *);
 
 /* APPLE LOCAL begin address ranges  */
@@ -4248,6 +4290,24 @@ dwarf2_kext_psymtab_to_symtab (struct partial_symtab *pst)
    The address translation map is not freed at the end -- there may be pointers
    to it in location list expressions so we'll need to keep it around.  */
 
+/* APPLE LOCAL begin debug map */
+/* The number of dwarf2_debug_map_psymtab_to_symtab calls in progress.
+   The dependencies of a debug map psymtab come from the same .o as
+   the psymtab itself, so when that .o is an archive member we leave
+   the containing archive open until the outermost call is done
+   instead of closing and reopening it - and walking its members
+   again - for every dependency.  */
+
+static int debug_map_expansion_depth;
+
+static void
+do_debug_map_expansion_depth_cleanup (void *ignore)
+{
+  if (--debug_map_expansion_depth == 0)
+    clear_containing_archive_cache ();
+}
+/* APPLE LOCAL end debug map */
+
 void 
 dwarf2_debug_map_psymtab_to_symtab (struct partial_symtab *pst)
 {
@@ -4261,6 +4321,13 @@ dwarf2_debug_map_psymtab_to_symtab (struct partial_symtab *pst)
   struct dwarf2_per_cu_data *this_cu;
   int bytes_read;
   int i;
+  /* APPLE LOCAL debug map */
+  struct cleanup *depth_cleanup;
+
+  /* APPLE LOCAL begin debug map */
+  debug_map_expansion_depth++;
+  depth_cleanup = make_cleanup (do_debug_map_expansion_depth_cleanup, NULL);
+  /* APPLE LOCAL end debug map */
 
   for (i = 0; i < pst->number_of_dependencies; i++)
     if (!pst->dependencies[i]->readin)
@@ -4281,7 +4348,11 @@ dwarf2_debug_map_psymtab_to_symtab (struct partial_symtab *pst)
       }
 
   if (PSYMTAB_OSO_NAME (pst) == NULL || pst->readin)
-    return;
+    {
+      /* APPLE LOCAL debug map */
+      do_cleanups (depth_cleanup);
+      return;
+    }
 
    if (info_verbose)
      {
@@ -4296,6 +4367,8 @@ dwarf2_debug_map_psymtab_to_symtab (struct partial_symtab *pst)
       if (pst->objfile->separate_debug_objfile != NULL)
         {
           pst->readin = 1;
+	  /* APPLE LOCAL debug map */
+	  do_cleanups (depth_cleanup);
           return;
         }
       else
@@ -4303,6 +4376,8 @@ dwarf2_debug_map_psymtab_to_symtab (struct partial_symtab *pst)
 	  /* Otherwise, warn, say we've read it in, and return.  */
 	  warning ("Couldn't open object file '%s'", PSYMTAB_OSO_NAME (pst));
 	  pst->readin = 1;
+	  /* APPLE LOCAL debug map */
+	  do_cleanups (depth_cleanup);
 	  return;
 	}
     }
@@ -4339,15 +4414,18 @@ dwarf2_debug_map_psymtab_to_symtab (struct partial_symtab *pst)
 
   process_full_comp_unit (this_cu);
 
-  if (cached)
-    clear_containing_archive_cache ();
-  else
+  /* APPLE LOCAL debug map: A cached archive member is closed along
+     with its archive once the outermost expansion is done.  */
+  if (!cached)
     close_bfd_or_archive (oso_bfd);
 
   pst->readin = 1;
   /* Finish up the debug error message.  */
   if (info_verbose)
     printf_filtered (_("done.\n"));
+
+  /* APPLE LOCAL debug map */
+  do_cleanups (depth_cleanup);
 }
 
 char *
@@ -4649,32 +4727,14 @@ fix_inlined_subroutine_symbols (void)
 }
 /* APPLE LOCAL end inlined function symbols & blocks  */
 
-/* Generate full symbol information for PST and CU, whose DIEs have
-   already been loaded into memory.  */
+/* APPLE LOCAL begin lazy function bodies: Split out of
+   process_full_comp_unit.  */
+/* Set the base address of CU, whose DIEs have been loaded.  */
 
 static void
-process_full_comp_unit (struct dwarf2_per_cu_data *per_cu)
+dwarf2_set_cu_base_address (struct dwarf2_cu *cu)
 {
-  struct partial_symtab *pst = per_cu->psymtab;
-  struct dwarf2_cu *cu = per_cu->cu;
-  struct objfile *objfile = pst->objfile;
-  /* APPLE LOCAL avoid unused var warning.  */
-  /* bfd *abfd = objfile->obfd; */
-  CORE_ADDR lowpc, highpc;
-  struct symtab *symtab;
-  struct cleanup *back_to;
   struct attribute *attr;
-  CORE_ADDR baseaddr;
-
-  baseaddr = objfile_text_section_offset (objfile);
-
-  /* We're in the global namespace.  */
-  processing_current_prefix = "";
-
-  buildsym_init ();
-  back_to = make_cleanup (really_free_pendings, NULL);
-
-  cu->list_in_scope = &file_symbols;
 
   /* Find the base address of the compilation unit for range lists and
      location lists.  It will normally be specified by DW_AT_low_pc.
@@ -4713,6 +4773,37 @@ process_full_comp_unit (struct dwarf2_per_cu_data *per_cu)
       cu->header.base_address_untranslated = cu->per_cu->psymtab->textlow;
       cu->header.base_known = 1;
     }
+}
+/* APPLE LOCAL end lazy function bodies  */
+
+/* Generate full symbol information for PST and CU, whose DIEs have
+   already been loaded into memory.  */
+
+static void
+process_full_comp_unit (struct dwarf2_per_cu_data *per_cu)
+{
+  struct partial_symtab *pst = per_cu->psymtab;
+  struct dwarf2_cu *cu = per_cu->cu;
+  struct objfile *objfile = pst->objfile;
+  /* APPLE LOCAL avoid unused var warning.  */
+  /* bfd *abfd = objfile->obfd; */
+  CORE_ADDR lowpc, highpc;
+  struct symtab *symtab;
+  struct cleanup *back_to;
+  CORE_ADDR baseaddr;
+
+  baseaddr = objfile_text_section_offset (objfile);
+
+  /* We're in the global namespace.  */
+  processing_current_prefix = "";
+
+  buildsym_init ();
+  back_to = make_cleanup (really_free_pendings, NULL);
+
+  cu->list_in_scope = &file_symbols;
+
+  /* APPLE LOCAL lazy function bodies  */
+  dwarf2_set_cu_base_address (cu);
 
   /* Do line number decoding in read_file_scope () */
   /* APPLE LOCAL begin inlined function symbols & blocks  */
@@ -5255,6 +5346,8 @@ read_func_scope (struct die_info *die, struct dwarf2_cu *cu)
   /* APPLE LOCAL begin address ranges  */
   struct address_range_list *ranges = NULL;
   /* APPLE LOCAL end address ranges  */
+  /* APPLE LOCAL lazy function bodies  */
+  int lazy_body;
 
   baseaddr = objfile_text_section_offset (objfile);
 
@@ -5322,6 +5415,9 @@ read_func_scope (struct die_info *die, struct dwarf2_cu *cu)
   /* Record the function range for dwarf_decode_lines.  */
   add_to_cu_func_list (name, lowpc, highpc, cu);
 
+  /* APPLE LOCAL lazy function bodies  */
+  lazy_body = dwarf2_lazy_function_p (die, cu);
+
   new = push_context (0, lowpc);
   new->name = new_symbol (die, die->type, cu);
 
@@ -5342,7 +5438,8 @@ read_func_scope (struct die_info *die, struct dwarf2_cu *cu)
 
   cu->list_in_scope = &local_symbols;
 
-  if (die->child != NULL)
+  /* APPLE LOCAL lazy function bodies  */
+  if (die->child != NULL && !lazy_body)
     {
       child_die = die->child;
       while (child_die && child_die->tag)
@@ -5358,6 +5455,10 @@ read_func_scope (struct die_info *die, struct dwarf2_cu *cu)
   finish_block (new->name, &local_symbols, new->old_blocks,
 		lowpc, highpc, ranges, objfile);
   /* APPLE LOCAL end address ranges  */
+
+  /* APPLE LOCAL lazy function bodies  */
+  if (lazy_body)
+    dwarf2_defer_function_body (SYMBOL_BLOCK_VALUE (new->name), die, cu);
   
   /* In C++, we can have functions nested inside functions (e.g., when
      a function declares a class that has methods).  This means that
@@ -5376,6 +5477,223 @@ read_func_scope (struct die_info *die, struct dwarf2_cu *cu)
     do_cleanups (back_to);
 }
 
+/* APPLE LOCAL begin lazy function bodies  */
+/* Return non-zero if reading the children of DIE, a function body or
+   a scope within one, only makes symbols in the local scope and
+   lexical blocks.  Anything that can add to the global or static
+   blocks, make more functions or record line numbers rules this
+   out.  */
+
+static int
+dwarf2_lazy_body_p (struct die_info *die, struct dwarf2_cu *cu)
+{
+  struct die_info *child_die, *member_die;
+  struct attribute *attr;
+
+  for (child_die = die->child;
+       child_die != NULL && child_die->tag;
+       child_die = sibling_die (child_die))
+    switch (child_die->tag)
+      {
+      case DW_TAG_formal_parameter:
+      case DW_TAG_unspecified_parameters:
+      case DW_TAG_label:
+      case DW_TAG_subroutine_type:
+      case DW_TAG_array_type:
+      case DW_TAG_pointer_type:
+      case DW_TAG_reference_type:
+      case DW_TAG_const_type:
+      case DW_TAG_volatile_type:
+	break;
+      case DW_TAG_variable:
+	attr = dwarf2_attr (child_die, DW_AT_external, cu);
+	if (attr && DW_UNSND (attr) != 0)
+	  return 0;
+	break;
+      case DW_TAG_lexical_block:
+      case DW_TAG_try_block:
+      case DW_TAG_catch_block:
+	if (!dwarf2_lazy_body_p (child_die, cu))
+	  return 0;
+	break;
+      case DW_TAG_class_type:
+      case DW_TAG_structure_type:
+      case DW_TAG_union_type:
+      case DW_TAG_enumeration_type:
+	/* process_structure_scope reads anything but the data members
+	   with process_die.  */
+	for (member_die = child_die->child;
+	     member_die != NULL && member_die->tag;
+	     member_die = sibling_die (member_die))
+	  if (member_die->tag != DW_TAG_member
+	      && member_die->tag != DW_TAG_inheritance
+	      && member_die->tag != DW_TAG_enumerator)
+	    return 0;
+	break;
+      default:
+	return 0;
+      }
+
+  return 1;
+}
+
+/* Return non-zero if the body of DIE, a function about to be read by
+   read_func_scope, can be left for dwarf2_read_function_body.  */
+
+static int
+dwarf2_lazy_function_p (struct die_info *die, struct dwarf2_cu *cu)
+{
+  return (dwarf2_lazy_function_bodies
+	  && die->child != NULL
+	  && outermost_context_p ()
+	  && cu->per_cu != NULL
+	  && cu->addr_map == NULL
+	  && cu->repository == NULL
+	  && !cu->has_form_ref_addr
+	  && dwarf2_lazy_body_p (die, cu));
+}
+
+/* Cleanup that puts back the dwarf2_per_objfile that DATA was.  */
+
+static void
+dwarf2_restore_per_objfile (void *data)
+{
+  dwarf2_per_objfile = data;
+}
+
+/* What dwarf2_read_function_body changes while it reads a function
+   body, and puts back when it is done or fails.  */
+
+struct dwarf2_lazy_body_state
+{
+  const char *prefix;
+  struct dwarf2_cu *cu;
+  struct pending **list_in_scope;
+};
+
+static void
+dwarf2_restore_lazy_body_state (void *data)
+{
+  struct dwarf2_lazy_body_state *state = data;
+
+  processing_current_prefix = state->prefix;
+  state->cu->list_in_scope = state->list_in_scope;
+}
+
+/* The block_lazy expand function for the blocks made by
+   dwarf2_defer_function_body.  Read the body of the function that
+   BLOCK was made for from its DIE, loading the compilation unit
+   again if it has left the cache, and install it in BLOCK.  */
+
+static int
+dwarf2_read_function_body (struct block *block, void *data)
+{
+  struct dwarf2_lazy_body *lazy_body = data;
+  struct objfile *objfile = lazy_body->objfile;
+  struct dwarf2_per_cu_data *per_cu = lazy_body->per_cu;
+  struct symtab *symtab = per_cu->psymtab->symtab;
+  struct dwarf2_cu *cu;
+  struct die_info *die, *child_die;
+  struct context_stack *new;
+  struct cleanup *back_to, *state_chain;
+  struct dwarf2_lazy_body_state state;
+
+  /* The symbol building routines only build one thing at a time.  */
+  if (!outermost_context_p () || pending_blocks != NULL
+      || dwarf2_queue != NULL)
+    return 0;
+
+  if (symtab == NULL)
+    error (_("Dwarf Error: no symtab for %s [in module %s]"),
+	   per_cu->psymtab->filename, objfile->name);
+
+  back_to = make_cleanup (dwarf2_restore_per_objfile, dwarf2_per_objfile);
+  dwarf2_per_objfile = objfile_data (objfile, dwarf2_objfile_data_key);
+
+  if (per_cu->cu == NULL)
+    {
+      make_cleanup (dwarf2_release_queue, NULL);
+      queue_comp_unit (per_cu);
+      process_queue (objfile);
+    }
+  cu = per_cu->cu;
+  cu->last_used = 0;
+  dwarf2_set_cu_base_address (cu);
+
+  die = cu->die_ref_table[lazy_body->offset % REF_HASH_SIZE];
+  while (die != NULL && die->offset != lazy_body->offset)
+    die = die->next_ref;
+  if (die == NULL)
+    error (_("Dwarf Error: Cannot find DIE at 0x%lx [in module %s]"),
+	   (long) lazy_body->offset, objfile->name);
+
+  state.prefix = processing_current_prefix;
+  state.cu = cu;
+  state.list_in_scope = cu->list_in_scope;
+  state_chain = make_cleanup (dwarf2_restore_lazy_body_state, &state);
+
+  processing_current_prefix = lazy_body->prefix;
+  processing_has_namespace_info = cu->has_namespace_info;
+  processing_gcc_compilation = BLOCK_GCC_COMPILED (block);
+
+  buildsym_init ();
+  make_cleanup (really_free_pendings, NULL);
+
+  /* Do what read_func_scope would have done with the children.  */
+  new = push_context (0, BLOCK_START (block));
+  cu->list_in_scope = &local_symbols;
+
+  for (child_die = die->child;
+       child_die != NULL && child_die->tag;
+       child_die = sibling_die (child_die))
+    process_die (child_die, cu);
+
+  new = pop_context ();
+  finish_block (BLOCK_FUNCTION (block), &local_symbols, new->old_blocks,
+		BLOCK_START (block), BLOCK_END (block), BLOCK_RANGES (block),
+		objfile);
+  local_symbols = new->locals;
+  param_symbols = new->params;
+
+  finish_lazy_block (block, symtab, objfile);
+
+  /* Put things back before CU can leave the cache.  */
+  do_cleanups (state_chain);
+  age_cached_comp_units ();
+  do_cleanups (back_to);
+
+  return 1;
+}
+
+/* Arrange for the body of DIE, a function whose BLOCK has just been
+   made without it, to be read in when BLOCK's symbols are first
+   needed.  */
+
+static void
+dwarf2_defer_function_body (struct block *block, struct die_info *die,
+			    struct dwarf2_cu *cu)
+{
+  struct objfile *objfile = cu->objfile;
+  struct dwarf2_lazy_body *lazy_body;
+
+  lazy_body = obstack_alloc (&objfile->objfile_obstack,
+			     sizeof (struct dwarf2_lazy_body));
+  lazy_body->lazy.expand = dwarf2_read_function_body;
+  lazy_body->lazy.data = lazy_body;
+  lazy_body->objfile = objfile;
+  lazy_body->per_cu = cu->per_cu;
+  lazy_body->offset = die->offset;
+  if (processing_current_prefix[0] == '\0')
+    lazy_body->prefix = "";
+  else
+    lazy_body->prefix = obsavestring (processing_current_prefix,
+				      strlen (processing_current_prefix),
+				      &objfile->objfile_obstack);
+
+  BLOCK_LAZY (block) = &lazy_body->lazy;
+}
+/* APPLE LOCAL end lazy function bodies  */
+
 /* Process all the DIES contained within a lexical block scope.  Start
    a new scope, process the dies, and then close the scope.  */
 
@@ -13382,6 +13700,20 @@ caching, which can slow down startup."),
 			    &set_dwarf2_cmdlist,
 			    &show_dwarf2_cmdlist);
 
+  /* APPLE LOCAL begin lazy function bodies  */
+  add_setshow_boolean_cmd ("lazy-function-bodies", class_obscure,
+			   &dwarf2_lazy_function_bodies, _("\
+Set whether function bodies are read in only when they are needed."), _("\
+Show whether function bodies are read in only when they are needed."), _("\
+When on, reading the symbols of a dwarf2 compilation unit only makes\n\
+the blocks of its functions, and the parameters, locals and lexical\n\
+blocks of a function are read the first time they are looked at."),
+			   NULL,
+			   show_dwarf2_lazy_function_bodies,
+			   &set_dwarf2_cmdlist,
+			   &show_dwarf2_cmdlist);
+  /* APPLE LOCAL end lazy function bodies  */
+
   /* APPLE LOCAL begin subroutine inlining  */
   add_setshow_boolean_cmd ("inlined-stepping", class_support, 
 			   &dwarf2_allow_inlined_stepping,
@@ -54,6 +54,8 @@ struct elfinfo
   };
 
 static void free_elfinfo (void *);
+/* APPLE LOCAL deferred solib symbols */
+static void elf_symfile_read_psymtabs (struct objfile *);
 
 /* We are called once per section from elf_symfile_read.  We
    need to examine each section we are passed, check to see
@@ -491,15 +493,11 @@ elf_symtab_read (struct objfile *objfile, int dynamic)
 static void
 elf_symfile_read (struct objfile *objfile, int mainline)
 {
-  bfd *abfd = objfile->obfd;
-  struct elfinfo ei;
   struct cleanup *back_to;
 
   init_minimal_symbol_collection ();
   back_to = make_cleanup_discard_minimal_symbols ();
 
-  memset ((char *) &ei, 0, sizeof (ei));
-
   /* Allocate struct to keep track of the symfile */
   objfile->deprecated_sym_stab_info = (struct dbx_symfile_info *)
     xmalloc (sizeof (struct dbx_symfile_info));
@@ -525,17 +523,38 @@ elf_symfile_read (struct objfile *objfile, int mainline)
   install_minimal_symbols (objfile);
   do_cleanups (back_to);
 
-  /* Now process debugging information, which is contained in
-     special ELF sections. */
-
+  /* APPLE LOCAL begin deferred solib symbols */
   /* If we are reinitializing, or if we have never loaded syms yet,
-     set table to empty.  MAINLINE is cleared so that *_read_psymtab
-     functions do not all also re-initialize the psymbol table. */
+     set table to empty.  */
   if (mainline)
-    {
-      init_psymbol_list (objfile, 0);
-      mainline = 0;
-    }
+    init_psymbol_list (objfile, 0);
+
+  /* Now process debugging information, which is contained in
+     special ELF sections, unless we've been asked to leave that for
+     later.  */
+  if (objfile->symflags & OBJF_SYM_DEBUG)
+    elf_symfile_read_psymtabs (objfile);
+
+  /* FIXME: kettenis/20030504: This still needs to be integrated with
+     dwarf2read.c in a better way.  */
+  /* Call frame information is needed to unwind through this objfile
+     whether or not its debugging information has been read.  */
+  dwarf2_build_frame_info (objfile);
+}
+
+/* Read the debugging information of OBJFILE into psymtabs.  */
+
+static void
+elf_symfile_read_psymtabs (struct objfile *objfile)
+{
+  bfd *abfd = objfile->obfd;
+  struct elfinfo ei;
+  /* The psymbol table was set up by elf_symfile_read; don't let the
+     *_build_psymtabs functions initialize it again.  */
+  int mainline = 0;
+
+  memset ((char *) &ei, 0, sizeof (ei));
+  /* APPLE LOCAL end deferred solib symbols */
 
   /* We first have to find them... */
   bfd_map_over_sections (abfd, elf_locate_sections, (void *) & ei);
@@ -591,10 +610,6 @@ elf_symfile_read (struct objfile *objfile, int mainline)
 			    ei.dboffset, ei.dbsize,
 			    ei.lnoffset, ei.lnsize);
     }
-
-  /* FIXME: kettenis/20030504: This still needs to be integrated with
-     dwarf2read.c in a better way.  */
-  dwarf2_build_frame_info (objfile);
 }
 
 /* This cleans up the objfile's deprecated_sym_stab_info pointer, and
@@ -739,6 +754,8 @@ static struct sym_fns elf_sym_fns =
   elf_symfile_read,		/* sym_read: read a symbol file into symtab */
   elf_symfile_finish,		/* sym_finish: finished with file, cleanup */
   default_symfile_offsets,	/* sym_offsets:  Translate ext. to int. relocation */
+  /* APPLE LOCAL deferred solib symbols */
+  elf_symfile_read_psymtabs,	/* sym_read_psymtabs: read debug info later */
   NULL				/* next: pointer to next struct sym_fns */
 };
 
@@ -549,6 +549,11 @@ command_handler (char *command)
 #endif
     }
 
+  /* APPLE LOCAL symbol memory limit: Not while reading a command
+     file; only between the commands the user types.  */
+  if (instream == stdin)
+    enforce_symbol_memory_limit ();
+
   execute_command (command, instream == stdin);
 
   /* Set things up for this function to be compete later, once the
@@ -568,6 +568,8 @@ mark_previous_fixes_obsolete (struct fixinfo *cur)
 
     PSYMTAB_OBSOLETED (find_original_psymtab (cur)) = 51;
     SYMTAB_OBSOLETED (find_original_symtab (cur)) = 51;
+    /* APPLE LOCAL transparent type cache */
+    objfile_generation++;
 }
 
 /* Given a source filename, either find an existing fixinfo record
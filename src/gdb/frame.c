@@ -25,6 +25,8 @@
 #include "target.h"
 #include "value.h"
 #include "inferior.h"	/* for inferior_ptid */
+/* APPLE LOCAL non-stop */
+#include "gdbthread.h"
 #include "regcache.h"
 #include "gdb_assert.h"
 #include "gdb_string.h"
@@ -885,6 +887,10 @@ get_current_frame (void)
     error (_("No stack."));
   if (!target_has_memory)
     error (_("No memory."));
+  /* APPLE LOCAL non-stop: A running thread's registers can't be
+     read, so it has no frames until it stops.  */
+  if (is_running (inferior_ptid))
+    error (_("Selected thread is running."));
   if (current_frame == NULL)
     {
       struct frame_info *sentinel_frame =
@@ -937,6 +943,9 @@ deprecated_safe_get_selected_frame (void)
 {
   if (!target_has_registers || !target_has_stack || !target_has_memory)
     return NULL;
+  /* APPLE LOCAL non-stop */
+  if (is_running (inferior_ptid))
+    return NULL;
   return get_selected_frame (NULL);
 }
 
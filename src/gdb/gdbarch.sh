@@ -671,6 +671,38 @@ M::const struct regset *:regset_from_core_section:const char *sect_name, size_t
 
 # APPLE LOCAL: Translate eh frame regnums into dwarf regnums
 m::int:adjust_ehframe_regnum:int regnum, int eh_frame_p:regnum, eh_frame_p::default_adjust_ehframe_regnum::0
+
+# APPLE LOCAL begin displaced stepping
+# The maximum length of an instruction on this architecture.
+V::ULONGEST:max_insn_length:::0:0
+
+# Copy the instruction at FROM to TO, and make any adjustments
+# necessary to single-step it at that address.  REGS holds the state
+# the thread's registers will have before executing the copied
+# instruction; the PC in REGS will refer to FROM, not the copy at TO.
+# The caller will update it to point at TO later.  Return a pointer
+# to data of the architecture's choice recording any information
+# DISPLACED_STEP_FIXUP will need; it is allocated with xmalloc and
+# freed by the caller with xfree.
+#
+# For a general explanation of displaced stepping, see the comments
+# above displaced_step_prepare in infrun.c.
+M::struct displaced_step_closure *:displaced_step_copy_insn:CORE_ADDR from, CORE_ADDR to, struct regcache *regs:from, to, regs
+
+# Fix up the state resulting from successfully single-stepping a
+# displaced instruction, to give the result we would have gotten from
+# stepping the instruction in its original location.  REGS is the
+# register state resulting from single-stepping the displaced
+# instruction.  CLOSURE is the value returned by
+# DISPLACED_STEP_COPY_INSN.
+M::void:displaced_step_fixup:struct displaced_step_closure *closure, CORE_ADDR from, CORE_ADDR to, struct regcache *regs:closure, from, to, regs
+
+# Return the address of an appropriate place to put displaced
+# instructions while we step over them.  There need only be one such
+# place, since we're only stepping one thread over a breakpoint at a
+# time.
+m::CORE_ADDR:displaced_step_location:void:::displaced_step_at_entry_point::0
+# APPLE LOCAL end displaced stepping
 EOF
 }
 
@@ -780,6 +812,8 @@ struct reggroup;
 struct regset;
 struct disassemble_info;
 struct target_ops;
+/* APPLE LOCAL displaced stepping */
+struct displaced_step_closure;
 struct obstack;
 
 extern struct gdbarch *current_gdbarch;
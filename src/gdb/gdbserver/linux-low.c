@@ -683,7 +683,10 @@ retry:
      then we need to make sure we restart the other threads.  We could
      pick a thread at random or restart all; restarting all is less
      arbitrary.  */
-  if (cont_thread != 0 && cont_thread != -1)
+  /* APPLE LOCAL non-stop: In non-stop mode other threads may have
+     been left running by earlier requests, and any of them may
+     report.  */
+  if (cont_thread != 0 && cont_thread != -1 && !non_stop)
     {
       child = (struct thread_info *) find_inferior_id (&all_threads,
 						       cont_thread);
@@ -701,7 +704,9 @@ retry:
   enable_async_io ();
   unblock_async_io ();
   w = linux_wait_for_event (child);
-  stop_all_processes ();
+  /* APPLE LOCAL non-stop: Leave the other threads running.  */
+  if (!non_stop)
+    stop_all_processes ();
   disable_async_io ();
 
   /* If we are waiting for a particular child, and it exited,
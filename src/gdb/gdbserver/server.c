@@ -33,6 +33,8 @@ unsigned long thread_from_wait;
 unsigned long old_thread_from_wait;
 int extended_protocol;
 int server_waiting;
+/* APPLE LOCAL non-stop */
+int non_stop;
 
 jmp_buf toplevel;
 
@@ -116,6 +118,38 @@ attach_inferior (int pid, char *statusptr, int *sigptr)
 
 extern int remote_debug;
 
+/* APPLE LOCAL begin non-stop */
+/* Handle all of the extended 'Q' packets.  */
+void
+handle_general_set (char *own_buf)
+{
+  if (strncmp ("QNonStop:", own_buf, strlen ("QNonStop:")) == 0)
+    {
+      char *mode = own_buf + strlen ("QNonStop:");
+
+      if (strcmp (mode, "0") == 0)
+	non_stop = 0;
+      else if (strcmp (mode, "1") == 0)
+	non_stop = 1;
+      else
+	{
+	  strcpy (own_buf, "E01");
+	  return;
+	}
+
+      if (remote_debug)
+	fprintf (stderr, "[%s mode enabled]\n",
+		 non_stop ? "non-stop" : "all-stop");
+      strcpy (own_buf, "OK");
+      return;
+    }
+
+  /* Otherwise we didn't know what packet it was.  Say we didn't
+     understand it.  */
+  own_buf[0] = 0;
+}
+/* APPLE LOCAL end non-stop */
+
 /* Handle all of the extended 'q' packets.  */
 void
 handle_query (char *own_buf)
@@ -450,6 +484,10 @@ main (int argc, char *argv[])
 	    case 'q':
 	      handle_query (own_buf);
 	      break;
+	    /* APPLE LOCAL non-stop */
+	    case 'Q':
+	      handle_general_set (own_buf);
+	      break;
 	    case 'd':
 	      /* APPLE LOCAL: Handle all the debug flags here. */
 	      {
@@ -129,6 +129,9 @@ extern unsigned long step_thread;
 extern unsigned long thread_from_wait;
 extern unsigned long old_thread_from_wait;
 extern int server_waiting;
+/* APPLE LOCAL non-stop: If set, only the thread reporting an event
+   is stopped; the others are left as they are.  */
+extern int non_stop;
 
 extern jmp_buf toplevel;
 
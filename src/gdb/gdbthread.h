@@ -84,6 +84,17 @@ struct thread_info
   struct private_thread_info *private;
 
   struct inlined_function_data *thread_inlined_call_stack;
+
+  /* APPLE LOCAL thread hash: The ptid this thread was entered under
+     in the ptid hash table.  PTID itself can be overwritten (e.g. to
+     mark the thread dead), so this is what we unhash it by.  */
+  ptid_t hashed_ptid;
+
+  /* APPLE LOCAL non-stop: Non-zero if the target has been told to
+     resume this thread and it has not reported a stop since.  Only
+     ever set in non-stop mode; in all-stop mode every thread stops
+     together and this stays clear while GDB has control.  */
+  int running;
 };
 
 /* APPLE LOCAL begin threads */
@@ -173,4 +184,16 @@ extern struct cmd_list_element *thread_cmd_list;
 /* APPLE LOCAL */
 extern void switch_to_thread (ptid_t ptid);
 
+/* APPLE LOCAL begin non-stop */
+/* Mark the thread PTID as running (RUNNING non-zero) or stopped.
+   If PTID is minus_one_ptid, mark every thread.  */
+extern void set_running (ptid_t ptid, int running);
+
+/* Non-zero if thread PTID is known to be running.  */
+extern int is_running (ptid_t ptid);
+
+/* Non-zero if any thread is known to be running.  */
+extern int any_running (void);
+/* APPLE LOCAL end non-stop */
+
 #endif /* GDBTHREAD_H */
@@ -39,6 +39,10 @@
 #include "cp-abi.h"
 #include "gdb_assert.h"
 #include "exceptions.h"
+/* APPLE LOCAL begin struct field index */
+#include "hashtab.h"
+#include <ctype.h>
+/* APPLE LOCAL end struct field index */
 
 /* These variables point to the objects
    representing the predefined C data types.  */
@@ -1415,6 +1419,219 @@ lookup_template_type (char *name, struct type *type, struct block *block)
   return (SYMBOL_TYPE (sym));
 }
 
+/* APPLE LOCAL begin struct field index */
+/* Finding a member of a struct by comparing its name with the name of
+   each field in turn is slow for the generated structs and classes
+   that have thousands of fields.  So for a struct with at least
+   FIELD_INDEX_MIN_FIELDS fields of its own, we make a hash table of
+   their names the first time a member is looked up by name.  The
+   tables are kept by objfile, on its obstack.  */
+
+#define FIELD_INDEX_MIN_FIELDS 16
+
+struct field_name_index
+{
+  /* The type the index is for; the key in the objfile's table.  */
+  struct main_type *main_type;
+
+  /* The fields the index was made from.  If the type's fields have
+     been replaced since, the index is made again.  */
+  struct field *fields;
+  int nfields;
+
+  /* Zero if a field has a name we can't look up by hashing, such as
+     one with spaces in it.  */
+  int usable;
+
+  /* Non-zero if the type has anonymous struct or union members, whose
+     own members value_struct_elt finds too.  */
+  int has_anonymous;
+
+  /* An open hash table of NSLOTS slots, NSLOTS being a power of two.
+     Each slot holds one more than the number of a field, or zero if
+     it is empty.  */
+  int nslots;
+  int *slots;
+};
+
+static const struct objfile_data *field_name_index_key;
+
+static hashval_t
+hash_field_name_index (const void *p)
+{
+  return htab_hash_pointer (((const struct field_name_index *) p)->main_type);
+}
+
+static int
+eq_field_name_index (const void *a, const void *b)
+{
+  return (((const struct field_name_index *) a)->main_type
+	  == ((const struct field_name_index *) b)->main_type);
+}
+
+static void *
+field_name_index_obstack_allocate (void *data, size_t size, size_t count)
+{
+  void *ptr = obstack_alloc ((struct obstack *) data, size * count);
+
+  memset (ptr, 0, size * count);
+  return ptr;
+}
+
+static void
+field_name_index_obstack_deallocate (void *object, void *data)
+{
+  /* Freed with the obstack.  */
+}
+
+/* Return non-zero if NAME is a C identifier; strcmp_iw matches such a
+   name only with itself.  */
+
+static int
+field_name_simple_p (const char *name)
+{
+  if (!isalpha ((unsigned char) *name) && *name != '_' && *name != '$')
+    return 0;
+  for (name++; *name != '\0'; name++)
+    if (!isalnum ((unsigned char) *name) && *name != '_' && *name != '$')
+      return 0;
+  return 1;
+}
+
+/* Return the field name index of TYPE, making it if need be, or NULL
+   if TYPE doesn't have one or can't use one.  */
+
+static struct field_name_index *
+get_field_name_index (struct type *type)
+{
+  struct objfile *objfile = TYPE_OBJFILE (type);
+  struct field_name_index key, *index;
+  htab_t table;
+  void **slot;
+  int nbases = TYPE_N_BASECLASSES (type);
+  int nslots;
+  int i;
+
+  /* Fields are still being filled in while a symtab is read.  */
+  if (objfile == NULL || currently_reading_symtab
+      || TYPE_NFIELDS (type) - nbases < FIELD_INDEX_MIN_FIELDS)
+    return NULL;
+
+  table = objfile_data (objfile, field_name_index_key);
+  if (table == NULL)
+    {
+      table = htab_create_alloc_ex (64, hash_field_name_index,
+				    eq_field_name_index, NULL,
+				    &objfile->objfile_obstack,
+				    field_name_index_obstack_allocate,
+				    field_name_index_obstack_deallocate);
+      set_objfile_data (objfile, field_name_index_key, table);
+    }
+
+  key.main_type = TYPE_MAIN_TYPE (type);
+  slot = htab_find_slot (table, &key, INSERT);
+  index = *slot;
+  if (index != NULL
+      && index->fields == TYPE_FIELDS (type)
+      && index->nfields == TYPE_NFIELDS (type))
+    return index->usable ? index : NULL;
+
+  if (index == NULL)
+    {
+      index = obstack_alloc (&objfile->objfile_obstack, sizeof (*index));
+      index->main_type = TYPE_MAIN_TYPE (type);
+      index->nslots = 0;
+      index->slots = NULL;
+      *slot = index;
+    }
+  index->fields = TYPE_FIELDS (type);
+  index->nfields = TYPE_NFIELDS (type);
+  index->usable = 1;
+  index->has_anonymous = 0;
+  for (nslots = 1; nslots < 2 * (TYPE_NFIELDS (type) - nbases); nslots *= 2)
+    ;
+
+  /* The obstack can't free the slots of an index that is out of date,
+     so use them again if there are as many as we need.  */
+  if (nslots == index->nslots)
+    memset (index->slots, 0, nslots * sizeof (int));
+  else
+    {
+      index->nslots = nslots;
+      index->slots
+	= field_name_index_obstack_allocate (&objfile->objfile_obstack,
+					     sizeof (int), nslots);
+    }
+
+  /* Enter the fields in order, so that a later field with the same
+     name wins, as it does in the searches that start from the end.  */
+  for (i = nbases; i < TYPE_NFIELDS (type); i++)
+    {
+      char *name = TYPE_FIELD_NAME (type, i);
+      int h;
+
+      if (name == NULL)
+	continue;
+      if (name[0] == '\0'
+	  || (TYPE_CODE (type) == TYPE_CODE_UNION
+	      && strcmp_iw (name, "else") == 0))
+	index->has_anonymous = 1;
+      if (name[0] == '\0')
+	continue;
+      if (!field_name_simple_p (name))
+	{
+	  index->usable = 0;
+	  return NULL;
+	}
+
+      h = htab_hash_string (name) & (index->nslots - 1);
+      while (index->slots[h] != 0
+	     && strcmp (TYPE_FIELD_NAME (type, index->slots[h] - 1), name) != 0)
+	h = (h + 1) & (index->nslots - 1);
+      index->slots[h] = i + 1;
+    }
+
+  return index;
+}
+
+/* Look NAME up among the fields of the struct or union TYPE itself,
+   not those of its base classes.  If that can be done quickly, set
+   *FIELDNO to the number of the last field named NAME, or to -1 if
+   there is none, and return non-zero.  Otherwise return zero, and the
+   caller has to compare the field names itself.
+
+   If ANONYMOUS is non-zero, the caller also looks for NAME among the
+   members of anonymous struct and union members of TYPE, and we can't
+   answer for a type that has any.  */
+
+int
+lookup_struct_field_index (struct type *type, const char *name,
+			   int anonymous, int *fieldno)
+{
+  struct field_name_index *index;
+  int h;
+
+  if (!field_name_simple_p (name))
+    return 0;
+  index = get_field_name_index (type);
+  if (index == NULL || (anonymous && index->has_anonymous))
+    return 0;
+
+  h = htab_hash_string (name) & (index->nslots - 1);
+  while (index->slots[h] != 0)
+    {
+      if (strcmp (TYPE_FIELD_NAME (type, index->slots[h] - 1), name) == 0)
+	{
+	  *fieldno = index->slots[h] - 1;
+	  return 1;
+	}
+      h = (h + 1) & (index->nslots - 1);
+    }
+  *fieldno = -1;
+  return 1;
+}
+/* APPLE LOCAL end struct field index */
+
 /* Given a type TYPE, lookup the type of the component of type named NAME.  
 
    TYPE can be either a struct or union, or a pointer or reference to a struct or
@@ -1464,15 +1681,25 @@ lookup_struct_elt_type (struct type *type, char *name, int noerr)
   }
 #endif
 
-  for (i = TYPE_NFIELDS (type) - 1; i >= TYPE_N_BASECLASSES (type); i--)
+  /* APPLE LOCAL begin struct field index */
+  if (lookup_struct_field_index (type, name, 0, &i))
     {
-      char *t_field_name = TYPE_FIELD_NAME (type, i);
-
-      if (t_field_name && (strcmp_iw (t_field_name, name) == 0))
+      if (i >= 0)
+	return TYPE_FIELD_TYPE (type, i);
+    }
+  else
+    {
+      for (i = TYPE_NFIELDS (type) - 1; i >= TYPE_N_BASECLASSES (type); i--)
 	{
-	  return TYPE_FIELD_TYPE (type, i);
+	  char *t_field_name = TYPE_FIELD_NAME (type, i);
+
+	  if (t_field_name && (strcmp_iw (t_field_name, name) == 0))
+	    {
+	      return TYPE_FIELD_TYPE (type, i);
+	    }
 	}
     }
+  /* APPLE LOCAL end struct field index */
 
   /* OK, it's not in this class.  Recursively check the baseclasses.  */
   for (i = TYPE_N_BASECLASSES (type) - 1; i >= 0; i--)
@@ -4059,6 +4286,9 @@ extern void _initialize_gdbtypes (void);
 void
 _initialize_gdbtypes (void)
 {
+  /* APPLE LOCAL struct field index */
+  field_name_index_key = register_objfile_data ();
+
   builtin_type_int0 =
     init_type (TYPE_CODE_INT, 0 / 8,
 	       0,
@@ -1321,6 +1321,10 @@ extern char *type_name_no_tag (const struct type *);
 
 extern struct type *lookup_struct_elt_type (struct type *, char *, int);
 
+/* APPLE LOCAL struct field index */
+extern int lookup_struct_field_index (struct type *, const char *, int,
+				      int *);
+
 extern struct type *make_pointer_type (struct type *, struct type **);
 
 extern struct type *lookup_pointer_type (struct type *);
@@ -31,6 +31,8 @@
 #include <sys/ptrace.h>
 #include <sys/user.h>
 #include <sys/procfs.h>
+/* APPLE LOCAL page watchpoints */
+#include <sys/syscall.h>
 
 #ifdef HAVE_SYS_REG_H
 #include <sys/reg.h>
@@ -839,3 +841,44 @@ child_post_startup_inferior (ptid_t ptid)
   i386_cleanup_dregs ();
   linux_child_post_startup_inferior (ptid);
 }
+
+/* APPLE LOCAL begin page watchpoints */
+/* Have the stopped LWP LWPID call mprotect (ADDR, LEN, PROT) with an
+   `int $0x80' placed at SCRATCH.  */
+
+static int
+i386_linux_inferior_mprotect (int lwpid, CORE_ADDR scratch,
+			      CORE_ADDR addr, ULONGEST len, int prot)
+{
+  static const gdb_byte int80[] = { 0xcd, 0x80 };
+  elf_gregset_t regs;
+
+  if (ptrace (PTRACE_GETREGS, lwpid, 0, (int) &regs) < 0)
+    return -1;
+
+  regs[EAX] = SYS_mprotect;
+  regs[EBX] = addr;
+  regs[ECX] = len;
+  regs[EDX] = prot;
+  regs[EIP] = scratch;
+#if ORIG_EAX != -1
+  /* Don't let the kernel restart a system call LWPID was in.  */
+  regs[ORIG_EAX] = -1;
+#endif
+
+  if (linux_nat_execute_insn (lwpid, scratch, int80, sizeof (int80),
+			      &regs) != 0)
+    return -1;
+
+  return (int) regs[EAX];
+}
+
+/* Provide a prototype to silence -Wmissing-prototypes.  */
+void _initialize_i386_linux_nat (void);
+
+void
+_initialize_i386_linux_nat (void)
+{
+  linux_nat_inferior_mprotect = i386_linux_inferior_mprotect;
+}
+/* APPLE LOCAL end page watchpoints */
@@ -442,6 +442,14 @@ i386_linux_init_abi (struct gdbarch_info info, struct gdbarch *gdbarch)
   /* Enable TLS support.  */
   set_gdbarch_fetch_tls_load_module_address (gdbarch,
                                              svr4_fetch_objfile_link_map);
+
+  /* APPLE LOCAL begin displaced stepping */
+  /* Step over breakpoints out of line, in a copy of the instruction
+     placed at the entry point, so other threads needn't stop.  */
+  set_gdbarch_displaced_step_copy_insn (gdbarch,
+                                        i386_displaced_step_copy_insn);
+  set_gdbarch_displaced_step_fixup (gdbarch, i386_displaced_step_fixup);
+  /* APPLE LOCAL end displaced stepping */
 }
 
 /* Provide a prototype to silence -Wmissing-prototypes.  */
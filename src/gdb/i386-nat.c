@@ -23,6 +23,11 @@
 #include "breakpoint.h"
 #include "command.h"
 #include "gdbcmd.h"
+/* APPLE LOCAL begin page watchpoints */
+#ifdef I386_USE_PAGE_WATCHPOINTS
+#include "linux-nat.h"
+#endif
+/* APPLE LOCAL end page watchpoints */
 
 /* Support for hardware watchpoints and breakpoints using the i386
    debug registers.
@@ -663,6 +668,58 @@ i386_remove_hw_breakpoint (CORE_ADDR addr, gdb_byte *shadow)
   return retval;
 }
 
+/* APPLE LOCAL begin page watchpoints */
+#ifdef I386_USE_PAGE_WATCHPOINTS
+
+/* Write watchpoints the debug registers have no room for are
+   implemented by write-protecting pages; see linux-nat.c.  */
+
+int
+i386_page_region_ok_for_watchpoint (CORE_ADDR addr, int len, int type)
+{
+  return (i386_region_ok_for_watchpoint (addr, len)
+	  || linux_nat_region_ok_for_page_watchpoint (addr, len, type));
+}
+
+int
+i386_page_insert_watchpoint (CORE_ADDR addr, int len, int type)
+{
+  if (i386_insert_watchpoint (addr, len, type) == 0)
+    return 0;
+
+  /* Some of the aligned pieces of a region may have gone in; take
+     them out again, since breakpoint.c won't if we succeed below.  */
+  i386_remove_watchpoint (addr, len, type);
+
+  return linux_nat_insert_page_watchpoint (addr, len, type);
+}
+
+int
+i386_page_remove_watchpoint (CORE_ADDR addr, int len, int type)
+{
+  if (linux_nat_remove_page_watchpoint (addr, len, type) == 0)
+    return 0;
+
+  return i386_remove_watchpoint (addr, len, type);
+}
+
+int
+i386_page_stopped_data_address (CORE_ADDR *addr_p)
+{
+  return (linux_nat_stopped_page_watch_data_address (addr_p)
+	  || i386_stopped_data_address (addr_p));
+}
+
+int
+i386_page_stopped_by_watchpoint (void)
+{
+  CORE_ADDR addr = 0;
+  return i386_page_stopped_data_address (&addr);
+}
+
+#endif /* I386_USE_PAGE_WATCHPOINTS */
+/* APPLE LOCAL end page watchpoints */
+
 #endif /* I386_USE_GENERIC_WATCHPOINTS */
 
 
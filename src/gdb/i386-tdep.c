@@ -1398,6 +1398,238 @@ i386_print_insn (bfd_vma pc, struct disassemble_info *info)
 }
 
 
+/* APPLE LOCAL begin displaced stepping */
+/* Displaced stepping.  The instruction under a breakpoint is copied
+   to a scratch area and single-stepped there, so the breakpoint can
+   stay inserted while other threads run.  Almost every instruction
+   behaves the same at the new address; only the PC and any return
+   address pushed by a call need to be moved back afterwards.  */
+
+/* Return a pointer to the first byte of INSN following any
+   instruction prefixes.  */
+
+static gdb_byte *
+i386_skip_prefixes (gdb_byte *insn, size_t max_len)
+{
+  gdb_byte *end = insn + max_len;
+
+  while (insn < end)
+    {
+      switch (*insn)
+	{
+	case 0x26: case 0x2e: case 0x36: case 0x3e:	/* Segment.  */
+	case 0x64: case 0x65:
+	case 0x66: case 0x67:				/* Size.  */
+	case 0xf0: case 0xf2: case 0xf3:		/* Lock, rep.  */
+	  insn++;
+	  break;
+	default:
+	  return insn;
+	}
+    }
+
+  return insn;
+}
+
+/* Return non-zero if INSN is an indirect or far jump, which leaves
+   the PC at an absolute address.  */
+
+static int
+i386_absolute_jmp_p (const gdb_byte *insn)
+{
+  /* jmp far (absolute address in operand).  */
+  if (insn[0] == 0xea)
+    return 1;
+
+  if (insn[0] == 0xff)
+    {
+      /* jump near, absolute indirect (/4).  */
+      if ((insn[1] & 0x38) == 0x20)
+	return 1;
+
+      /* jump far, absolute indirect (/5).  */
+      if ((insn[1] & 0x38) == 0x28)
+	return 1;
+    }
+
+  return 0;
+}
+
+/* Return non-zero if INSN is an indirect or far call.  */
+
+static int
+i386_absolute_call_p (const gdb_byte *insn)
+{
+  /* call far, absolute.  */
+  if (insn[0] == 0x9a)
+    return 1;
+
+  if (insn[0] == 0xff)
+    {
+      /* Call near, absolute indirect (/2).  */
+      if ((insn[1] & 0x38) == 0x10)
+	return 1;
+
+      /* Call far, absolute indirect (/3).  */
+      if ((insn[1] & 0x38) == 0x18)
+	return 1;
+    }
+
+  return 0;
+}
+
+/* Return non-zero if INSN is a return of any kind.  */
+
+static int
+i386_ret_p (const gdb_byte *insn)
+{
+  switch (insn[0])
+    {
+    case 0xc2: /* ret near, pop N bytes.  */
+    case 0xc3: /* ret near */
+    case 0xca: /* ret far, pop N bytes.  */
+    case 0xcb: /* ret far */
+    case 0xcf: /* iret */
+      return 1;
+
+    default:
+      return 0;
+    }
+}
+
+/* Return non-zero if INSN pushes a return address.  */
+
+static int
+i386_call_p (const gdb_byte *insn)
+{
+  if (i386_absolute_call_p (insn))
+    return 1;
+
+  /* call near, relative.  */
+  if (insn[0] == 0xe8)
+    return 1;
+
+  return 0;
+}
+
+/* Return non-zero if INSN is a system call, and set *LENGTHP to its
+   length in bytes.  Otherwise, return zero.  */
+
+static int
+i386_syscall_p (const gdb_byte *insn, int *lengthp)
+{
+  /* int $0x80, syscall, sysenter.  */
+  if ((insn[0] == 0xcd && insn[1] == 0x80)
+      || (insn[0] == 0x0f && (insn[1] == 0x05 || insn[1] == 0x34)))
+    {
+      *lengthp = 2;
+      return 1;
+    }
+
+  return 0;
+}
+
+/* Copy the instruction at FROM to TO.  The closure is simply a copy
+   of the instruction bytes, which the fixup below decodes.  */
+
+struct displaced_step_closure *
+i386_displaced_step_copy_insn (struct gdbarch *gdbarch,
+			       CORE_ADDR from, CORE_ADDR to,
+			       struct regcache *regs)
+{
+  size_t len = gdbarch_max_insn_length (gdbarch);
+  gdb_byte *buf = xmalloc (len);
+  int status;
+
+  /* APPLE LOCAL non-stop: Read what is underneath any breakpoint
+     inserted at FROM; in non-stop mode they stay in.  */
+  status = deprecated_read_memory_nobpt (from, buf, len);
+  if (status != 0)
+    {
+      xfree (buf);
+      memory_error (status, from);
+    }
+  write_memory (to, buf, len);
+
+  return (struct displaced_step_closure *) buf;
+}
+
+/* Move the PC in REGS, and any return address pushed, back from the
+   copy of the instruction at TO to the original at FROM.  INSN points
+   to the opcode within INSN_START, the copied bytes.  PC_REGNUM and
+   SP_REGNUM are the program counter and stack pointer, and ADDR_SIZE
+   is the size of an address; this is shared with amd64-tdep.c.  */
+
+void
+i386_displaced_step_relocate (struct regcache *regs,
+			      const gdb_byte *insn_start, const gdb_byte *insn,
+			      CORE_ADDR from, CORE_ADDR to,
+			      int pc_regnum, int sp_regnum, int addr_size)
+{
+  /* The offset we applied to the instruction's address.  This could
+     well be negative (when viewed as a signed value), but ULONGEST
+     won't reflect that, so mask the result to the address size.  */
+  ULONGEST insn_offset = to - from;
+  ULONGEST mask = (addr_size < sizeof (ULONGEST)
+		   ? ((ULONGEST) 1 << (addr_size * 8)) - 1 : ~(ULONGEST) 0);
+  int insn_len;
+
+  /* Relocate the PC unless the instruction put it somewhere absolute:
+     relative jumps and calls land at the same offset from the copy as
+     they would have from the original.  */
+  if (! i386_absolute_jmp_p (insn)
+      && ! i386_absolute_call_p (insn)
+      && ! i386_ret_p (insn))
+    {
+      ULONGEST orig_pc;
+
+      regcache_cooked_read_unsigned (regs, pc_regnum, &orig_pc);
+
+      /* A system call that returns from a signal handler (sigreturn)
+	 sets the PC itself, much like a return.  Most system calls
+	 leave control directly after the instruction; relocate only
+	 in that case.  */
+      if (i386_syscall_p (insn, &insn_len)
+	  && orig_pc != to + (insn - insn_start) + insn_len)
+	;
+      else
+	regcache_cooked_write_unsigned (regs, pc_regnum,
+					(orig_pc - insn_offset) & mask);
+    }
+
+  /* A call pushed the address following the copy; make it the
+     address following the original.  */
+  if (i386_call_p (insn))
+    {
+      ULONGEST sp;
+      ULONGEST retaddr;
+
+      regcache_cooked_read_unsigned (regs, sp_regnum, &sp);
+      retaddr = read_memory_unsigned_integer (sp, addr_size);
+      retaddr = (retaddr - insn_offset) & mask;
+      write_memory_unsigned_integer (sp, addr_size, retaddr);
+    }
+}
+
+/* Fix up the registers after the instruction copied by
+   i386_displaced_step_copy_insn has been single-stepped at TO.  */
+
+void
+i386_displaced_step_fixup (struct gdbarch *gdbarch,
+			   struct displaced_step_closure *closure,
+			   CORE_ADDR from, CORE_ADDR to,
+			   struct regcache *regs)
+{
+  gdb_byte *insn_start = (gdb_byte *) closure;
+  gdb_byte *insn;
+
+  insn = i386_skip_prefixes (insn_start, gdbarch_max_insn_length (gdbarch));
+  i386_displaced_step_relocate (regs, insn_start, insn, from, to,
+				I386_EIP_REGNUM, I386_ESP_REGNUM, 4);
+}
+/* APPLE LOCAL end displaced stepping */
+
+
 /* i386 register groups.  In addition to the normal groups, add "mmx"
    and "sse".  */
 
@@ -1547,6 +1779,8 @@ i386_gdbarch_init (struct gdbarch_info info, struct gdbarch_list *arches)
   set_gdbarch_sp_regnum (gdbarch, I386_ESP_REGNUM); /* %esp */
   set_gdbarch_pc_regnum (gdbarch, I386_EIP_REGNUM); /* %eip */
   set_gdbarch_ps_regnum (gdbarch, I386_EFLAGS_REGNUM); /* %eflags */
+  /* APPLE LOCAL displaced stepping */
+  set_gdbarch_max_insn_length (gdbarch, I386_MAX_INSN_LEN);
   set_gdbarch_fp0_regnum (gdbarch, I386_ST0_REGNUM); /* %st(0) */
   /* APPLE LOCAL: Add the frame pointer register so it can be modified
      in expressions.  */
@@ -156,6 +156,10 @@ enum i386_regnum
 /* Size of the largest register.  */
 #define I386_MAX_REGISTER_SIZE	16
 
+/* APPLE LOCAL displaced stepping */
+/* Size of the largest instruction, prefixes included.  */
+#define I386_MAX_INSN_LEN	16
+
 /* Functions exported from i386-tdep.c.  */
 extern CORE_ADDR i386_pe_skip_trampoline_code (CORE_ADDR pc, char *name);
 
@@ -187,6 +191,29 @@ extern const struct regset *
   i386_regset_from_core_section (struct gdbarch *gdbarch,
 				 const char *sect_name, size_t sect_size);
 
+/* APPLE LOCAL begin displaced stepping */
+/* Copy the instruction at FROM to the scratch area at TO, and fix up
+   the registers after it has been single-stepped there.  */
+extern struct displaced_step_closure *
+  i386_displaced_step_copy_insn (struct gdbarch *gdbarch,
+				 CORE_ADDR from, CORE_ADDR to,
+				 struct regcache *regs);
+extern void i386_displaced_step_fixup (struct gdbarch *gdbarch,
+				       struct displaced_step_closure *closure,
+				       CORE_ADDR from, CORE_ADDR to,
+				       struct regcache *regs);
+
+/* Relocate the PC and any pushed return address after the copied
+   instruction INSN (within the copied bytes INSN_START) has been
+   single-stepped at TO instead of FROM.  */
+extern void i386_displaced_step_relocate (struct regcache *regs,
+					  const gdb_byte *insn_start,
+					  const gdb_byte *insn,
+					  CORE_ADDR from, CORE_ADDR to,
+					  int pc_regnum, int sp_regnum,
+					  int addr_size);
+/* APPLE LOCAL end displaced stepping */
+
 /* Initialize a basic ELF architecture variant.  */
 extern void i386_elf_init_abi (struct gdbarch_info, struct gdbarch *);
 
@@ -158,6 +158,10 @@ extern void proceed (CORE_ADDR, enum target_signal, int);
    over such function.  */
 extern int step_stop_if_no_debug;
 
+/* APPLE LOCAL non-stop: If set, only the thread reporting an event is
+   stopped, and resuming resumes only the current thread.  */
+extern int non_stop;
+
 extern void kill_inferior (void);
 
 extern void generic_mourn_inferior (void);
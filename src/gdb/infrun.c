@@ -286,6 +286,13 @@ static int trap_expected;
    of shared library events by the dynamic linker.  */
 static int stop_on_solib_events;
 
+/* APPLE LOCAL begin deferred solib symbols */
+/* Non-zero if the inferior stopped only because stop_on_solib_events
+   asked for it.  Libraries whose debugging information was put off
+   stay that way across such a stop.  */
+static int stopped_for_solib_event;
+/* APPLE LOCAL end deferred solib symbols */
+
 /* APPLE LOCAL:  If we stop on a shlib load event while in the
    middle of finish or step then the step_resume_bp or the bp_finish
    bp will have gotten lost, and a continue following this will not
@@ -687,6 +694,293 @@ set_schedlock_func (char *args, int from_tty, struct cmd_list_element *c)
 }
 
 
+/* APPLE LOCAL begin displaced stepping */
+/* Displaced stepping.
+
+   To step a thread over a breakpoint we would normally remove all the
+   breakpoints, step just that thread, and put them back -- keeping
+   every other thread stopped meanwhile, since they could run past
+   breakpoints while those are out.  With many threads and a
+   conditional breakpoint that seldom fires, that is a stop of the
+   whole program on every hit.
+
+   When the architecture supports it, we instead copy the instruction
+   under the breakpoint to a scratch area (the gdbarch's
+   displaced_step_location), point the thread's PC at the copy, and
+   single-step it there with the breakpoints still inserted and the
+   other threads running.  When the step finishes, the gdbarch's
+   displaced_step_fixup makes the registers look as though the
+   instruction ran in its original place: the PC is moved back to
+   follow the original, a pushed return address is corrected, and so
+   on.
+
+   Only one thread is displaced-stepping at a time.  If another thread
+   reports an event first, we finish the displaced step synchronously
+   before looking at that event, so the rest of handle_inferior_event
+   never sees a thread sitting in the scratch area.  */
+
+static int can_use_displaced_stepping = 1;
+static void
+show_can_use_displaced_stepping (struct ui_file *file, int from_tty,
+				 struct cmd_list_element *c,
+				 const char *value)
+{
+  fprintf_filtered (file, _("\
+Debugger's willingness to use displaced stepping to step over \
+breakpoints is %s.\n"), value);
+}
+
+/* Non-zero while DISPLACED_STEP_PTID is stepping a copied
+   instruction.  */
+static int displaced_step_in_progress;
+static ptid_t displaced_step_ptid;
+
+/* The architecture's record of the copied instruction.  */
+static struct displaced_step_closure *displaced_step_closure;
+
+/* Where the instruction came from, and where we copied it to.  */
+static CORE_ADDR displaced_step_original;
+static CORE_ADDR displaced_step_copy;
+
+/* The contents of the scratch area before we overwrote it.  */
+static gdb_byte *displaced_step_saved_copy;
+static ULONGEST displaced_step_len;
+
+/* A signal the displaced thread stopped with while we were finishing
+   its step for another thread's event, and the thread that has yet to
+   be resumed with it.  */
+static enum target_signal displaced_step_pending_signal;
+static ptid_t displaced_step_pending_ptid;
+
+static void
+displaced_step_clear (void)
+{
+  xfree (displaced_step_closure);
+  displaced_step_closure = NULL;
+  xfree (displaced_step_saved_copy);
+  displaced_step_saved_copy = NULL;
+  displaced_step_in_progress = 0;
+}
+
+static void
+displaced_step_clear_cleanup (void *ignore)
+{
+  displaced_step_clear ();
+}
+
+/* Return non-zero if resuming the current thread with STEP and SIG
+   should step it over the breakpoint at its PC out of line.  */
+
+static int
+use_displaced_stepping (int step, enum target_signal sig)
+{
+  /* A signal handler would run with the PC in the scratch area, and
+     with the scheduler locked no other thread would run anyway.  */
+  return (can_use_displaced_stepping
+	  && step
+	  && sig == TARGET_SIGNAL_0
+	  && !displaced_step_in_progress
+	  /* APPLE LOCAL non-stop: breakpoints are never taken out.  */
+	  && (!breakpoints_inserted || non_stop)
+	  && !stepping_past_singlestep_breakpoint
+	  && !SOFTWARE_SINGLE_STEP_P ()
+	  && scheduler_mode == schedlock_off
+	  && gdbarch_max_insn_length_p (current_gdbarch)
+	  && gdbarch_displaced_step_copy_insn_p (current_gdbarch)
+	  && gdbarch_displaced_step_fixup_p (current_gdbarch)
+	  && breakpoint_here_p (read_pc ()) == ordinary_breakpoint_here);
+}
+
+/* Copy the instruction at the current thread's PC to the scratch
+   area and point the PC at the copy.  The architecture reads the
+   original instruction from underneath any breakpoint inserted there.
+   Return non-zero if the thread is ready to step.  */
+
+static int
+displaced_step_prepare (void)
+{
+  struct gdbarch *gdbarch = current_gdbarch;
+  struct cleanup *old_chain;
+  CORE_ADDR original, copy;
+  gdb_byte *saved;
+  ULONGEST len, i;
+
+  if (entry_point_address () == 0)
+    return 0;
+
+  len = gdbarch_max_insn_length (gdbarch);
+  original = read_pc ();
+  copy = gdbarch_displaced_step_location (gdbarch);
+
+  /* The scratch area mustn't overlap the instruction, or anywhere a
+     breakpoint is about to be inserted.  */
+  if (copy < original + len && original < copy + len)
+    return 0;
+  for (i = 0; i < len; i++)
+    if (breakpoint_here_p (copy + i) != no_breakpoint_here)
+      return 0;
+
+  saved = xmalloc (len);
+  old_chain = make_cleanup (xfree, saved);
+  if (target_read_memory (copy, saved, len) != 0)
+    {
+      do_cleanups (old_chain);
+      return 0;
+    }
+
+  displaced_step_closure
+    = gdbarch_displaced_step_copy_insn (gdbarch, original, copy,
+					current_regcache);
+  discard_cleanups (old_chain);
+
+  displaced_step_saved_copy = saved;
+  displaced_step_len = len;
+  displaced_step_original = original;
+  displaced_step_copy = copy;
+  displaced_step_ptid = inferior_ptid;
+  displaced_step_in_progress = 1;
+
+  write_pc (copy);
+
+  if (debug_infrun)
+    fprintf_unfiltered (gdb_stdlog,
+			"infrun: displaced: stepping %s at 0x%s via 0x%s\n",
+			target_pid_to_str (inferior_ptid),
+			paddr_nz (original), paddr_nz (copy));
+  return 1;
+}
+
+/* Give up on a displaced step that hasn't started.  */
+
+static void
+displaced_step_cancel (void)
+{
+  struct cleanup *old_chain = make_cleanup (displaced_step_clear_cleanup, 0);
+
+  write_memory (displaced_step_copy, displaced_step_saved_copy,
+		displaced_step_len);
+  write_pc_pid (displaced_step_original, displaced_step_ptid);
+  do_cleanups (old_chain);
+}
+
+/* The displaced thread has stopped with signal SIG.  Put back the
+   scratch area, and make the thread's registers look as though it
+   had stepped the original instruction.  If SIG isn't SIGTRAP the
+   step was interrupted; the PC is just moved back relative to the
+   original.  */
+
+static void
+displaced_step_fixup (enum target_signal sig)
+{
+  struct cleanup *old_chain = save_inferior_ptid ();
+  CORE_ADDR pc;
+
+  /* The gdbarch method works on the current thread's registers; the
+     event being handled may be another thread's.  */
+  make_cleanup (displaced_step_clear_cleanup, 0);
+  inferior_ptid = displaced_step_ptid;
+
+  write_memory (displaced_step_copy, displaced_step_saved_copy,
+		displaced_step_len);
+
+  pc = read_pc_pid (displaced_step_ptid);
+  if (sig == TARGET_SIGNAL_TRAP)
+    gdbarch_displaced_step_fixup (current_gdbarch, displaced_step_closure,
+				  displaced_step_original,
+				  displaced_step_copy, current_regcache);
+  else if (pc >= displaced_step_copy
+	   && pc < displaced_step_copy + displaced_step_len)
+    write_pc_pid (displaced_step_original + (pc - displaced_step_copy),
+		  displaced_step_ptid);
+
+  if (debug_infrun)
+    fprintf_unfiltered (gdb_stdlog,
+			"infrun: displaced: %s stopped at 0x%s, now 0x%s\n",
+			target_pid_to_str (displaced_step_ptid),
+			paddr_nz (pc),
+			paddr_nz (read_pc_pid (displaced_step_ptid)));
+
+  do_cleanups (old_chain);
+}
+
+/* Resume the thread with the signal it stopped with while its
+   displaced step was being finished, if resuming RESUME_PTID with SIG
+   will let it run.  SIG is the signal the current thread is being
+   resumed with; return the one to resume it with instead.  */
+
+static enum target_signal
+displaced_step_deliver_pending (ptid_t resume_ptid, enum target_signal sig)
+{
+  ptid_t ptid = displaced_step_pending_ptid;
+  enum target_signal pending = displaced_step_pending_signal;
+
+  if (pending == TARGET_SIGNAL_0)
+    return sig;
+  if (!in_thread_list (ptid))
+    {
+      displaced_step_pending_signal = TARGET_SIGNAL_0;
+      return sig;
+    }
+
+  if (ptid_equal (ptid, inferior_ptid))
+    {
+      /* The user's choice of signal wins; ours waits for the next
+	 resume.  */
+      if (sig != TARGET_SIGNAL_0)
+	return sig;
+      sig = pending;
+    }
+  else if (ptid_equal (resume_ptid, RESUME_ALL))
+    target_resume (ptid, 0, pending);
+  else
+    return sig;
+
+  if (debug_infrun)
+    fprintf_unfiltered (gdb_stdlog,
+			"infrun: displaced: delivering %s to %s\n",
+			target_signal_to_name (pending),
+			target_pid_to_str (ptid));
+  displaced_step_pending_signal = TARGET_SIGNAL_0;
+  return sig;
+}
+/* APPLE LOCAL end displaced stepping */
+
+/* APPLE LOCAL begin non-stop */
+/* Non-stop mode.
+
+   Normally, when any thread stops, GDB stops all of them, and
+   resuming resumes them all.  In non-stop mode only the thread that
+   reported an event is stopped; the others keep running, and resuming
+   resumes only the current thread.  Breakpoints then have to stay
+   inserted the whole time, so a thread is stepped over a breakpoint
+   with displaced stepping, and the target is told to leave the other
+   threads alone when one of them stops.  */
+
+int non_stop = 0;
+static int non_stop_1 = 0;
+
+static void
+set_non_stop (char *args, int from_tty, struct cmd_list_element *c)
+{
+  if (target_has_execution)
+    {
+      non_stop_1 = non_stop;
+      error (_("Cannot change this setting while the inferior is running."));
+    }
+
+  non_stop = non_stop_1;
+}
+
+static void
+show_non_stop (struct ui_file *file, int from_tty,
+	       struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("\
+Controlling the inferior in non-stop mode is %s.\n"), value);
+}
+/* APPLE LOCAL end non-stop */
+
+
 /* Resume the inferior, but allow a QUIT.  This is useful if the user
    wants to interrupt some lengthy single-stepping operation
    (for child processes, the SIGINT goes to the inferior, and so
@@ -767,6 +1061,38 @@ resume (int step, enum target_signal sig)
     {
       ptid_t resume_ptid;
 
+      /* APPLE LOCAL begin displaced stepping */
+      /* A signal held back from this thread goes with it now, before
+	 deciding how to step it.  */
+      if (sig == TARGET_SIGNAL_0)
+	sig = displaced_step_deliver_pending (inferior_ptid, sig);
+
+      /* Step over the breakpoint out of line, with the breakpoints
+	 back in, so that the other threads can be resumed too.  */
+      if (use_displaced_stepping (step, sig) && displaced_step_prepare ())
+	{
+	  if (breakpoints_inserted)
+	    ;
+	  else if (insert_breakpoints () == 0)
+	    breakpoints_inserted = 1;
+	  else
+	    {
+	      remove_breakpoints ();
+	      displaced_step_cancel ();
+	    }
+	}
+      /* APPLE LOCAL end displaced stepping */
+
+      /* APPLE LOCAL begin non-stop */
+      /* Stepping over a breakpoint the old way would mean pulling it
+	 out from under the threads that are still running.  */
+      if (non_stop && step && !displaced_step_in_progress
+	  && breakpoints_inserted
+	  && breakpoint_here_p (read_pc ()) == ordinary_breakpoint_here)
+	error (_("\
+Cannot step over a breakpoint in non-stop mode without displaced stepping."));
+      /* APPLE LOCAL end non-stop */
+
       resume_ptid = RESUME_ALL;	/* Default */
 
       if ((step || singlestep_breakpoints_inserted_p)
@@ -802,6 +1128,10 @@ resume (int step, enum target_signal sig)
 	  resume_ptid = inferior_ptid;
 	}
 
+      /* APPLE LOCAL non-stop: Only ever resume the current thread.  */
+      if (non_stop)
+	resume_ptid = inferior_ptid;
+
       if (CANNOT_STEP_BREAKPOINT)
 	{
 	  /* Most targets can step a breakpoint instruction, thus
@@ -810,7 +1140,17 @@ resume (int step, enum target_signal sig)
 	  if (step && breakpoints_inserted && breakpoint_here_p (read_pc ()))
 	    step = 0;
 	}
+      /* APPLE LOCAL displaced stepping */
+      sig = displaced_step_deliver_pending (resume_ptid, sig);
       target_resume (resume_ptid, step, sig);
+
+      /* APPLE LOCAL begin non-stop */
+      if (non_stop)
+	{
+	  set_running (resume_ptid, 1);
+	  observer_notify_target_resumed (resume_ptid);
+	}
+      /* APPLE LOCAL end non-stop */
     }
 
   discard_cleanups (old_cleanups);
@@ -851,6 +1191,11 @@ prepare_to_proceed (void)
   ptid_t wait_ptid;
   struct target_waitstatus wait_status;
 
+  /* APPLE LOCAL non-stop: Every thread is resumed on its own; never
+     switch away from the one the user selected.  */
+  if (non_stop)
+    return 0;
+
   /* Get the last target status returned by target_wait().  */
   get_last_target_status (&wait_ptid, &wait_status);
 
@@ -933,6 +1278,10 @@ proceed (CORE_ADDR addr, enum target_signal siggnal, int step)
 {
   int oneproc = 0;
 
+  /* APPLE LOCAL non-stop */
+  if (non_stop && is_running (inferior_ptid))
+    error (_("Thread is running."));
+
 #if 0
   /* APPLE LOCAL begin checkpoints */
   /* Warn the user about attempts to continue forward from any
@@ -1008,7 +1357,12 @@ proceed (CORE_ADDR addr, enum target_signal siggnal, int step)
     /* We will get a trace trap after one instruction.
        Continue it automatically and insert breakpoints then.  */
     trap_expected = 1;
-  else
+
+  /* APPLE LOCAL non-stop: The other threads may be running, so
+     breakpoints go in now, and stay in while this one steps over its
+     breakpoint out of line.  This also picks up breakpoints set since
+     the last stop.  */
+  if (!oneproc || non_stop)
     {
       insert_breakpoints ();
       /* If we get here there was no call to error() in 
@@ -1121,6 +1475,11 @@ init_wait_for_inferior (void)
   clear_proceed_status ();
 
   stepping_past_singlestep_breakpoint = 0;
+
+  /* APPLE LOCAL begin displaced stepping */
+  displaced_step_clear ();
+  displaced_step_pending_signal = TARGET_SIGNAL_0;
+  /* APPLE LOCAL end displaced stepping */
 }
 
 /* This enum encodes possible reasons for doing a target_wait, so that
@@ -1488,6 +1847,96 @@ adjust_pc_after_break (struct execution_control_state *ecs)
     }
 }
 
+/* APPLE LOCAL begin displaced stepping */
+/* Called at the start of handle_inferior_event while a displaced step
+   is in progress.  Return non-zero if ECS is the displaced thread
+   finishing its step; it has been fixed up already, and its PC needs
+   no adjusting for the breakpoint.  */
+
+static int
+displaced_step_handle_event (struct execution_control_state *ecs)
+{
+  struct target_waitstatus ws;
+  enum target_signal sig;
+
+  if (ecs->ws.kind == TARGET_WAITKIND_EXITED
+      || ecs->ws.kind == TARGET_WAITKIND_SIGNALLED)
+    {
+      /* The scratch area went with the process.  */
+      displaced_step_clear ();
+      return 0;
+    }
+
+  if (ptid_equal (ecs->ptid, displaced_step_ptid))
+    {
+      sig = (ecs->ws.kind == TARGET_WAITKIND_STOPPED
+	     ? ecs->ws.value.sig : TARGET_SIGNAL_0);
+      displaced_step_fixup (sig);
+      if (sig == TARGET_SIGNAL_TRAP)
+	return 1;
+
+      /* The instruction didn't run.  Go back to stepping over the
+	 breakpoint the old way, with breakpoints removed.  */
+      if (breakpoints_inserted && remove_breakpoints () == 0)
+	breakpoints_inserted = 0;
+      return 0;
+    }
+
+  /* Another thread got in first.  Finish the step before looking at
+     its event.  In all-stop mode the displaced thread has been stopped
+     too; if it hadn't reached the instruction yet, put it back at the
+     breakpoint, to hit it again, without running it, so that anything
+     the target holds for it is still reported later.  Otherwise
+     collect its trap.  If it stops with a signal instead, it is put
+     back at the breakpoint, and the signal is delivered the next time
+     the thread is resumed; in non-stop mode, where nothing stopped it,
+     that is right away.  */
+  if (debug_infrun)
+    fprintf_unfiltered (gdb_stdlog,
+			"infrun: displaced: finishing %s for event in %s\n",
+			target_pid_to_str (displaced_step_ptid),
+			target_pid_to_str (ecs->ptid));
+
+  if (!non_stop && read_pc_pid (displaced_step_ptid) == displaced_step_copy)
+    {
+      displaced_step_cancel ();
+      trap_expected = 0;
+      return 0;
+    }
+
+  target_wait (displaced_step_ptid, &ws, NULL);
+  registers_changed ();
+
+  if (ws.kind == TARGET_WAITKIND_EXITED
+      || ws.kind == TARGET_WAITKIND_SIGNALLED)
+    displaced_step_clear ();
+  else
+    {
+      sig = (ws.kind == TARGET_WAITKIND_STOPPED
+	     ? ws.value.sig : TARGET_SIGNAL_0);
+      displaced_step_fixup (sig);
+      if (sig != TARGET_SIGNAL_TRAP && sig != TARGET_SIGNAL_0
+	  && signal_pass_state (sig))
+	{
+	  /* In non-stop mode the thread is still running as far as the
+	     user knows.  */
+	  if (non_stop)
+	    target_resume (displaced_step_ptid, 0, sig);
+	  else
+	    {
+	      displaced_step_pending_signal = sig;
+	      displaced_step_pending_ptid = displaced_step_ptid;
+	    }
+	}
+    }
+
+  /* Either way the displaced thread is no longer expecting a trap; the
+     event we're about to handle isn't it.  */
+  trap_expected = 0;
+  return 0;
+}
+/* APPLE LOCAL end displaced stepping */
+
 /* Given an execution control state that has been freshly filled in
    by an event from the inferior, figure out what it means and take
    appropriate action.  */
@@ -1515,7 +1964,17 @@ handle_inferior_event (struct execution_control_state *ecs)
   target_last_wait_ptid = ecs->ptid;
   target_last_waitstatus = *ecs->wp;
 
-  adjust_pc_after_break (ecs);
+  /* APPLE LOCAL non-stop: Only the thread reporting the event has
+     stopped; the target left the others running.  */
+  if (non_stop)
+    set_running (ecs->ptid, 0);
+
+  /* APPLE LOCAL begin displaced stepping */
+  /* A finished displaced step is fixed up to its original address,
+     which is not where the breakpoint trap left it.  */
+  if (!displaced_step_in_progress || !displaced_step_handle_event (ecs))
+    adjust_pc_after_break (ecs);
+  /* APPLE LOCAL end displaced stepping */
 
   switch (ecs->infwait_state)
     {
@@ -1920,6 +2379,19 @@ handle_inferior_event (struct execution_control_state *ecs)
 	  /* Saw a breakpoint, but it was hit by the wrong thread.
 	     Just continue. */
 
+	  /* APPLE LOCAL begin non-stop */
+	  /* Step just that thread over the breakpoint, out of line; the
+	     breakpoints stay in for everyone else.  */
+	  if (non_stop)
+	    {
+	      if (!ptid_equal (inferior_ptid, ecs->ptid))
+		context_switch (ecs);
+	      ecs->another_trap = 1;
+	      keep_going (ecs);
+	      return;
+	    }
+	  /* APPLE LOCAL end non-stop */
+
 	  if (SOFTWARE_SINGLE_STEP_P () && singlestep_breakpoints_inserted_p)
 	    {
 	      /* Pull the single step breakpoints out of the target. */
@@ -2408,11 +2880,15 @@ extern void macosx_print_extra_stop_info (int, CORE_ADDR);
       case BPSTAT_WHAT_SINGLE:
         if (debug_infrun)
 	  fprintf_unfiltered (gdb_stdlog, "infrun: BPSTATE_WHAT_SINGLE\n");
-	if (breakpoints_inserted)
+	/* APPLE LOCAL non-stop: Step over it out of line instead.  */
+	if (!non_stop)
 	  {
-	    remove_breakpoints ();
+	    if (breakpoints_inserted)
+	      {
+		remove_breakpoints ();
+	      }
+	    breakpoints_inserted = 0;
 	  }
-	breakpoints_inserted = 0;
 	ecs->another_trap = 1;
 	/* Still need to check other stuff, at least the case
 	   where we are stepping and step out of the right range.  */
@@ -2473,8 +2949,12 @@ extern void macosx_print_extra_stop_info (int, CORE_ADDR);
 	       were trying to single-step off a breakpoint.  Go back
 	       to doing that.  */
 	    ecs->step_after_step_resume_breakpoint = 0;
-	    remove_breakpoints ();
-	    breakpoints_inserted = 0;
+	    /* APPLE LOCAL non-stop */
+	    if (!non_stop)
+	      {
+		remove_breakpoints ();
+		breakpoints_inserted = 0;
+	      }
 	    ecs->another_trap = 1;
 	    keep_going (ecs);
 	    return;
@@ -2564,6 +3044,8 @@ extern void macosx_print_extra_stop_info (int, CORE_ADDR);
 	      struct breakpoint *b;
               /* APPLE LOCAL end cf comment by "solib_step_bp".  */
 
+	      /* APPLE LOCAL deferred solib symbols */
+	      stopped_for_solib_event = stop_on_solib_events && solib_changed;
 	      stop_stepping (ecs);
 
               /* APPLE LOCAL begin cf comment by "solib_step_bp".  */
@@ -3513,6 +3995,10 @@ prepare_to_wait (struct execution_control_state *ecs)
 
       registers_changed ();
       ecs->waiton_ptid = pid_to_ptid (-1);
+      /* APPLE LOCAL non-stop: Nobody else is going to finish the
+	 displaced step for us; wait for it before anything else.  */
+      if (non_stop && displaced_step_in_progress)
+	ecs->waiton_ptid = displaced_step_ptid;
       ecs->wp = &(ecs->ws);
     }
   /* This is the old end of the while loop.  Let everybody know we
@@ -3655,6 +4141,11 @@ normal_stop (void)
 {
   struct target_waitstatus last;
   ptid_t last_ptid;
+  /* APPLE LOCAL deferred solib symbols */
+  int solib_event_stop = stopped_for_solib_event;
+
+  /* APPLE LOCAL deferred solib symbols */
+  stopped_for_solib_event = 0;
 
   get_last_target_status (&last_ptid, &last);
 
@@ -3687,7 +4178,9 @@ normal_stop (void)
        DECR_PC_AFTER_BREAK needs to just go away.  */
     deprecated_update_frame_pc_hack (get_current_frame (), read_pc ());
 
-  if (target_has_execution && breakpoints_inserted)
+  /* APPLE LOCAL non-stop: The other threads are still running, and
+     need the breakpoints left in.  */
+  if (target_has_execution && breakpoints_inserted && !non_stop)
     {
       if (remove_breakpoints ())
 	{
@@ -3698,7 +4191,8 @@ It might be running in another process.\n\
 Further execution is probably impossible.\n"));
 	}
     }
-  breakpoints_inserted = 0;
+  if (!non_stop || !target_has_execution)
+    breakpoints_inserted = 0;
 
   /* APPLE LOCAL: omission of breakpoint_auto_delete call.  */
 
@@ -3715,6 +4209,13 @@ Further execution is probably impossible.\n"));
 
   target_terminal_ours ();
 
+  /* APPLE LOCAL deferred solib symbols: Finish reading the shared
+     libraries the program loaded while it ran.  Stopping at the
+     library load itself doesn't count; whoever asked for that stop
+     mostly wants to look at the library list and go on.  */
+  if (target_has_execution && !solib_event_stop)
+    solib_read_deferred_symbols ();
+
   /* APPLE LOCAL: I moved the call to the stop_command from here
      to after the stack is set up.  Otherwise, commands called in
      the stop hook will get the wrong current_sal.  */
@@ -4972,6 +5473,43 @@ function is skipped and the step command stops at a different source line."),
 			   show_step_stop_if_no_debug,
 			   &setlist, &showlist);
 
+  /* APPLE LOCAL begin displaced stepping */
+  add_setshow_boolean_cmd ("displaced-stepping", class_run,
+			   &can_use_displaced_stepping, _("\
+Set debugger's willingness to use displaced stepping."), _("\
+Show debugger's willingness to use displaced stepping."), _("\
+If on, the debugger steps a thread over a breakpoint by copying the\n\
+instruction to a scratch area and stepping the copy, leaving the\n\
+breakpoint inserted and the other threads running.  If off, or if the\n\
+architecture can't do this, all breakpoints are removed and only that\n\
+thread is stepped."),
+			   NULL,
+			   show_can_use_displaced_stepping,
+			   &setlist, &showlist);
+  /* APPLE LOCAL end displaced stepping */
+
+  /* APPLE LOCAL begin non-stop */
+  add_setshow_boolean_cmd ("non-stop", no_class,
+			   &non_stop_1, _("\
+Set whether gdb controls the inferior in non-stop mode."), _("\
+Show whether gdb controls the inferior in non-stop mode."), _("\
+When debugging a multi-threaded program and this setting is\n\
+off (the default, also called all-stop mode), when one thread stops\n\
+(for a breakpoint, watchpoint, exception, or similar events), GDB stops\n\
+all other threads in the program while you interact with the thread of\n\
+interest.  When you continue or step a thread, you can allow the other\n\
+threads to run, or have them remain stopped, but while you inspect any\n\
+thread's state, all threads stop.\n\
+\n\
+In non-stop mode, when one thread stops, other threads can continue\n\
+to run freely.  You'll be able to step each thread independently,\n\
+leave it stopped or free to run as needed.  This can only be changed\n\
+while there is no running inferior."),
+			   set_non_stop,
+			   show_non_stop,
+			   &setlist, &showlist);
+  /* APPLE LOCAL end non-stop */
+
   /* APPLE LOCAL: minimal-signal-handling mode.  */
   add_setshow_boolean_cmd ("minimal-signal-handling", class_run, &minimal_signal_handling,
 			   "Set whether we run with a minimal signal handling set.",
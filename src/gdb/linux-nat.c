@@ -43,6 +43,15 @@
 #include "gdbthread.h"		/* for struct thread_info etc. */
 #include "gdb_stat.h"		/* for struct stat */
 #include <fcntl.h>		/* for O_RDONLY */
+/* APPLE LOCAL batched stop */
+#include <sys/time.h>		/* for gettimeofday */
+/* APPLE LOCAL lwp hash */
+#include "hashtab.h"		/* for htab_t */
+/* APPLE LOCAL page watchpoints */
+#include "objfiles.h"		/* for entry_point_address */
+#include "breakpoint.h"		/* for hw_write */
+#include <sys/mman.h>		/* for PROT_* */
+#include <signal.h>		/* for siginfo_t, SEGV_ACCERR */
 
 #ifndef O_LARGEFILE
 #define O_LARGEFILE 0
@@ -74,6 +83,12 @@
 
 #endif /* PTRACE_EVENT_FORK */
 
+/* APPLE LOCAL begin page watchpoints */
+#ifndef PTRACE_GETSIGINFO
+#define PTRACE_GETSIGINFO	0x4202
+#endif
+/* APPLE LOCAL end page watchpoints */
+
 /* We can't always assume that this flag is available, but all systems
    with the ptrace event handlers also have __WALL, so it's safe to use
    here.  */
@@ -109,6 +124,9 @@ static int linux_supports_tracefork_flag = -1;
 
 static int linux_supports_tracevforkdone_flag = -1;
 
+/* APPLE LOCAL page watchpoints */
+static void page_watch_reprotect (void);
+
 
 /* Trivial list manipulation functions to keep track of a list of
    new stopped processes.  */
@@ -421,6 +439,8 @@ child_follow_fork (int follow_child)
 	  /* Since we vforked, breakpoints were removed in the parent
 	     too.  Put them back.  */
 	  reattach_breakpoints (parent_pid);
+	  /* APPLE LOCAL page watchpoints */
+	  page_watch_reprotect ();
 	}
     }
   else
@@ -649,6 +669,26 @@ static int threaded;
 #define is_lwp(ptid)		(GET_LWP (ptid) != 0)
 #define BUILD_LWP(lwp, pid)	ptid_build (pid, lwp, 0)
 
+/* APPLE LOCAL begin lwp hash */
+/* The LWPs on LWP_LIST, keyed by LWP id, so that find_lwp_pid
+   doesn't have to walk the list.  The list still owns the entries.  */
+static htab_t lwp_table;
+
+static hashval_t
+hash_lwp (const void *p)
+{
+  const struct lwp_info *lp = p;
+  return (hashval_t) GET_LWP (lp->ptid);
+}
+
+static int
+eq_lwp (const void *p, const void *key)
+{
+  const struct lwp_info *lp = p;
+  return GET_LWP (lp->ptid) == *(const int *) key;
+}
+/* APPLE LOCAL end lwp hash */
+
 /* If the last reported event was a SIGTRAP, this variable is set to
    the process id of the LWP/thread that got it.  */
 ptid_t trap_ptid;
@@ -720,6 +760,9 @@ init_lwp_list (void)
     }
 
   lwp_list = NULL;
+  /* APPLE LOCAL lwp hash */
+  if (lwp_table != NULL)
+    htab_empty (lwp_table);
   num_lwps = 0;
   threaded = 0;
 }
@@ -745,6 +788,21 @@ add_lwp (ptid_t ptid)
 
   lp->next = lwp_list;
   lwp_list = lp;
+
+  /* APPLE LOCAL begin lwp hash */
+  {
+    int lwp = GET_LWP (ptid);
+    void **slot;
+
+    if (lwp_table == NULL)
+      lwp_table = htab_create_alloc (64, hash_lwp, eq_lwp, NULL,
+				     xcalloc, xfree);
+    slot = htab_find_slot_with_hash (lwp_table, &lwp, (hashval_t) lwp,
+				     INSERT);
+    *slot = lp;
+  }
+  /* APPLE LOCAL end lwp hash */
+
   if (++num_lwps > 1)
     threaded = 1;
 
@@ -771,6 +829,18 @@ delete_lwp (ptid_t ptid)
      becomes less than two.  */
   num_lwps--;
 
+  /* APPLE LOCAL begin lwp hash */
+  {
+    int lwp = GET_LWP (lp->ptid);
+    void **slot;
+
+    slot = htab_find_slot_with_hash (lwp_table, &lwp, (hashval_t) lwp,
+				     NO_INSERT);
+    if (slot != NULL && *slot == lp)
+      htab_clear_slot (lwp_table, slot);
+  }
+  /* APPLE LOCAL end lwp hash */
+
   if (lpprev)
     lpprev->next = lp->next;
   else
@@ -785,7 +855,6 @@ delete_lwp (ptid_t ptid)
 static struct lwp_info *
 find_lwp_pid (ptid_t ptid)
 {
-  struct lwp_info *lp;
   int lwp;
 
   if (is_lwp (ptid))
@@ -793,11 +862,11 @@ find_lwp_pid (ptid_t ptid)
   else
     lwp = GET_PID (ptid);
 
-  for (lp = lwp_list; lp; lp = lp->next)
-    if (lwp == GET_LWP (lp->ptid))
-      return lp;
-
-  return NULL;
+  /* APPLE LOCAL begin lwp hash */
+  if (lwp_table == NULL)
+    return NULL;
+  return htab_find_with_hash (lwp_table, &lwp, (hashval_t) lwp);
+  /* APPLE LOCAL end lwp hash */
 }
 
 /* Call CALLBACK with its second argument set to DATA for every LWP in
@@ -889,6 +958,12 @@ lin_lwp_attach_lwp (ptid_t ptid, int verbose)
 			      status_to_str (status));
 	}
     }
+  /* APPLE LOCAL begin non-stop */
+  /* In non-stop mode an LWP we already know about may well be
+     running; leave its state alone.  */
+  else if (non_stop && found_lp != NULL)
+    ;
+  /* APPLE LOCAL end non-stop */
   else
     {
       /* We assume that the LWP representing the original process is
@@ -901,6 +976,19 @@ lin_lwp_attach_lwp (ptid_t ptid, int verbose)
     }
 }
 
+/* APPLE LOCAL begin non-stop */
+/* Return non-zero if the LWP PTID has been resumed and has not
+   stopped since.  */
+
+int
+linux_nat_lwp_running (ptid_t ptid)
+{
+  struct lwp_info *lp = find_lwp_pid (ptid);
+
+  return lp != NULL && lp->resumed && !lp->stopped;
+}
+/* APPLE LOCAL end non-stop */
+
 static void
 linux_nat_attach (char *args, int from_tty)
 {
@@ -1069,7 +1157,9 @@ linux_nat_resume (ptid_t ptid, int step, enum target_signal signo)
 
   if (resume_all)
     iterate_over_lwps (resume_set_callback, NULL);
-  else
+  /* APPLE LOCAL non-stop: The other LWPs may be running on their own;
+     leave them be.  */
+  else if (!non_stop)
     iterate_over_lwps (resume_clear_callback, NULL);
 
   /* If PID is -1, it's the current inferior that should be
@@ -1162,6 +1252,17 @@ linux_nat_handle_extended (struct lwp_info *lp, int status)
       new_lp->cloned = 1;
       new_lp->stopped = 1;
 
+      /* APPLE LOCAL begin non-stop */
+      /* Nothing is going to stop the world and resume everyone in
+	 non-stop mode; let the new LWP run straight away.  */
+      if (non_stop)
+	{
+	  new_lp->stopped = 0;
+	  new_lp->resumed = 1;
+	  ptrace (PTRACE_CONT, GET_LWP (new_lp->ptid), 0, 0);
+	}
+      /* APPLE LOCAL end non-stop */
+
       lp->waitstatus.kind = TARGET_WAITKIND_IGNORE;
 
       if (debug_linux_nat)
@@ -1432,6 +1533,218 @@ stop_wait_callback (struct lwp_info *lp, void *data)
   return 0;
 }
 
+/* APPLE LOCAL begin batched stop */
+/* The number of microseconds from START to END.  */
+
+static long
+elapsed_usec (struct timeval *start, struct timeval *end)
+{
+  return ((end->tv_sec - start->tv_sec) * 1000000L
+	  + (end->tv_usec - start->tv_usec));
+}
+
+/* LP has exited, or vanished, while we were waiting for it to stop.
+   Forget about it, as wait_lwp does.  */
+
+static void
+stop_wait_lwp_dead (struct lwp_info *lp)
+{
+  if (in_thread_list (lp->ptid))
+    {
+      /* Core GDB cannot deal with us deleting the current thread.  */
+      if (!ptid_equal (lp->ptid, inferior_ptid))
+	delete_thread (lp->ptid);
+      printf_unfiltered (_("[%s exited]\n"),
+			 target_pid_to_str (lp->ptid));
+    }
+
+  delete_lwp (lp->ptid);
+}
+
+/* LP has reported the SIGSTOP we sent it.  Send back any signals we
+   had to take out of its way.  */
+
+static void
+stop_wait_lwp_stopped (struct lwp_info *lp)
+{
+  int sig;
+
+  lp->stopped = 1;
+  lp->signalled = 0;
+
+  for (sig = 1; sig < NSIG; sig++)
+    if (sigismember (&lp->requeue_signals, sig))
+      {
+	if (debug_linux_nat)
+	  fprintf_unfiltered (gdb_stdlog, "SWA: kill %s, %s\n",
+			      target_pid_to_str (lp->ptid), strsignal (sig));
+	kill_lwp (GET_LWP (lp->ptid), sig);
+      }
+  sigemptyset (&lp->requeue_signals);
+}
+
+/* Handle STATUS, an event that LP reported while we were waiting for
+   it to stop.  This is stop_wait_callback unrolled: instead of
+   waiting on LP again right away, we resume it if necessary and let
+   the caller's wait loop pick up its next event.  Return non-zero if
+   LP is now stopped (or gone).  */
+
+static int
+stop_wait_lwp_event (struct lwp_info *lp, int status, sigset_t *flush_mask)
+{
+  if (WIFEXITED (status) || WIFSIGNALED (status))
+    {
+      if (debug_linux_nat)
+	fprintf_unfiltered (gdb_stdlog, "SWA: %s exited.\n",
+			    target_pid_to_str (lp->ptid));
+      stop_wait_lwp_dead (lp);
+      return 1;
+    }
+
+  gdb_assert (WIFSTOPPED (status));
+
+  /* Handle GNU/Linux's extended waitstatus for trace events.  A clone
+     event is swallowed, and the LWP resumed; anything else is treated
+     like any other SIGTRAP.  */
+  if (WSTOPSIG (status) == SIGTRAP && status >> 16 != 0)
+    {
+      if (debug_linux_nat)
+	fprintf_unfiltered (gdb_stdlog,
+			    "SWA: Handling extended status 0x%06x\n",
+			    status);
+      if (linux_nat_handle_extended (lp, status))
+	return 0;
+    }
+
+  if (WSTOPSIG (status) == SIGSTOP)
+    {
+      /* We caught the SIGSTOP that we intended to catch, so there's
+	 no SIGSTOP pending.  */
+      stop_wait_lwp_stopped (lp);
+      return 1;
+    }
+
+  /* Ignore any signals in FLUSH_MASK.  */
+  if (flush_mask && sigismember (flush_mask, WSTOPSIG (status))
+      && !lp->signalled)
+    {
+      lp->stopped = 1;
+      return 1;
+    }
+
+  if (!(flush_mask && sigismember (flush_mask, WSTOPSIG (status))))
+    {
+      /* Hold on to this event.  As in stop_wait_callback, a SIGTRAP
+	 we are already holding takes precedence; otherwise the latest
+	 event wins.  Whichever event we don't keep goes back to the
+	 LWP once it has stopped.  */
+      if (debug_linux_nat)
+	fprintf_unfiltered (gdb_stdlog,
+			    "SWA: Pending event %s in %s\n",
+			    status_to_str (status),
+			    target_pid_to_str (lp->ptid));
+
+      if (lp->status == 0)
+	lp->status = status;
+      else if (WSTOPSIG (lp->status) == SIGTRAP)
+	sigaddset (&lp->requeue_signals, WSTOPSIG (status));
+      else
+	{
+	  sigaddset (&lp->requeue_signals, WSTOPSIG (lp->status));
+	  lp->status = status;
+	}
+    }
+
+  /* Now resume this LWP and get the SIGSTOP event.  */
+  errno = 0;
+  ptrace (PTRACE_CONT, GET_LWP (lp->ptid), 0, 0);
+  if (debug_linux_nat)
+    fprintf_unfiltered (gdb_stdlog,
+			"SWA: PTRACE_CONT %s, 0, 0 (%s)\n",
+			target_pid_to_str (lp->ptid),
+			errno ? safe_strerror (errno) : "OK");
+  return 0;
+}
+
+/* Wait until every LWP we sent a SIGSTOP to has stopped.  This does
+   the same job as iterating stop_wait_callback over the LWP list, but
+   instead of waiting for each LWP in turn - two waitpid calls per
+   cloned LWP, in list order - it reaps events from all of them with a
+   single __WALL wait loop, in whatever order they arrive.  FLUSH_MASK
+   is as for stop_wait_callback.  */
+
+static void
+stop_wait_all_lwps (sigset_t *flush_mask)
+{
+  struct lwp_info *lp, *lpnext;
+  int running = 0;
+
+  for (lp = lwp_list; lp; lp = lp->next)
+    if (!lp->stopped)
+      {
+	gdb_assert (lp->status == 0);
+	sigemptyset (&lp->requeue_signals);
+	running++;
+      }
+
+  while (running > 0)
+    {
+      pid_t pid;
+      int status;
+
+      pid = my_waitpid (-1, &status, __WALL);
+      if (pid == -1)
+	{
+	  /* No children left to wait for: the remaining LWPs must have
+	     exited without telling us (see wait_lwp).  */
+	  for (lp = lwp_list; lp; lp = lpnext)
+	    {
+	      lpnext = lp->next;
+	      if (!lp->stopped)
+		{
+		  if (debug_linux_nat)
+		    fprintf_unfiltered (gdb_stdlog, "SWA: %s vanished.\n",
+					target_pid_to_str (lp->ptid));
+		  stop_wait_lwp_dead (lp);
+		}
+	    }
+	  break;
+	}
+
+      if (debug_linux_nat)
+	fprintf_unfiltered (gdb_stdlog, "SWA: waitpid %ld received %s\n",
+			    (long) pid, status_to_str (status));
+
+      lp = find_lwp_pid (pid_to_ptid (pid));
+
+      /* As in linux_nat_wait: a new process stopping may be reported
+	 before or after the fork or clone event that created it, so
+	 remember it for linux_handle_extended_wait.  Exits of
+	 processes we don't know about are of no interest.  */
+      if (lp == NULL)
+	{
+	  if (WIFSTOPPED (status))
+	    linux_record_stopped_pid (pid);
+	  continue;
+	}
+
+      if (lp->stopped)
+	{
+	  /* We shouldn't get events from an LWP that we think is
+	     stopped; keep the event rather than lose it.  */
+	  if (lp->status == 0)
+	    lp->status = status;
+	  else if (WIFSTOPPED (status))
+	    kill_lwp (GET_LWP (lp->ptid), WSTOPSIG (status));
+	  continue;
+	}
+
+      if (stop_wait_lwp_event (lp, status, flush_mask))
+	running--;
+    }
+}
+/* APPLE LOCAL end batched stop */
+
 /* Check whether PID has any pending signals in FLUSH_MASK.  If so set
    the appropriate bits in PENDING, and return 1 - otherwise return 0.  */
 
@@ -1478,6 +1791,13 @@ flush_callback (struct lwp_info *lp, void *data)
     if (!linux_nat_thread_alive (lp->ptid))
       return 0;
 
+  /* APPLE LOCAL begin batched stop */
+  /* Nothing to flush, so no need to read the pending signals out of
+     /proc for every LWP on every stop.  */
+  if (sigisemptyset (flush_mask))
+    return 0;
+  /* APPLE LOCAL end batched stop */
+
   /* Just because the LWP is stopped doesn't mean that new signals
      can't arrive from outside, so this function must be careful of
      race conditions.  However, because all threads are stopped, we
@@ -1788,6 +2108,705 @@ child_wait (ptid_t ptid, struct target_waitstatus *ourstatus)
 
 #endif
 
+/* APPLE LOCAL begin page watchpoints */
+/* Page-protection watchpoints.
+
+   The x86 debug registers can watch at most four aligned words.  Past
+   that, breakpoint.c falls back to software watchpoints, which
+   single-step the program and check the value after every
+   instruction.  Instead, we can watch for writes by taking write
+   permission away from the pages that hold the watched ranges.  A
+   store to one of those pages faults with SIGSEGV; we give the page
+   its permission back, step the LWP over the store, and take the
+   permission away again.  If the store touched a watched range, the
+   SIGSEGV is reported as a watchpoint trap and breakpoint.c checks the
+   value as for any hardware watchpoint.  Otherwise the LWP is resumed
+   and the fault never leaves this file.
+
+   Page permissions are changed by having a stopped LWP call mprotect
+   itself, through LINUX_NAT_INFERIOR_MPROTECT, which the
+   architecture's native file provides.  A system call that writes to
+   a protected page fails with EFAULT rather than faulting, so such
+   writes are not seen, and the call's caller sees the error.  */
+
+int (*linux_nat_inferior_mprotect) (int lwpid, CORE_ADDR scratch,
+				    CORE_ADDR addr, ULONGEST len,
+				    int prot);
+
+/* Have the stopped LWP LWPID execute the LEN-byte instruction INSN,
+   placed at SCRATCH, starting from the general registers in REGS, an
+   elf_gregset_t.  On success, store the registers it ends up with in
+   REGS and return 0; return -1 on failure.  Either way, the memory at SCRATCH
+   and LWPID's registers are put back as they were.  Signals that
+   arrive meanwhile are sent again once we're done, so they are seen
+   by the next wait.  */
+
+int
+linux_nat_execute_insn (int lwpid, CORE_ADDR scratch,
+			const gdb_byte *insn, int len, void *regs)
+{
+#ifdef PTRACE_GETREGS
+  elf_gregset_t saved_regs;
+  long saved_word, word;
+  sigset_t deferred;
+  int status, signo, ret = -1;
+
+  gdb_assert (len <= sizeof (word));
+
+  if (ptrace (PTRACE_GETREGS, lwpid, 0, (long) &saved_regs) != 0)
+    return -1;
+
+  errno = 0;
+  saved_word = ptrace (PTRACE_PEEKTEXT, lwpid, (long) scratch, 0);
+  if (errno != 0)
+    return -1;
+  word = saved_word;
+  memcpy (&word, insn, len);
+
+  if (ptrace (PTRACE_POKETEXT, lwpid, (long) scratch, word) != 0)
+    return -1;
+
+  sigemptyset (&deferred);
+  if (ptrace (PTRACE_SETREGS, lwpid, 0, (long) regs) == 0)
+    for (;;)
+      {
+	if (ptrace (PTRACE_SINGLESTEP, lwpid, 0, 0) != 0
+	    || my_waitpid (lwpid, &status, __WALL) != lwpid
+	    || !WIFSTOPPED (status))
+	  break;
+
+	/* A signal that was pending stops the LWP before the
+	   instruction runs; hold on to it and try again.  */
+	signo = WSTOPSIG (status);
+	if (signo != SIGTRAP)
+	  {
+	    sigaddset (&deferred, signo);
+	    continue;
+	  }
+
+	if (ptrace (PTRACE_GETREGS, lwpid, 0, (long) regs) == 0)
+	  ret = 0;
+	break;
+      }
+
+  ptrace (PTRACE_POKETEXT, lwpid, (long) scratch, saved_word);
+  ptrace (PTRACE_SETREGS, lwpid, 0, (long) &saved_regs);
+
+  for (signo = 1; signo < NSIG; signo++)
+    if (sigismember (&deferred, signo))
+      kill_lwp (lwpid, signo);
+
+  return ret;
+#else
+  return -1;
+#endif
+}
+
+static int can_use_page_watchpoints = 1;
+
+static void
+show_can_use_page_watchpoints (struct ui_file *file, int from_tty,
+			       struct cmd_list_element *c,
+			       const char *value)
+{
+  fprintf_filtered (file, _("\
+Debugger's willingness to watch memory by protecting pages is %s.\n"),
+		    value);
+}
+
+/* A watched range, as inserted by breakpoint.c.  */
+
+struct page_watch
+{
+  CORE_ADDR addr;
+  int len;
+  struct page_watch *next;
+};
+
+static struct page_watch *page_watches;
+
+/* A page we have write-protected, with the number of watched ranges
+   that touch it and the protection to give back when the last one
+   goes.  */
+
+struct protected_page
+{
+  CORE_ADDR addr;
+  int refcount;
+  int prot;
+};
+
+static htab_t protected_pages;
+
+/* The process the pages are protected in.  A child forked from it
+   starts out with the same pages protected, but none of the watches
+   are its own.  */
+
+static int page_watch_pid;
+
+/* Set when the last event reported was a store to a watched range,
+   at PAGE_WATCH_DATA_ADDRESS.  */
+
+static int page_watch_triggered;
+static CORE_ADDR page_watch_data_address;
+
+/* The largest single store we expect; a fault address this close
+   below a watched range may still have written into it.  */
+
+#define PAGE_WATCH_MAX_STORE 16
+
+static CORE_ADDR
+page_watch_page_size (void)
+{
+  static CORE_ADDR page_size;
+
+  if (page_size == 0)
+    page_size = getpagesize ();
+  return page_size;
+}
+
+static hashval_t
+hash_protected_page (const void *p)
+{
+  const struct protected_page *pp = p;
+  return (hashval_t) (pp->addr / page_watch_page_size ());
+}
+
+static int
+eq_protected_page (const void *p, const void *key)
+{
+  const struct protected_page *pp = p;
+  return pp->addr == *(const CORE_ADDR *) key;
+}
+
+static struct protected_page *
+lookup_protected_page (CORE_ADDR page)
+{
+  if (protected_pages == NULL)
+    return NULL;
+  return htab_find_with_hash (protected_pages, &page,
+			      (hashval_t) (page / page_watch_page_size ()));
+}
+
+/* Return the protection, as PROT_* bits, of the mapping of the
+   current inferior that contains PAGE, or -1 if there is none.  */
+
+static int
+page_watch_mapping_prot (CORE_ADDR page)
+{
+  char filename[64];
+  char line[MAXPATHLEN + 128];
+  FILE *maps;
+  int prot = -1;
+
+  xsnprintf (filename, sizeof (filename), "/proc/%d/maps",
+	     PIDGET (inferior_ptid));
+  maps = fopen (filename, "r");
+  if (maps == NULL)
+    return -1;
+
+  while (fgets (line, sizeof (line), maps) != NULL)
+    {
+      unsigned long start, end;
+      char perms[8];
+
+      if (sscanf (line, "%lx-%lx %7s", &start, &end, perms) != 3)
+	continue;
+      if (page < start || page >= end)
+	continue;
+
+      prot = 0;
+      if (perms[0] == 'r')
+	prot |= PROT_READ;
+      if (perms[1] == 'w')
+	prot |= PROT_WRITE;
+      if (perms[2] == 'x')
+	prot |= PROT_EXEC;
+      break;
+    }
+
+  fclose (maps);
+  return prot;
+}
+
+/* Return where LWPs run the mprotect call, or zero if there is no
+   place.  The displaced stepping scratch area also lives at the
+   entry point, and another thread may be stepping through a copy
+   there in non-stop mode; start past the end of it.  */
+
+static CORE_ADDR
+page_watch_scratch (void)
+{
+  struct gdbarch *gdbarch = current_gdbarch;
+  CORE_ADDR scratch;
+
+  if (entry_point_address () == 0)
+    return 0;
+
+  scratch = gdbarch_displaced_step_location (gdbarch);
+  if (gdbarch_max_insn_length_p (gdbarch))
+    scratch += gdbarch_max_insn_length (gdbarch);
+  return scratch;
+}
+
+/* Have LWPID set the protection of LEN bytes at ADDR to PROT.  Return
+   zero on success.  */
+
+static int
+page_watch_mprotect (int lwpid, CORE_ADDR addr, ULONGEST len, int prot)
+{
+  CORE_ADDR scratch = page_watch_scratch ();
+  int ret;
+
+  if (linux_nat_inferior_mprotect == NULL || scratch == 0)
+    return -1;
+
+  /* Only a stopped LWP can be borrowed.  */
+  if (non_stop && linux_nat_lwp_running (pid_to_ptid (lwpid)))
+    return -1;
+
+  ret = linux_nat_inferior_mprotect (lwpid, scratch, addr, len, prot);
+  if (debug_linux_nat)
+    fprintf_unfiltered (gdb_stdlog,
+			"LNPW: mprotect (0x%s, %s, %d) in %d: %d\n",
+			paddr_nz (addr), paddr_u (len), prot, lwpid, ret);
+  return ret;
+}
+
+/* The LWP to run mprotect in while the inferior is stopped.  */
+
+static int
+page_watch_lwpid (void)
+{
+  return GET_LWP (inferior_ptid) ? GET_LWP (inferior_ptid)
+				 : PIDGET (inferior_ptid);
+}
+
+/* Drop one reference to each protected page from START to END,
+   giving back the original protection to pages that are no longer
+   watched.  Neighbouring pages with the same protection are given it
+   back with a single call.  */
+
+static void
+page_watch_release_pages (CORE_ADDR start, CORE_ADDR end)
+{
+  CORE_ADDR page_size = page_watch_page_size ();
+  CORE_ADDR page, run_start = 0, run_end = 0;
+  int run_prot = 0;
+  int lwpid = page_watch_lwpid ();
+
+  for (page = start; page < end; page += page_size)
+    {
+      struct protected_page *pp = lookup_protected_page (page);
+
+      if (pp == NULL || --pp->refcount > 0)
+	continue;
+
+      if (run_end != page || run_prot != pp->prot)
+	{
+	  if (run_end != run_start)
+	    page_watch_mprotect (lwpid, run_start, run_end - run_start,
+				 run_prot);
+	  run_start = page;
+	  run_prot = pp->prot;
+	}
+      run_end = page + page_size;
+
+      htab_remove_elt_with_hash (protected_pages, &page,
+				 (hashval_t) (page / page_size));
+    }
+
+  if (run_end != run_start)
+    page_watch_mprotect (lwpid, run_start, run_end - run_start, run_prot);
+}
+
+/* Return non-zero if page protection can watch LEN bytes at ADDR
+   for accesses of TYPE.  Reads can't be caught this way, so only
+   hw_write is accepted.  */
+
+int
+linux_nat_region_ok_for_page_watchpoint (CORE_ADDR addr, int len, int type)
+{
+  return (can_use_page_watchpoints
+	  && linux_nat_inferior_mprotect != NULL
+	  && type == hw_write
+	  && len > 0);
+}
+
+/* Watch LEN bytes at ADDR for writes by protecting their pages.
+   Only TYPE hw_write can be watched this way.  Return 0 on success,
+   -1 on failure.  */
+
+int
+linux_nat_insert_page_watchpoint (CORE_ADDR addr, int len, int type)
+{
+  CORE_ADDR page_size = page_watch_page_size ();
+  CORE_ADDR start = addr & ~(page_size - 1);
+  CORE_ADDR end = (addr + len + page_size - 1) & ~(page_size - 1);
+  CORE_ADDR page, run_start, run_end;
+  int run_prot = 0;
+  int lwpid = page_watch_lwpid ();
+  struct page_watch *w;
+
+  if (!linux_nat_region_ok_for_page_watchpoint (addr, len, type))
+    return -1;
+
+  if (protected_pages == NULL)
+    protected_pages = htab_create_alloc (64, hash_protected_page,
+					 eq_protected_page, xfree,
+					 xcalloc, xfree);
+  if (page_watches == NULL)
+    page_watch_pid = PIDGET (inferior_ptid);
+  else if (page_watch_pid != PIDGET (inferior_ptid))
+    return -1;
+
+  run_start = run_end = start;
+  for (page = start; page < end; page += page_size)
+    {
+      struct protected_page *pp = lookup_protected_page (page);
+      void **slot;
+      int prot;
+
+      if (pp != NULL)
+	{
+	  pp->refcount++;
+	  continue;
+	}
+
+      /* A page that can't be written needs no watching, but the
+	 mapping might be made writable later; don't pretend.  */
+      prot = page_watch_mapping_prot (page);
+      if (prot == -1 || (prot & PROT_WRITE) == 0)
+	goto fail;
+
+      if (run_end != page || run_prot != prot)
+	{
+	  if (run_end != run_start
+	      && page_watch_mprotect (lwpid, run_start, run_end - run_start,
+				      run_prot & ~PROT_WRITE) != 0)
+	    goto fail;
+	  run_start = page;
+	  run_prot = prot;
+	}
+      run_end = page + page_size;
+
+      pp = XMALLOC (struct protected_page);
+      pp->addr = page;
+      pp->refcount = 1;
+      pp->prot = prot;
+      slot = htab_find_slot_with_hash (protected_pages, &page,
+				       (hashval_t) (page / page_size),
+				       INSERT);
+      *slot = pp;
+    }
+
+  if (run_end != run_start
+      && page_watch_mprotect (lwpid, run_start, run_end - run_start,
+			      run_prot & ~PROT_WRITE) != 0)
+    goto fail;
+
+  w = XMALLOC (struct page_watch);
+  w->addr = addr;
+  w->len = len;
+  w->next = page_watches;
+  page_watches = w;
+  return 0;
+
+ fail:
+  /* Put back everything up to the page we stopped at.  */
+  page_watch_release_pages (start, page);
+  return -1;
+}
+
+/* Give back the original protection to the pages from START to END
+   in PID, a process forked from the one we watch, leaving the watches
+   in that one alone.  */
+
+static void
+page_watch_unprotect_fork (int pid, CORE_ADDR start, CORE_ADDR end)
+{
+  CORE_ADDR page_size = page_watch_page_size ();
+  CORE_ADDR page;
+
+  for (page = start; page < end; page += page_size)
+    {
+      struct protected_page *pp = lookup_protected_page (page);
+
+      if (pp != NULL)
+	page_watch_mprotect (pid, page, page_size, pp->prot);
+    }
+}
+
+/* Stop watching LEN bytes at ADDR by page protection.  Return 0 on
+   success, -1 if they weren't being watched that way.
+
+   detach_breakpoints removes the watchpoints from a forked child
+   before GDB lets go of it.  The child has inherited the protection
+   of our pages, but the watches still belong to the parent; only the
+   child's copy of the pages is given its protection back.  */
+
+int
+linux_nat_remove_page_watchpoint (CORE_ADDR addr, int len, int type)
+{
+  CORE_ADDR page_size = page_watch_page_size ();
+  CORE_ADDR start = addr & ~(page_size - 1);
+  CORE_ADDR end = (addr + len + page_size - 1) & ~(page_size - 1);
+  struct page_watch **wp, *w;
+
+  for (wp = &page_watches; *wp != NULL; wp = &(*wp)->next)
+    if ((*wp)->addr == addr && (*wp)->len == len)
+      break;
+  if (*wp == NULL)
+    return -1;
+
+  if (PIDGET (inferior_ptid) != page_watch_pid)
+    {
+      page_watch_unprotect_fork (PIDGET (inferior_ptid), start, end);
+      return 0;
+    }
+
+  w = *wp;
+  *wp = w->next;
+  xfree (w);
+
+  page_watch_release_pages (start, end);
+  return 0;
+}
+
+/* If the last event was a store to a watched range, set *ADDR_P to
+   the address stored to and return non-zero.  */
+
+int
+linux_nat_stopped_page_watch_data_address (CORE_ADDR *addr_p)
+{
+  if (!page_watch_triggered)
+    return 0;
+  if (addr_p != NULL)
+    *addr_p = page_watch_data_address;
+  return 1;
+}
+
+/* Protect every page we watch again.  The child of a vfork shares
+   the parent's pages, and removing the watches from it gave them back
+   their original protection in the parent too.  */
+
+static int
+page_watch_reprotect_1 (void **slot, void *data)
+{
+  struct protected_page *pp = *slot;
+  int lwpid = *(int *) data;
+
+  page_watch_mprotect (lwpid, pp->addr, page_watch_page_size (),
+		       pp->prot & ~PROT_WRITE);
+  return 1;
+}
+
+static void
+page_watch_reprotect (void)
+{
+  int lwpid = page_watch_lwpid ();
+
+  if (protected_pages != NULL)
+    htab_traverse (protected_pages, page_watch_reprotect_1, &lwpid);
+}
+
+/* Forget every page watch; the process they were in is gone.  */
+
+static void
+page_watch_forget (void)
+{
+  struct page_watch *w, *next;
+
+  for (w = page_watches; w != NULL; w = next)
+    {
+      next = w->next;
+      xfree (w);
+    }
+  page_watches = NULL;
+
+  if (protected_pages != NULL)
+    htab_empty (protected_pages);
+  page_watch_triggered = 0;
+}
+
+/* Resume an LWP that page_watch_stop_others stopped, as it was
+   going before.  DATA is the LWP that faulted, which is left alone.  */
+
+static int
+page_watch_resume_callback (struct lwp_info *lp, void *data)
+{
+  if (lp != data && lp->resumed && lp->stopped && lp->status == 0)
+    {
+      child_resume (pid_to_ptid (GET_LWP (lp->ptid)), lp->step,
+		    TARGET_SIGNAL_0);
+      if (debug_linux_nat)
+	fprintf_unfiltered (gdb_stdlog,
+			    "LNPW: %s %s, 0, 0 (resume sibling)\n",
+			    lp->step ? "PTRACE_SINGLESTEP" : "PTRACE_CONT",
+			    target_pid_to_str (lp->ptid));
+      lp->stopped = 0;
+    }
+  return 0;
+}
+
+/* In all-stop mode, stop every LWP but LP, so that none of them can
+   store to the pages while LP steps with them writable.  Return
+   non-zero if any were stopped; they are resumed again with
+   page_watch_resume_callback.  In non-stop mode the other LWPs keep
+   running, and a store they make in that window is missed.  */
+
+static int
+page_watch_stop_others (struct lwp_info *lp)
+{
+  if (non_stop)
+    return 0;
+
+  lp->stopped = 1;
+  iterate_over_lwps (stop_callback, NULL);
+  stop_wait_all_lwps (NULL);
+  lp->stopped = 0;
+  return 1;
+}
+
+/* LP has stopped with a SIGSEGV, in *STATUSP.  If it faulted on one
+   of our protected pages, step it over the store with the pages it
+   can touch writable.  Return non-zero if the store missed every watched range
+   and LP has been resumed, so the event should be discarded.
+   Otherwise return zero, with *STATUSP changed to a SIGTRAP if the
+   store hit a watched range or LP was being stepped anyway, or to
+   whatever else LP reported while stepping.  */
+
+static int
+linux_nat_handle_page_fault (struct lwp_info *lp, int *statusp)
+{
+  int lwpid = GET_LWP (lp->ptid);
+  CORE_ADDR page_size = page_watch_page_size ();
+  /* A store of up to PAGE_WATCH_MAX_STORE bytes that faulted at ADDR
+     can touch at most two pages; the one before ADDR's may be written
+     too if the store started there.  */
+  struct protected_page *pages[2];
+  int npages, i;
+  struct protected_page *pp;
+  struct page_watch *w;
+  CORE_ADDR addr, page, first, last;
+  siginfo_t si;
+  int status, hit, stopped;
+
+  if (protected_pages == NULL || htab_elements (protected_pages) == 0)
+    return 0;
+
+  if (ptrace (PTRACE_GETSIGINFO, lwpid, 0, &si) != 0
+      || si.si_code != SEGV_ACCERR)
+    return 0;
+
+  addr = (CORE_ADDR) (unsigned long) si.si_addr;
+  if (lookup_protected_page (addr & ~(page_size - 1)) == NULL)
+    return 0;
+
+  /* A store that straddles two pages faults on only one of them at a
+     time; make both writable, or it would fault again on the other
+     one while we step.  */
+  first = (addr < PAGE_WATCH_MAX_STORE - 1
+	   ? 0 : addr - (PAGE_WATCH_MAX_STORE - 1)) & ~(page_size - 1);
+  last = (addr + PAGE_WATCH_MAX_STORE - 1) & ~(page_size - 1);
+  npages = 0;
+  for (page = first; page <= last && npages < 2; page += page_size)
+    {
+      pp = lookup_protected_page (page);
+      if (pp != NULL)
+	pages[npages++] = pp;
+    }
+
+  stopped = page_watch_stop_others (lp);
+
+  /* Let the store through, and step over it.  */
+  for (i = 0; i < npages; i++)
+    if (page_watch_mprotect (lwpid, pages[i]->addr, page_size,
+			     pages[i]->prot) != 0)
+      {
+	while (--i >= 0)
+	  page_watch_mprotect (lwpid, pages[i]->addr, page_size,
+			       pages[i]->prot & ~PROT_WRITE);
+	if (stopped)
+	  iterate_over_lwps (page_watch_resume_callback, lp);
+	return 0;
+      }
+
+  for (;;)
+    {
+      if (ptrace (PTRACE_SINGLESTEP, lwpid, 0, 0) != 0
+	  || my_waitpid (lwpid, &status, __WALL) != lwpid)
+	{
+	  if (stopped)
+	    iterate_over_lwps (page_watch_resume_callback, lp);
+	  return 0;
+	}
+
+      /* Our own SIGSTOP, from trying to stop LP, can get in first.  */
+      if (WIFSTOPPED (status) && WSTOPSIG (status) == SIGSTOP
+	  && lp->signalled)
+	{
+	  lp->signalled = 0;
+	  continue;
+	}
+      break;
+    }
+
+  if (!WIFSTOPPED (status))
+    {
+      /* Gone; the pages went with it.  */
+      if (stopped)
+	iterate_over_lwps (page_watch_resume_callback, lp);
+      *statusp = status;
+      return 0;
+    }
+
+  for (i = 0; i < npages; i++)
+    page_watch_mprotect (lwpid, pages[i]->addr, page_size,
+			 pages[i]->prot & ~PROT_WRITE);
+
+  if (WSTOPSIG (status) != SIGTRAP)
+    {
+      /* A signal arrived before the store ran.  Report it; the store
+	 will fault again when LP is resumed.  */
+      if (stopped)
+	iterate_over_lwps (page_watch_resume_callback, lp);
+      *statusp = status;
+      return 0;
+    }
+
+  hit = 0;
+  for (w = page_watches; w != NULL; w = w->next)
+    if (addr < w->addr + w->len && w->addr < addr + PAGE_WATCH_MAX_STORE)
+      {
+	hit = 1;
+	break;
+      }
+
+  if (debug_linux_nat)
+    fprintf_unfiltered (gdb_stdlog,
+			"LNPW: store to 0x%s in %s %s\n",
+			paddr_nz (addr), target_pid_to_str (lp->ptid),
+			hit ? "hit a watched range" : "missed");
+
+  if (hit)
+    {
+      page_watch_triggered = 1;
+      page_watch_data_address = addr;
+    }
+  else if (!lp->step)
+    {
+      if (stopped)
+	iterate_over_lwps (page_watch_resume_callback, lp);
+      ptrace (PTRACE_CONT, lwpid, 0, 0);
+      return 1;
+    }
+
+  WSETSTOP (*statusp, SIGTRAP);
+  return 0;
+}
+/* APPLE LOCAL end page watchpoints */
+
 /* Stop an active thread, verify it still exists, then resume it.  */
 
 static int
@@ -1818,8 +2837,12 @@ linux_nat_wait (ptid_t ptid, struct target_waitstatus *ourstatus)
   int status = 0;
   pid_t pid = PIDGET (ptid);
   sigset_t flush_mask;
+  /* APPLE LOCAL batched stop */
+  struct timeval stop_start, stop_signalled, stop_waited, stop_flushed;
 
   sigemptyset (&flush_mask);
+  /* APPLE LOCAL page watchpoints */
+  page_watch_triggered = 0;
 
   /* Make sure SIGCHLD is blocked.  */
   if (!sigismember (&blocked_mask, SIGCHLD))
@@ -2137,6 +3160,18 @@ retry:
 
   gdb_assert (lp);
 
+  /* APPLE LOCAL begin page watchpoints */
+  /* A store to a write-protected page that missed every watched
+     range is none of GDB's business either.  */
+  if (WIFSTOPPED (status) && WSTOPSIG (status) == SIGSEGV
+      && linux_nat_handle_page_fault (lp, &status))
+    {
+      lp->stopped = 0;
+      status = 0;
+      goto retry;
+    }
+  /* APPLE LOCAL end page watchpoints */
+
   /* Don't report signals that GDB isn't interested in, such as
      signals that are neither printed nor stopped upon.  Stopping all
      threads can be a bit time-consuming so if we want decent
@@ -2188,24 +3223,54 @@ retry:
     fprintf_unfiltered (gdb_stdlog, "LLW: Candidate event %s in %s.\n",
 			status_to_str (status), target_pid_to_str (lp->ptid));
 
-  /* Now stop all other LWP's ...  */
-  iterate_over_lwps (stop_callback, NULL);
+  /* APPLE LOCAL begin non-stop */
+  /* In non-stop mode only the event LWP stops; the rest carry on, and
+     the LWP is no longer considered resumed until GDB resumes it.  */
+  if (non_stop)
+    lp->resumed = 0;
+  else
+    {
+      /* APPLE LOCAL begin batched stop */
+      if (debug_linux_nat)
+	gettimeofday (&stop_start, NULL);
 
-  /* ... and wait until all of them have reported back that they're no
-     longer running.  */
-  iterate_over_lwps (stop_wait_callback, &flush_mask);
-  iterate_over_lwps (flush_callback, &flush_mask);
+      /* Now stop all other LWP's ...  */
+      iterate_over_lwps (stop_callback, NULL);
+      if (debug_linux_nat)
+	gettimeofday (&stop_signalled, NULL);
 
-  /* If we're not waiting for a specific LWP, choose an event LWP from
-     among those that have had events.  Giving equal priority to all
-     LWPs that have had events helps prevent starvation.  */
-  if (pid == -1)
-    select_event_lwp (&lp, &status);
+      /* ... and wait until all of them have reported back that they're no
+	 longer running.  */
+      stop_wait_all_lwps (&flush_mask);
+      if (debug_linux_nat)
+	gettimeofday (&stop_waited, NULL);
 
-  /* Now that we've selected our final event LWP, cancel any
-     breakpoints in other LWPs that have hit a GDB breakpoint.  See
-     the comment in cancel_breakpoints_callback to find out why.  */
-  iterate_over_lwps (cancel_breakpoints_callback, lp);
+      iterate_over_lwps (flush_callback, &flush_mask);
+      if (debug_linux_nat)
+	{
+	  gettimeofday (&stop_flushed, NULL);
+	  fprintf_unfiltered (gdb_stdlog,
+			      "LLW: Stopped %d LWPs: signal %ld us, wait %ld us, "
+			      "flush %ld us.\n",
+			      num_lwps,
+			      elapsed_usec (&stop_start, &stop_signalled),
+			      elapsed_usec (&stop_signalled, &stop_waited),
+			      elapsed_usec (&stop_waited, &stop_flushed));
+	}
+      /* APPLE LOCAL end batched stop */
+
+      /* If we're not waiting for a specific LWP, choose an event LWP from
+	 among those that have had events.  Giving equal priority to all
+	 LWPs that have had events helps prevent starvation.  */
+      if (pid == -1)
+	select_event_lwp (&lp, &status);
+
+      /* Now that we've selected our final event LWP, cancel any
+	 breakpoints in other LWPs that have hit a GDB breakpoint.  See
+	 the comment in cancel_breakpoints_callback to find out why.  */
+      iterate_over_lwps (cancel_breakpoints_callback, lp);
+    }
+  /* APPLE LOCAL end non-stop */
 
   /* If we're not running in "threaded" mode, we'll report the bare
      process id.  */
@@ -2317,6 +3382,8 @@ linux_nat_mourn_inferior (void)
 
   /* Destroy LWP info; it's no longer valid.  */
   init_lwp_list ();
+  /* APPLE LOCAL page watchpoints */
+  page_watch_forget ();
 
   /* Restore the original signal mask.  */
   sigprocmask (SIG_SETMASK, &normal_mask, NULL);
@@ -3107,6 +4174,19 @@ Enables printf debugging output."),
 			    NULL,
 			    show_debug_linux_nat,
 			    &setdebuglist, &showdebuglist);
+
+  /* APPLE LOCAL begin page watchpoints */
+  add_setshow_boolean_cmd ("can-use-page-watchpoints", class_support,
+			   &can_use_page_watchpoints, _("\
+Set debugger's willingness to watch memory by protecting pages."), _("\
+Show debugger's willingness to watch memory by protecting pages."), _("\
+If enabled, write watchpoints that don't fit in the debug registers\n\
+are implemented by write-protecting the pages they watch, rather than\n\
+by single-stepping the program."),
+			   NULL,
+			   show_can_use_page_watchpoints,
+			   &setlist, &showlist);
+  /* APPLE LOCAL end page watchpoints */
 }
 
 
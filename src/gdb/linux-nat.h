@@ -54,6 +54,13 @@ struct lwp_info
   /* Non-zero if we were stepping this LWP.  */
   int step;
 
+  /* APPLE LOCAL begin batched stop */
+  /* Signals that arrived while stop_wait_all_lwps was waiting for
+     this LWP's SIGSTOP, and that have to be sent back to it once it
+     has stopped.  */
+  sigset_t requeue_signals;
+  /* APPLE LOCAL end batched stop */
+
   /* If WAITSTATUS->KIND != TARGET_WAITKIND_SPURIOUS, the waitstatus
      for this LWP's last event.  This may correspond to STATUS above,
      or to a local variable in lin_lwp_wait.  */
@@ -82,6 +89,35 @@ extern ptid_t linux_handle_extended_wait (int pid, int status,
 					  struct target_waitstatus *ourstatus);
 extern void linux_child_post_startup_inferior (ptid_t ptid);
 
+/* APPLE LOCAL non-stop: Non-zero if the LWP PTID is running.  */
+extern int linux_nat_lwp_running (ptid_t ptid);
+
+/* APPLE LOCAL begin page watchpoints */
+/* Write watchpoints implemented by write-protecting pages.  */
+extern int linux_nat_region_ok_for_page_watchpoint (CORE_ADDR addr, int len,
+						    int type);
+extern int linux_nat_insert_page_watchpoint (CORE_ADDR addr, int len,
+					     int type);
+extern int linux_nat_remove_page_watchpoint (CORE_ADDR addr, int len,
+					     int type);
+extern int linux_nat_stopped_page_watch_data_address (CORE_ADDR *addr_p);
+
+/* Have the stopped LWP LWPID execute the LEN-byte instruction INSN at
+   SCRATCH, starting from and updating the elf_gregset_t REGS.  Return
+   0 on success, -1 on failure.  */
+extern int linux_nat_execute_insn (int lwpid, CORE_ADDR scratch,
+				   const gdb_byte *insn, int len, void *regs);
+
+/* Have the stopped LWP LWPID call mprotect (ADDR, LEN, PROT), using
+   the instruction bytes at SCRATCH to make the system call.  Return
+   mprotect's result, or -1 if the call could not be made.  Set by the
+   architecture's native file; page watchpoints are not available if
+   it is NULL.  */
+extern int (*linux_nat_inferior_mprotect) (int lwpid, CORE_ADDR scratch,
+					   CORE_ADDR addr, ULONGEST len,
+					   int prot);
+/* APPLE LOCAL end page watchpoints */
+
 /* Iterator function for lin-lwp's lwp list.  */
 struct lwp_info *iterate_over_lwps (int (*callback) (struct lwp_info *, 
 						     void *), 
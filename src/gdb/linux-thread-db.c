@@ -35,6 +35,8 @@
 #include "target.h"
 #include "regcache.h"
 #include "solib-svr4.h"
+/* APPLE LOCAL non-stop */
+#include "linux-nat.h"
 
 #ifdef HAVE_GNU_LIBC_VERSION_H
 #include <gnu/libc-version.h>
@@ -757,6 +759,12 @@ attach_thread (ptid_t ptid, const td_thrhandle_t *th_p,
   ATTACH_LWP (BUILD_LWP (ti_p->ti_lid, GET_PID (ptid)), 0);
 #endif
 
+  /* APPLE LOCAL non-stop: A thread that turns up while the others are
+     running in non-stop mode has probably been set running itself.  */
+  if (non_stop)
+    tp->running = linux_nat_lwp_running (BUILD_LWP (ti_p->ti_lid,
+						    GET_PID (ptid)));
+
   /* Enable thread event reporting for this thread.  */
   err = td_thr_event_enable_p (th_p, 1);
   if (err != TD_OK)
@@ -551,6 +551,12 @@ macho_symfile_read (struct objfile *objfile, int mainline)
             }
         }
 
+      /* APPLE LOCAL mapped symtab: Map the nlist array so the stub
+         symbols below are decoded in place rather than read from the
+         file one at a time.  If that fails, bfd falls back to reading
+         them.  */
+      bfd_mach_o_scan_read_symtab_nlists (abfd, symtab);
+
       if (!macho_read_indirect_symbols (abfd, dysymtab, symtab, objfile))
         {
           install_minimal_symbols (objfile);
@@ -948,6 +954,8 @@ static struct sym_fns macho_sym_fns = {
   macho_symfile_read,           /* sym_read: read a symbol file into symtab */
   macho_symfile_finish,         /* sym_finish: finished with file, cleanup */
   macho_symfile_offsets,        /* sym_offsets:  xlate external to internal form */
+  /* APPLE LOCAL deferred solib symbols */
+  NULL,                         /* sym_read_psymtabs: no separate debug info pass */
   NULL                          /* next: pointer to next struct sym_fns */
 };
 
@@ -184,6 +184,8 @@ static struct sym_fns pef_sym_fns = {
   pef_symfile_read,             /* sym_read: read a symbol file into symtab */
   pef_symfile_finish,           /* sym_finish: finished with file, cleanup */
   pef_symfile_offsets,          /* sym_offsets:  xlate external to internal form */
+  /* APPLE LOCAL deferred solib symbols */
+  NULL,                         /* sym_read_psymtabs: no separate debug info pass */
   NULL                          /* next: pointer to next struct sym_fns */
 };
 
@@ -222,6 +224,8 @@ static struct sym_fns pef_xlib_sym_fns = {
   pef_xlib_symfile_read,        /* sym_read: read a symbol file into symtab */
   pef_xlib_symfile_finish,      /* sym_finish: finished with file, cleanup */
   pef_xlib_symfile_offsets,     /* sym_offsets:  xlate external to internal form */
+  /* APPLE LOCAL deferred solib symbols */
+  NULL,                         /* sym_read_psymtabs: no separate debug info pass */
   NULL                          /* next: pointer to next struct sym_fns */
 };
 
@@ -995,11 +995,8 @@ sym_read_functions (struct objfile *objfile,
       TYPE_LENGTH_ASSIGN (ftype) = 1;
       TYPE_CODE (ftype) = TYPE_CODE_FUNC;
 
-      fblock =
-        (struct block *) TYPE_ALLOC (ftype,
-                                     (sizeof (struct block) +
-                                      ((nlocals -
-                                        1) * sizeof (struct symbol *))));
+      /* APPLE LOCAL lazy function bodies: Fully initialize the block.  */
+      fblock = allocate_block (&objfile->objfile_obstack);
       fsymbol =
         (struct symbol *) obstack_alloc (&objfile->objfile_obstack,
                                          sizeof (struct symbol));
@@ -1471,6 +1468,8 @@ static struct sym_fns sym_sym_fns = {
   sym_symfile_read,             /* sym_read: read a symbol file into symtab */
   sym_symfile_finish,           /* sym_finish: finished with file, cleanup */
   sym_symfile_offsets,          /* sym_offsets:  xlate external to internal form */
+  /* APPLE LOCAL deferred solib symbols */
+  NULL,                         /* sym_read_psymtabs: no separate debug info pass */
   NULL                          /* next: pointer to next struct sym_fns */
 };
 
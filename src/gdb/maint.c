@@ -423,11 +423,33 @@ maintenance_info_sections (char *arg, int from_tty)
     }
 }
 
+/* APPLE LOCAL begin bfd cache statistics */
+static void
+print_bfd_cache_statistics (void)
+{
+  struct bfd_cache_statistics stats;
+
+  bfd_cache_get_statistics (&stats);
+  printf_filtered (_("BFD file cache statistics:\n"));
+  printf_filtered (_("  Open files (current/peak/limit): %u/%u/%u\n"),
+		   stats.open_files, stats.peak_open_files, stats.max_open);
+  printf_filtered (_("  Files opened: %lu\n"), stats.opens);
+  printf_filtered (_("  Files reopened after being closed: %lu\n"),
+		   stats.reopens);
+  printf_filtered (_("  Files closed to make room: %lu\n"), stats.evictions);
+  if (stats.changed_files > 0)
+    printf_filtered (_("  Files changed before being reopened: %lu\n"),
+		     stats.changed_files);
+}
+/* APPLE LOCAL end bfd cache statistics */
+
 void
 maintenance_print_statistics (char *args, int from_tty)
 {
   print_objfile_statistics ();
   print_symbol_bcache_statistics ();
+  /* APPLE LOCAL bfd cache statistics */
+  print_bfd_cache_statistics ();
 }
 
 static void
@@ -26,6 +26,7 @@
 #include "value.h"
 #include "mi-cmds.h"
 #include "mi-main.h"
+#include "mi-out.h"
 #include "ui-out.h"
 #include "varobj.h"
 #include "wrapper.h"
@@ -127,7 +128,10 @@ mi_cmd_stack_list_frames (char *command, char **argv, int argc)
   if (fi == NULL)
     error (_("mi_cmd_stack_list_frames: Not enough frames in stack."));
 
-  cleanup_stack = make_cleanup_ui_out_list_begin_end (uiout, "stack");
+  /* APPLE LOCAL mi streaming: Deep stacks can be shown as they are
+     walked.  */
+  cleanup_stack = mi_out_stream_begin (uiout);
+  make_cleanup_ui_out_list_begin_end (uiout, "stack");
 
   /* Now let;s print the frames up to frame_high, or until there are
      frames in the stack. */
@@ -39,6 +39,8 @@
 #include "inlining.h"
 /* APPLE LOCAL end subroutine inlining  */
 #include "gdbthread.h"
+/* APPLE LOCAL non-stop */
+#include "observer.h"
 
 struct mi_interp
 {
@@ -689,6 +691,25 @@ mi_load_progress (const char *section_name,
     }
 }
 
+/* APPLE LOCAL begin non-stop */
+/* In non-stop mode, tell the front end which threads are running, as
+   only some of them may be.  In all-stop mode ^running says it all.  */
+
+static void
+mi_on_resume (ptid_t ptid)
+{
+  if (!non_stop || !ui_out_is_mi_like_p (uiout))
+    return;
+
+  if (ptid_equal (ptid, minus_one_ptid))
+    fputs_unfiltered ("*running,thread-id=\"all\"\n", raw_stdout);
+  else
+    fprintf_unfiltered (raw_stdout, "*running,thread-id=\"%d\"\n",
+			pid_to_thread_id (ptid));
+  gdb_flush (raw_stdout);
+}
+/* APPLE LOCAL end non-stop */
+
 extern initialize_file_ftype _initialize_mi_interp; /* -Wmissing-prototypes */
 
 void
@@ -715,4 +736,7 @@ _initialize_mi_interp (void)
      the "mi" and doesn't specify a version, but chokes on mi2.  */
 
   interp_add (interp_new (INTERP_MI, NULL, mi_out_new (0), &procs));
+
+  /* APPLE LOCAL non-stop */
+  observer_attach_target_resumed (mi_on_resume);
 }
@@ -1498,6 +1498,11 @@ mi_cmd_target_unload_solib (char *command, char **argv, int argc)
 
    {addr="...",rowN={wordN="..." ,... [,ascii="..."]}, ...}
 
+   APPLE LOCAL: With -r, each row's bytes are instead returned as a
+   single string of two hex digits per byte that was read:
+
+   {addr="...",rowN={raw="..." [,ascii="..."]}, ...}
+
    Returns: 
    The number of bytes read is SIZE*ROW*COL. */
 
@@ -1519,13 +1524,18 @@ mi_cmd_data_read_memory (char *command, char **argv, int argc)
   long offset = 0;
   int optind = 0;
   char *optarg;
+  /* APPLE LOCAL mi raw memory */
+  int raw = 0;
   enum opt
     {
-      OFFSET_OPT
+      /* APPLE LOCAL mi raw memory */
+      OFFSET_OPT, RAW_OPT
     };
   static struct mi_opt opts[] =
   {
     {"o", OFFSET_OPT, 1},
+    /* APPLE LOCAL mi raw memory */
+    {"r", RAW_OPT, 0},
     {0, 0, 0},
   };
 
@@ -1540,6 +1550,11 @@ mi_cmd_data_read_memory (char *command, char **argv, int argc)
 	case OFFSET_OPT:
 	  offset = atol (optarg);
 	  break;
+	/* APPLE LOCAL begin mi raw memory */
+	case RAW_OPT:
+	  raw = 1;
+	  break;
+	/* APPLE LOCAL end mi raw memory */
 	}
     }
   argv += optind;
@@ -1547,7 +1562,7 @@ mi_cmd_data_read_memory (char *command, char **argv, int argc)
 
   if (argc < 5 || argc > 6)
     {
-      mi_error_message = xstrprintf ("mi_cmd_data_read_memory: Usage: ADDR WORD-FORMAT WORD-SIZE NR-ROWS NR-COLS [ASCHAR].");
+      mi_error_message = xstrprintf ("mi_cmd_data_read_memory: Usage: [-r] ADDR WORD-FORMAT WORD-SIZE NR-ROWS NR-COLS [ASCHAR].");
       return MI_CMD_ERROR;
     }
 
@@ -1631,7 +1646,9 @@ mi_cmd_data_read_memory (char *command, char **argv, int argc)
     struct cleanup *cleanup_list_memory;
     int row;
     int row_byte;
-    cleanup_list_memory = make_cleanup_ui_out_list_begin_end (uiout, "memory");
+    /* APPLE LOCAL mi streaming */
+    cleanup_list_memory = mi_out_stream_begin (uiout);
+    make_cleanup_ui_out_list_begin_end (uiout, "memory");
     for (row = 0, row_byte = 0;
 	 row < nr_rows;
 	 row++, row_byte += nr_cols * word_size)
@@ -1643,24 +1660,42 @@ mi_cmd_data_read_memory (char *command, char **argv, int argc)
 	cleanup_tuple = make_cleanup_ui_out_tuple_begin_end (uiout, NULL);
 	ui_out_field_core_addr (uiout, "addr", addr + row_byte);
 	/* ui_out_field_core_addr_symbolic (uiout, "saddr", addr + row_byte); */
-	cleanup_list_data = make_cleanup_ui_out_list_begin_end (uiout, "data");
-	for (col = 0, col_byte = row_byte;
-	     col < nr_cols;
-	     col++, col_byte += word_size)
+	/* APPLE LOCAL begin mi raw memory */
+	if (raw)
 	  {
-	    if (col_byte + word_size > nr_bytes)
-	      {
-		ui_out_field_string (uiout, NULL, "N/A");
-	      }
-	    else
+	    int byte;
+	    ui_file_rewind (stream->stream);
+	    for (byte = row_byte;
+		 byte < row_byte + word_size * nr_cols && byte < nr_bytes;
+		 byte++)
+	      fprintf_unfiltered (stream->stream, "%02x",
+				  (unsigned char) mbuf[byte]);
+	    ui_out_field_stream (uiout, "raw", stream);
+	  }
+	else
+	  {
+	    cleanup_list_data = make_cleanup_ui_out_list_begin_end (uiout,
+								    "data");
+	    for (col = 0, col_byte = row_byte;
+		 col < nr_cols;
+		 col++, col_byte += word_size)
 	      {
-		ui_file_rewind (stream->stream);
-		print_scalar_formatted (mbuf + col_byte, word_type, word_format,
-					word_asize, stream->stream);
-		ui_out_field_stream (uiout, NULL, stream);
+		if (col_byte + word_size > nr_bytes)
+		  {
+		    ui_out_field_string (uiout, NULL, "N/A");
+		  }
+		else
+		  {
+		    ui_file_rewind (stream->stream);
+		    print_scalar_formatted (mbuf + col_byte, word_type,
+					    word_format, word_asize,
+					    stream->stream);
+		    ui_out_field_stream (uiout, NULL, stream);
+		  }
 	      }
+	    do_cleanups (cleanup_list_data);
 	  }
-	do_cleanups (cleanup_list_data);
+	/* APPLE LOCAL end mi raw memory */
 	if (aschar)
 	  {
 	    int byte;
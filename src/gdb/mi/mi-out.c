@@ -25,12 +25,29 @@
 #include "ui-out.h"
 #include "ui-file.h"
 #include "mi-out.h"
+/* APPLE LOCAL mi streaming */
+#include "gdbcmd.h"
 
 /* This comes from the mi-main.c.  I need it because the notify
    code has to "put" the temporary notify buffer before discarding
    it. */
    
 extern struct ui_file *raw_stdout;
+/* APPLE LOCAL mi streaming: Partial records carry the command's token.  */
+extern char *current_command_token;
+
+/* APPLE LOCAL begin mi streaming */
+/* The deepest nesting of tuples and lists we remember.  A partial
+   record can only be emitted when every open container is known, so
+   output nested more deeply than this is never streamed.  */
+#define MI_OUT_MAX_LEVELS 32
+
+struct mi_out_level
+  {
+    enum ui_out_type type;
+    char *name;
+  };
+/* APPLE LOCAL end mi streaming */
 
 struct ui_out_data
   {
@@ -38,9 +55,24 @@ struct ui_out_data
     int suppress_output;
     int mi_version;
     struct ui_file *buffer;
+    /* APPLE LOCAL begin mi streaming */
+    /* The tuples and lists currently open in BUFFER, outermost first.  */
+    int nesting;
+    struct mi_out_level levels[MI_OUT_MAX_LEVELS];
+    /* Nonzero while the running command has asked for its result to
+       be emitted as a series of partial records.  */
+    int streaming;
+    /* APPLE LOCAL end mi streaming */
   };
 typedef struct ui_out_data mi_out_data;
 
+/* APPLE LOCAL begin mi streaming */
+/* When a streaming command has buffered at least this many bytes of
+   output, the complete list elements in the buffer are written out as
+   a "+partial" record.  Zero means never stream.  */
+static int mi_stream_chunk_size = 0;
+/* APPLE LOCAL end mi streaming */
+
 /* These are the MI output functions */
 
 static void mi_table_begin (struct ui_out *uiout, int nbrofcols,
@@ -111,6 +143,8 @@ static void field_separator (struct ui_out *uiout);
 static void mi_open (struct ui_out *uiout, const char *name,
 		     enum ui_out_type type);
 static void mi_close (struct ui_out *uiout, enum ui_out_type type);
+/* APPLE LOCAL mi streaming */
+static void mi_out_stream_partial (struct ui_out *uiout);
 
 /* Mark beginning of a table */
 
@@ -350,6 +384,10 @@ mi_notify_begin (struct ui_out *uiout, char *class)
   data->buffer = notify_buffer;
   data->suppress_field_separator = 0;
   data->suppress_output = 0;
+  /* APPLE LOCAL begin mi streaming */
+  data->nesting = 0;
+  data->streaming = 0;
+  /* APPLE LOCAL end mi streaming */
   fprintf_unfiltered (data->buffer, "=%s", class);
 }
 
@@ -391,6 +429,14 @@ mi_open (struct ui_out *uiout,
   data->suppress_field_separator = 1;
   if (name)
     fprintf_unfiltered (data->buffer, "%s=", name);
+  /* APPLE LOCAL begin mi streaming */
+  if (data->nesting < MI_OUT_MAX_LEVELS)
+    {
+      data->levels[data->nesting].type = type;
+      data->levels[data->nesting].name = name ? xstrdup (name) : NULL;
+    }
+  data->nesting++;
+  /* APPLE LOCAL end mi streaming */
   switch (type)
     {
     case ui_out_type_tuple:
@@ -407,6 +453,24 @@ mi_open (struct ui_out *uiout,
     }
 }
 
+/* APPLE LOCAL begin mi streaming */
+static void
+do_measure (void *data, const char *buffer, long length_buffer)
+{
+  *(long *) data += length_buffer;
+}
+
+/* Return the number of bytes currently held in DATA's buffer.  */
+
+static long
+mi_out_buffer_length (mi_out_data *data)
+{
+  long length = 0;
+  ui_file_put (data->buffer, do_measure, &length);
+  return length;
+}
+/* APPLE LOCAL end mi streaming */
+
 static void
 mi_close (struct ui_out *uiout,
 	  enum ui_out_type type)
@@ -427,6 +491,29 @@ mi_close (struct ui_out *uiout,
       internal_error (__FILE__, __LINE__, _("bad switch"));
     }
   data->suppress_field_separator = 0;
+
+  /* APPLE LOCAL begin mi streaming */
+  if (data->nesting > 0)
+    {
+      data->nesting--;
+      if (data->nesting < MI_OUT_MAX_LEVELS)
+	{
+	  xfree (data->levels[data->nesting].name);
+	  data->levels[data->nesting].name = NULL;
+	}
+    }
+
+  /* We have just finished an element; if it was an element of a list
+     and enough output has piled up, hand what we have to the front
+     end now.  */
+  if (data->streaming
+      && !data->suppress_output
+      && data->nesting > 0
+      && data->nesting <= MI_OUT_MAX_LEVELS
+      && data->levels[data->nesting - 1].type == ui_out_type_list
+      && mi_out_buffer_length (data) >= mi_stream_chunk_size)
+    mi_out_stream_partial (uiout);
+  /* APPLE LOCAL end mi streaming */
 }
 
 /* add a string to the buffer */
@@ -464,6 +551,78 @@ mi_out_put (struct ui_out *uiout,
   ui_file_rewind (data->buffer);
 }
 
+/* APPLE LOCAL begin mi streaming */
+/* Write the buffered output of the current command to raw_stdout as
+   a "+partial" async record, closing every open tuple and list so the
+   record is well formed.  The buffer is then restarted with those
+   containers reopened, so the rest of the output - and finally the
+   "^done" record - continues where the partial record left off.  A
+   front end reassembles the result by concatenating the lists of the
+   same name across the partial records and the final record.  */
+
+static void
+mi_out_stream_partial (struct ui_out *uiout)
+{
+  mi_out_data *data = ui_out_data (uiout);
+  int i;
+
+  if (current_command_token)
+    fputs_unfiltered (current_command_token, raw_stdout);
+  fputs_unfiltered ("+partial", raw_stdout);
+  ui_file_put (data->buffer, do_write, raw_stdout);
+  for (i = data->nesting - 1; i >= 0; i--)
+    {
+      if (data->levels[i].type == ui_out_type_list && data->mi_version != 0)
+	fputc_unfiltered (']', raw_stdout);
+      else
+	fputc_unfiltered ('}', raw_stdout);
+    }
+  fputs_unfiltered ("\n", raw_stdout);
+  gdb_flush (raw_stdout);
+
+  ui_file_rewind (data->buffer);
+  for (i = 0; i < data->nesting; i++)
+    {
+      if (i == 0)
+	fputc_unfiltered (',', data->buffer);
+      if (data->levels[i].name)
+	fprintf_unfiltered (data->buffer, "%s=", data->levels[i].name);
+      if (data->levels[i].type == ui_out_type_list && data->mi_version != 0)
+	fputc_unfiltered ('[', data->buffer);
+      else
+	fputc_unfiltered ('{', data->buffer);
+    }
+  data->suppress_field_separator = 1;
+}
+
+static void
+do_mi_out_stream_end (void *arg)
+{
+  mi_out_data *data = ui_out_data ((struct ui_out *) arg);
+  data->streaming = 0;
+}
+
+/* Let the output of the command now running on UIOUT be emitted in
+   chunks of roughly "mi-stream-chunk-size" bytes, as "+partial"
+   records followed by the usual result record, rather than buffered
+   whole.  Only commands whose output is one long list, and which do
+   not run the inferior, should ask for this.  Returns a cleanup that
+   turns streaming back off.  */
+
+struct cleanup *
+mi_out_stream_begin (struct ui_out *uiout)
+{
+  mi_out_data *data;
+
+  if (mi_stream_chunk_size <= 0 || !ui_out_is_mi_like_p (uiout))
+    return make_cleanup (null_cleanup, NULL);
+
+  data = ui_out_data (uiout);
+  data->streaming = 1;
+  return make_cleanup (do_mi_out_stream_end, uiout);
+}
+/* APPLE LOCAL end mi streaming */
+
 /* Current MI version.  */
 
 int
@@ -483,6 +642,10 @@ mi_out_new (int mi_version)
   data->suppress_field_separator = 0;
   data->suppress_output = 0;
   data->mi_version = mi_version;
+  /* APPLE LOCAL begin mi streaming */
+  data->nesting = 0;
+  data->streaming = 0;
+  /* APPLE LOCAL end mi streaming */
   /* FIXME: This code should be using a ``string_file'' and not the
      TUI buffer hack. */
   data->buffer = mem_fileopen ();
@@ -493,5 +656,16 @@ mi_out_new (int mi_version)
 void
 _initialize_mi_out (void)
 {
-  /* nothing happens here */
+  /* APPLE LOCAL begin mi streaming */
+  add_setshow_zinteger_cmd ("mi-stream-chunk-size", class_obscure,
+			    &mi_stream_chunk_size, _("\
+Set the size of the partial records used to stream large mi results."), _("\
+Show the size of the partial records used to stream large mi results."), _("\
+Commands that can produce very long results, like -data-read-memory and\n\
+-stack-list-frames, emit their output as \"+partial\" records of about this\n\
+many bytes as it is generated, instead of holding the whole result until\n\
+the command completes.  Zero disables streaming."),
+			    NULL, NULL,
+			    &setlist, &showlist);
+  /* APPLE LOCAL end mi streaming */
 }
@@ -24,11 +24,15 @@
 
 struct ui_out;
 struct ui_file;
+/* APPLE LOCAL mi streaming */
+struct cleanup;
 
 extern struct ui_out *mi_out_new (int mi_version);
 extern void mi_out_put (struct ui_out *uiout, struct ui_file *stream);
 extern void mi_out_rewind (struct ui_out *uiout);
 extern void mi_out_buffered (struct ui_out *uiout, char *string);
+/* APPLE LOCAL mi streaming */
+extern struct cleanup *mi_out_stream_begin (struct ui_out *uiout);
 
 /* Return the version number of the current MI.  */
 extern int mi_version (struct ui_out *uiout);
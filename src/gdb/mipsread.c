@@ -395,6 +395,8 @@ static struct sym_fns ecoff_sym_fns =
   mipscoff_symfile_read,	/* sym_read: read a symbol file into symtab */
   mipscoff_symfile_finish,	/* sym_finish: finished with file, cleanup */
   default_symfile_offsets,	/* sym_offsets: dummy FIXME til implem sym reloc */
+  /* APPLE LOCAL deferred solib symbols */
+  NULL,				/* sym_read_psymtabs: no separate debug info pass */
   NULL				/* next: pointer to next struct sym_fns */
 };
 
@@ -227,6 +227,8 @@ static struct sym_fns nlm_sym_fns =
   nlm_symfile_read,		/* sym_read: read a symbol file into symtab */
   nlm_symfile_finish,		/* sym_finish: finished with file, cleanup */
   default_symfile_offsets,	/* sym_offsets:  Translate ext. to int. relocation */
+  /* APPLE LOCAL deferred solib symbols */
+  NULL,				/* sym_read_psymtabs: no separate debug info pass */
   NULL				/* next: pointer to next struct sym_fns */
 };
 
@@ -47,6 +47,8 @@
 #include "breakpoint.h"
 #include "block.h"
 #include "dictionary.h"
+/* APPLE LOCAL deferred solib symbols */
+#include "exceptions.h"
 
 #include "db-access-functions.h"
 
@@ -965,6 +967,8 @@ unlink_objfile (struct objfile *objfile)
 static void
 free_objfile_internal (struct objfile *objfile)
 {
+  /* APPLE LOCAL transparent type cache */
+  objfile_generation++;
 
   /* First do any symbol file specific actions required when we are
      finished with a particular symbol file.  Note that if the objfile
@@ -1163,6 +1167,45 @@ make_cleanup_free_objfile (struct objfile *obj)
   return make_cleanup (do_free_objfile_cleanup, obj);
 }
 
+/* APPLE LOCAL begin symbol memory limit */
+/* Return the number of bytes used by the symbols of OBJFILE: its
+   obstack, where the symbol tables, partial symbol tables, minimal
+   symbols and types live, its bcaches, its partial symbol lists and
+   the demangled names it keeps in the demangler's cache.  */
+
+unsigned long
+objfile_memory_used (struct objfile *objfile)
+{
+  unsigned long used;
+
+  used = obstack_memory_used (&objfile->objfile_obstack);
+  if (objfile->psymbol_cache != NULL)
+    used += bcache_memory_used (objfile->psymbol_cache);
+  if (objfile->macro_cache != NULL)
+    used += bcache_memory_used (objfile->macro_cache);
+  used += ((objfile->global_psymbols.size + objfile->static_psymbols.size)
+	   * sizeof (struct partial_symbol *));
+  used += demangle_cache_memory_used (objfile);
+  return used;
+}
+
+/* Return non-zero if ADDR points into the obstack of OBJFILE, where
+   its symbols, blocks and types live.  */
+
+int
+objfile_obstack_contains (struct objfile *objfile, const void *addr)
+{
+  struct _obstack_chunk *chunk;
+
+  for (chunk = objfile->objfile_obstack.chunk; chunk != NULL;
+       chunk = chunk->prev)
+    if ((const char *) addr >= (const char *) chunk
+	&& (const char *) addr < chunk->limit)
+      return 1;
+  return 0;
+}
+/* APPLE LOCAL end symbol memory limit */
+
 /* Free all the object files at once and clean up their users.  */
 
 void
@@ -1177,6 +1220,50 @@ free_all_objfiles (void)
   clear_symtab_users ();
 }
 
+/* APPLE LOCAL begin lazy function bodies  */
+/* Move the addresses of block B of OBJFILE, and of the symbols in it,
+   by DELTA.  BLOCK_LINE_SECTION is the section B's addresses are
+   in.  */
+
+static void
+relocate_block (struct block *b, struct objfile *objfile,
+		struct section_offsets *delta, int block_line_section)
+{
+  struct symbol *sym;
+  struct dict_iterator iter;
+
+  BLOCK_START (b) += ANOFFSET (delta, block_line_section);
+  BLOCK_END (b) += ANOFFSET (delta, block_line_section);
+  if (BLOCK_RANGES (b))
+    {
+      int j;
+      for (j = 0; j < BLOCK_RANGES (b)->nelts; j++)
+	{
+	  BLOCK_RANGE_START (b, j) += ANOFFSET (delta, block_line_section);
+	  BLOCK_RANGE_END (b, j) += ANOFFSET (delta, block_line_section);
+	}
+    }
+
+  ALL_BLOCK_SYMBOLS (b, iter, sym)
+    {
+      fixup_symbol_section (sym, objfile);
+
+      /* The RS6000 code from which this was taken skipped
+	 any symbols in STRUCT_DOMAIN or UNDEF_DOMAIN.
+	 But I'm leaving out that test, on the theory that
+	 they can't possibly pass the tests below.  */
+      if ((SYMBOL_CLASS (sym) == LOC_LABEL
+	   || SYMBOL_CLASS (sym) == LOC_STATIC
+	   || SYMBOL_CLASS (sym) == LOC_INDIRECT)
+	  && SYMBOL_SECTION (sym) >= 0)
+	{
+	  SYMBOL_VALUE_ADDRESS (sym) +=
+	    ANOFFSET (delta, SYMBOL_SECTION (sym));
+	}
+    }
+}
+/* APPLE LOCAL end lazy function bodies  */
+
 /* Relocate OBJFILE to NEW_OFFSETS.  There should be OBJFILE->NUM_SECTIONS
    entries in new_offsets.  */
 void
@@ -1275,44 +1362,21 @@ objfile_relocate (struct objfile *objfile, struct section_offsets *new_offsets)
       bv = BLOCKVECTOR (s);
       for (i = 0; i < BLOCKVECTOR_NBLOCKS (bv); ++i)
 	{
+	  /* APPLE LOCAL begin lazy function bodies  */
 	  struct block *b;
-	  struct symbol *sym;
-	  struct dict_iterator iter;
+	  int j;
 
 	  b = BLOCKVECTOR_BLOCK (bv, i);
-	  BLOCK_START (b) += ANOFFSET (delta, s->block_line_section);
-	  BLOCK_END (b) += ANOFFSET (delta, s->block_line_section);
-	  /* APPLE LOCAL begin address ranges  */
-	  if (BLOCK_RANGES (b))
-	    {
-	      int j;
-	      for (j = 0; j < BLOCK_RANGES (b)->nelts; j++)
-		{
-		  BLOCK_RANGE_START (b, j) +=  ANOFFSET (delta, 
-							 s->block_line_section);
-		  BLOCK_RANGE_END (b, j) +=  ANOFFSET (delta, 
-						       s->block_line_section);
-		}
-	    }
-	  /* APPLE LOCAL end address ranges  */
-
-	  ALL_BLOCK_SYMBOLS (b, iter, sym)
-	    {
-	      fixup_symbol_section (sym, objfile);
-
-	      /* The RS6000 code from which this was taken skipped
-	         any symbols in STRUCT_DOMAIN or UNDEF_DOMAIN.
-	         But I'm leaving out that test, on the theory that
-	         they can't possibly pass the tests below.  */
-	      if ((SYMBOL_CLASS (sym) == LOC_LABEL
-		   || SYMBOL_CLASS (sym) == LOC_STATIC
-		   || SYMBOL_CLASS (sym) == LOC_INDIRECT)
-		  && SYMBOL_SECTION (sym) >= 0)
-		{
-		  SYMBOL_VALUE_ADDRESS (sym) +=
-		    ANOFFSET (delta, SYMBOL_SECTION (sym));
-		}
-	    }
+	  relocate_block (b, objfile, delta, s->block_line_section);
+
+	  /* The blocks inside a function whose body was read in later
+	     are only in the function's own blockvector.  */
+	  if (BLOCK_NESTED (b) != NULL)
+	    for (j = FIRST_LOCAL_BLOCK + 1;
+		 j < BLOCKVECTOR_NBLOCKS (BLOCK_NESTED (b)); j++)
+	      relocate_block (BLOCKVECTOR_BLOCK (BLOCK_NESTED (b), j),
+			      objfile, delta, s->block_line_section);
+	  /* APPLE LOCAL end lazy function bodies  */
 	}
     }
   }
@@ -1594,6 +1658,16 @@ is_in_import_list (char *name, struct objfile *objfile)
 
 static struct objfile_list *objfile_list_ptr;
 static int restrict_search = 0;
+
+/* APPLE LOCAL begin transparent type cache */
+unsigned int objfile_generation;
+
+int
+objfile_search_restricted (void)
+{
+  return restrict_search && objfile_list != NULL;
+}
+/* APPLE LOCAL end transparent type cache */
 struct objfile_list *objfile_list;
 
 /* Set the flag to tell ALL_OBJFILES whether to restrict the search or
@@ -1980,6 +2054,55 @@ objfile_get_next (struct objfile *in_objfile)
 
 static int should_auto_raise_load_state = 0;
 
+/* APPLE LOCAL begin deferred solib symbols */
+/* Read the debugging information that was left unread when O was
+   loaded, and that of its separate debug file if it has one, raising
+   its load state to LOAD_STATE.  Return the original load state, or
+   -1 for an error.  If reading fails, O is left deferred and the
+   error is passed on.  */
+
+static int
+objfile_read_deferred_debug (struct objfile *o, int load_state)
+{
+  int orig = o->symflags;
+  struct objfile *d;
+  volatile struct gdb_exception e;
+  int symflags;
+
+  if (!(load_state & OBJF_SYM_DEBUG))
+    return orig;
+
+  for (d = o; d != NULL; d = d->separate_debug_objfile)
+    {
+      if (!(d->flags & OBJF_DEFERRED_DEBUG))
+	continue;
+      if (d->sf == NULL || d->sf->sym_read_psymtabs == NULL)
+	return -1;
+
+      symflags = d->symflags;
+      d->symflags = (d->symflags & OBJF_SYM_FLAGS_MASK)
+		    | (load_state & OBJF_SYM_LEVELS_MASK);
+      TRY_CATCH (e, RETURN_MASK_ALL)
+	{
+	  (*d->sf->sym_read_psymtabs) (d);
+	}
+      if (e.reason < 0)
+	{
+	  /* Leave it deferred, so that we try again next time.  */
+	  d->symflags = symflags;
+	  throw_exception (e);
+	}
+      d->flags &= ~OBJF_DEFERRED_DEBUG;
+
+      /* Breakpoints set before now only found the minimal symbols;
+	 let them find the debugging information.  */
+      breakpoint_re_set (d);
+    }
+
+  return orig;
+}
+/* APPLE LOCAL end deferred solib symbols */
+
 /* FIXME: How to make this stuff platform independent???  
    Right now I just have a lame #ifdef MACOSX_DYLD.  I think
    the long term plan is to move the shared library handling
@@ -1999,7 +2122,10 @@ int
 objfile_set_load_state (struct objfile *o, int load_state, int force)
 {
 
-  if (!force && !should_auto_raise_load_state)
+  /* APPLE LOCAL deferred solib symbols: Debugging information that
+     was only put off is read whenever it is asked for.  */
+  if (!force && !should_auto_raise_load_state
+      && !(o->flags & OBJF_DEFERRED_DEBUG))
     return -2;
 
   if (o->symflags & OBJF_SYM_DONT_CHANGE)
@@ -2013,6 +2139,10 @@ objfile_set_load_state (struct objfile *o, int load_state, int force)
   if (o->symflags >= load_state)
     return load_state;
 
+  /* APPLE LOCAL deferred solib symbols */
+  if (o->flags & OBJF_DEFERRED_DEBUG)
+    return objfile_read_deferred_debug (o, load_state);
+
 #ifdef MACOSX_DYLD
   return dyld_objfile_set_load_state (o, load_state);
 #else
@@ -2029,9 +2159,6 @@ pc_set_load_state (CORE_ADDR pc, int load_state, int force)
 {
   struct obj_section *s;
 
-  if (!force && !should_auto_raise_load_state)
-    return -1;
-
   s = find_pc_section (pc);
   if (s == NULL)
     return -1;
@@ -2039,6 +2166,12 @@ pc_set_load_state (CORE_ADDR pc, int load_state, int force)
   if (s->objfile == NULL)
     return -1;
 
+  /* APPLE LOCAL deferred solib symbols: Check FORCE only once we know
+     the objfile; see objfile_set_load_state.  */
+  if (!force && !should_auto_raise_load_state
+      && !(s->objfile->flags & OBJF_DEFERRED_DEBUG))
+    return -1;
+
   return objfile_set_load_state (s->objfile, load_state, force);
   
 }
@@ -2155,6 +2288,8 @@ psymtab_get_next (struct partial_symtab *ps, int skip_obsolete)
 struct objfile_data
 {
   unsigned index;
+  /* APPLE LOCAL objfile data cleanup */
+  void (*cleanup) (struct objfile *, void *);
 };
 
 struct objfile_data_registration
@@ -2171,8 +2306,13 @@ struct objfile_data_registry
 
 static struct objfile_data_registry objfile_data_registry = { NULL, 0 };
 
+/* APPLE LOCAL begin objfile data cleanup */
+/* Like register_objfile_data, but CLEANUP is called with the objfile
+   and its value, when that is not NULL, before the value is thrown
+   away by clear_objfile_data or by freeing the objfile.  */
+
 const struct objfile_data *
-register_objfile_data (void)
+register_objfile_data_with_cleanup (void (*cleanup) (struct objfile *, void *))
 {
   struct objfile_data_registration **curr;
 
@@ -2184,10 +2324,37 @@ register_objfile_data (void)
   (*curr)->next = NULL;
   (*curr)->data = XMALLOC (struct objfile_data);
   (*curr)->data->index = objfile_data_registry.num_registrations++;
+  (*curr)->data->cleanup = cleanup;
 
   return (*curr)->data;
 }
 
+const struct objfile_data *
+register_objfile_data (void)
+{
+  return register_objfile_data_with_cleanup (NULL);
+}
+
+/* Run the cleanups of OBJFILE's data.  */
+
+static void
+objfile_cleanup_data (struct objfile *objfile)
+{
+  struct objfile_data_registration *registration;
+
+  for (registration = objfile_data_registry.registrations;
+       registration != NULL;
+       registration = registration->next)
+    {
+      unsigned i = registration->data->index;
+
+      if (registration->data->cleanup != NULL
+	  && i < objfile->num_data && objfile->data[i] != NULL)
+	registration->data->cleanup (objfile, objfile->data[i]);
+    }
+}
+/* APPLE LOCAL end objfile data cleanup */
+
 static void
 objfile_alloc_data (struct objfile *objfile)
 {
@@ -2200,6 +2367,8 @@ static void
 objfile_free_data (struct objfile *objfile)
 {
   gdb_assert (objfile->data != NULL);
+  /* APPLE LOCAL objfile data cleanup */
+  objfile_cleanup_data (objfile);
   xfree (objfile->data);
   objfile->data = NULL;
 }
@@ -2216,6 +2385,8 @@ void
 clear_objfile_data (struct objfile *objfile)
 {
   gdb_assert (objfile->data != NULL);
+  /* APPLE LOCAL objfile data cleanup */
+  objfile_cleanup_data (objfile);
   memset (objfile->data, 0, objfile->num_data * sizeof (void *));
 }
 
@@ -511,6 +511,17 @@ struct objfile
     struct rb_tree_node *inlined_subroutine_data;
     struct rb_tree_node *inlined_call_sites;
     /* APPLE LOCAL end subroutine inlining  */
+
+    /* APPLE LOCAL symbol memory limit: When a full symbol table was
+       last asked for from this objfile, or from its separate debug
+       objfile.  See enforce_symbol_memory_limit.  */
+    unsigned long last_used;
+
+    /* APPLE LOCAL symbol memory limit: What objfile_memory_used
+       returned before any full symbol table was read, or zero if
+       that isn't known.  Throwing the full symbol tables away can
+       bring the objfile no lower than this.  */
+    unsigned long symtab_base_memory;
   };
 
 /* Defines for the objfile flag word. */
@@ -560,6 +571,17 @@ struct objfile
    in symbol_file_add() since the backlink pointer will not be valid yet.  */
 #define OBJF_SEPARATE_DEBUG_FILE (1 << 6)	/* Separate debug file */
 
+/* APPLE LOCAL begin deferred solib symbols */
+/* The debugging information of this objfile was left unread when it
+   was loaded, to be read when first needed; see
+   objfile_set_load_state.  */
+#define OBJF_DEFERRED_DEBUG (1 << 7)	/* Debug info not read yet */
+/* APPLE LOCAL end deferred solib symbols */
+
+/* APPLE LOCAL oso prefetch: Some of this objfile's debug info lives in
+   separate .o files named by a debug map (N_OSO stabs).  */
+#define OBJF_DEBUG_MAP	(1 << 8)	/* Has OSO psymtabs */
+
 
 /* APPLE LOCAL: The following OBJF_SYM_ constants are used to limit
    the scope of how much debug/symbol information we read from
@@ -642,6 +664,14 @@ extern void clear_objfile (struct objfile *);
 
 extern struct cleanup *make_cleanup_free_objfile (struct objfile *);
 
+/* APPLE LOCAL symbol memory limit: Return the number of bytes the
+   symbols of an objfile use.  */
+extern unsigned long objfile_memory_used (struct objfile *);
+
+/* APPLE LOCAL symbol memory limit: Return non-zero if an address
+   points into the obstack of an objfile.  */
+extern int objfile_obstack_contains (struct objfile *, const void *);
+
 extern void free_all_objfiles (void);
 
 extern void objfile_relocate (struct objfile *, struct section_offsets *);
@@ -674,6 +704,10 @@ extern int is_in_import_list (char *, struct objfile *);
    modules.  */
 
 extern const struct objfile_data *register_objfile_data (void);
+/* APPLE LOCAL begin objfile data cleanup */
+extern const struct objfile_data *register_objfile_data_with_cleanup
+  (void (*cleanup) (struct objfile *, void *));
+/* APPLE LOCAL end objfile data cleanup */
 extern void clear_objfile_data (struct objfile *objfile);
 extern void set_objfile_data (struct objfile *objfile,
 			      const struct objfile_data *data, void *value);
@@ -697,6 +731,16 @@ int objfile_restrict_search (int);
 void objfile_add_to_restrict_list (struct objfile *objfile);
 void objfile_clear_restrict_list ();
 
+/* APPLE LOCAL begin transparent type cache */
+/* Non-zero if ALL_OBJFILES is restricted to the restrict list.  */
+int objfile_search_restricted (void);
+
+/* Incremented whenever symbols are added to or taken away from any
+   objfile.  A cache of symbol lookups can compare it with its value
+   when the cache was filled to tell whether the cache is stale.  */
+extern unsigned int objfile_generation;
+/* APPLE LOCAL end transparent type cache */
+
 enum objfile_matches_name_return
   {
     objfile_no_match,
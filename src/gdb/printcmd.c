@@ -1552,6 +1552,31 @@ clear_displays (void)
     }
 }
 
+/* APPLE LOCAL begin symbol memory limit */
+/* Return non-zero if an auto-display expression points into the
+   obstack of OBJFILE: at the block it must be evaluated in, or at a
+   symbol, block or type in its elements.  Literal constants that
+   happen to look like such an address only make this err on the safe
+   side.  */
+
+int
+displays_use_objfile (struct objfile *objfile)
+{
+  struct display *d;
+  int i;
+
+  for (d = display_chain; d != NULL; d = d->next)
+    {
+      if (d->block != NULL && objfile_obstack_contains (objfile, d->block))
+	return 1;
+      for (i = 0; i < d->exp->nelts; i++)
+	if (objfile_obstack_contains (objfile, d->exp->elts[i].symbol))
+	  return 1;
+    }
+  return 0;
+}
+/* APPLE LOCAL end symbol memory limit */
+
 /* Delete the auto-display number NUM.  */
 
 static void
@@ -2418,6 +2418,24 @@ remote_start_remote_dummy (struct ui_out *uiout, void *dummy)
   return 1;
 }
 
+/* APPLE LOCAL begin non-stop */
+/* Ask the stub to leave the other threads running when one of them
+   reports an event.  Stop replies stay synchronous: the stub holds
+   an event until the next vCont, as remote_wait expects.  */
+
+static void
+remote_set_non_stop (void)
+{
+  struct remote_state *rs = get_remote_state ();
+  char *buf = alloca (rs->remote_packet_size);
+
+  putpkt ("QNonStop:1");
+  getpkt (buf, rs->remote_packet_size, 0);
+  if (strcmp (buf, "OK") != 0)
+    error (_("Remote target does not support non-stop mode."));
+}
+/* APPLE LOCAL end non-stop */
+
 static void
 remote_start_remote (struct ui_out *uiout, void *dummy)
 {
@@ -2463,6 +2481,9 @@ remote_start_remote (struct ui_out *uiout, void *dummy)
       if (remote_debugflags != NULL)
         send_remote_debugflags_pkt (remote_debugflags);
       send_remote_max_payload_size ();
+      /* APPLE LOCAL non-stop */
+      if (non_stop)
+	remote_set_non_stop ();
       
       putpkt ("?");		/* Initiate a query from remote machine.  */
       immediate_quit--;
@@ -3228,6 +3249,10 @@ remote_resume (ptid_t ptid, int step, enum target_signal siggnal)
   if (remote_vcont_resume (ptid, step, siggnal))
     return;
 
+  /* APPLE LOCAL non-stop: Hc and c can't say "just this thread".  */
+  if (non_stop)
+    error (_("Remote target does not support vCont; non-stop mode needs it."));
+
   /* All other supported resume packets do use Hc, so call set_thread.  */
   if (pid == -1)
     set_thread (0, 0);		/* Run any thread.  */
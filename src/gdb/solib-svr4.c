@@ -43,6 +43,8 @@
 
 #include "bfd-target.h"
 #include "exec.h"
+/* APPLE LOCAL incremental link map */
+#include "hashtab.h"
 
 static struct link_map_offsets *svr4_fetch_link_map_offsets (void);
 static int svr4_have_link_map_offsets (void);
@@ -135,36 +137,6 @@ LM_ADDR (struct so_list *so)
 					     lmo->l_addr_size);
 }
 
-static CORE_ADDR
-LM_NEXT (struct so_list *so)
-{
-  struct link_map_offsets *lmo = svr4_fetch_link_map_offsets ();
-
-  /* Assume that the address is unsigned.  */
-  return extract_unsigned_integer (so->lm_info->lm + lmo->l_next_offset,
-				   lmo->l_next_size);
-}
-
-static CORE_ADDR
-LM_NAME (struct so_list *so)
-{
-  struct link_map_offsets *lmo = svr4_fetch_link_map_offsets ();
-
-  /* Assume that the address is unsigned.  */
-  return extract_unsigned_integer (so->lm_info->lm + lmo->l_name_offset,
-				   lmo->l_name_size);
-}
-
-static int
-IGNORE_FIRST_LINK_MAP_ENTRY (struct so_list *so)
-{
-  struct link_map_offsets *lmo = svr4_fetch_link_map_offsets ();
-
-  /* Assume that the address is unsigned.  */
-  return extract_unsigned_integer (so->lm_info->lm + lmo->l_prev_offset,
-				   lmo->l_prev_size) == 0;
-}
-
 static CORE_ADDR debug_base;	/* Base of dynamic linker structures */
 static CORE_ADDR breakpoint_addr;	/* Address where end bkpt is set */
 
@@ -560,6 +532,203 @@ open_symbol_file_object (void *from_ttyp)
   return 1;
 }
 
+/* APPLE LOCAL begin incremental link map */
+/* What we last read of the inferior's link map chain.
+
+   Each node of the chain is a separately allocated struct link_map
+   that stays where it is for as long as its object is loaded, and
+   whose name doesn't change.  So a node at an address we've seen
+   before, with the same l_addr and l_name, is the same object, and we
+   needn't read its name again; reading names is most of the cost of
+   walking the chain, since target_read_string reads a word at a
+   time.  LM_CACHE_TABLE maps link_map addresses to entries; the
+   entries of the chain as last read are also linked in order from
+   LM_CACHE_CHAIN.  */
+
+struct lm_cache_entry
+{
+  /* The address of this link_map in the inferior.  */
+  CORE_ADDR lm;
+
+  /* A copy of its first link_map_size bytes.  */
+  gdb_byte *lm_buf;
+
+  /* Its l_name string, or NULL if that couldn't be read, in which
+     case NAME_ERRCODE says why.  */
+  char *name;
+  int name_errcode;
+
+  /* The next entry in the chain.  */
+  struct lm_cache_entry *next;
+};
+
+static htab_t lm_cache_table;
+static struct lm_cache_entry *lm_cache_chain;
+
+/* Non-zero if LM_CACHE_CHAIN is the whole chain as last read.  */
+static int lm_cache_valid;
+
+/* The value of r_debug.r_state while the link map is consistent; see
+   <link.h>.  */
+#define SVR4_RT_CONSISTENT 0
+
+static hashval_t
+hash_lm_cache_entry (const void *p)
+{
+  const struct lm_cache_entry *e = p;
+  return (hashval_t) e->lm;
+}
+
+static int
+eq_lm_cache_entry (const void *p, const void *key)
+{
+  const struct lm_cache_entry *e = p;
+  return e->lm == *(const CORE_ADDR *) key;
+}
+
+static void
+free_lm_cache_entry (struct lm_cache_entry *e)
+{
+  xfree (e->lm_buf);
+  xfree (e->name);
+  xfree (e);
+}
+
+static void
+free_lm_cache_chain (struct lm_cache_entry *chain)
+{
+  while (chain != NULL)
+    {
+      struct lm_cache_entry *next = chain->next;
+      free_lm_cache_entry (chain);
+      chain = next;
+    }
+}
+
+static void
+do_free_lm_cache_chain (void *chainp)
+{
+  free_lm_cache_chain (*(struct lm_cache_entry **) chainp);
+}
+
+/* Forget everything we knew about the link map.  */
+
+static void
+clear_lm_cache (void)
+{
+  if (lm_cache_table != NULL)
+    htab_empty (lm_cache_table);
+  free_lm_cache_chain (lm_cache_chain);
+  lm_cache_chain = NULL;
+  lm_cache_valid = 0;
+}
+
+/* Read the inferior's r_debug in one go.  Set *LMP to the first link
+   map member, and return r_state, or -1 if the link map offsets don't
+   say where it is.  */
+
+static LONGEST
+read_r_debug (CORE_ADDR *lmp)
+{
+  struct link_map_offsets *lmo = svr4_fetch_link_map_offsets ();
+  int size = max (lmo->r_debug_size, lmo->r_map_offset + lmo->r_map_size);
+  gdb_byte *buf = alloca (size);
+  LONGEST state = -1;
+
+  read_memory (debug_base, buf, size);
+
+  /* Assume that the address is unsigned.  */
+  *lmp = extract_unsigned_integer (buf + lmo->r_map_offset,
+				   lmo->r_map_size);
+
+  if (lmo->r_state_offset != 0
+      && lmo->r_state_offset + lmo->r_state_size <= size)
+    state = extract_signed_integer (buf + lmo->r_state_offset,
+				    lmo->r_state_size);
+  return state;
+}
+
+/* Walk the inferior's link map chain starting at LM, and make what we
+   find the new cache.  Names are read only for nodes we haven't seen
+   before.  */
+
+static void
+refresh_lm_cache (CORE_ADDR lm)
+{
+  struct link_map_offsets *lmo = svr4_fetch_link_map_offsets ();
+  struct lm_cache_entry *chain = NULL;
+  struct lm_cache_entry **link_ptr = &chain;
+  struct cleanup *old_chain;
+  struct lm_cache_entry *e;
+
+  if (lm_cache_table == NULL)
+    lm_cache_table = htab_create_alloc (64, hash_lm_cache_entry,
+					eq_lm_cache_entry, NULL,
+					xcalloc, xfree);
+
+  old_chain = make_cleanup (do_free_lm_cache_chain, &chain);
+
+  while (lm)
+    {
+      struct lm_cache_entry *old;
+
+      e = XZALLOC (struct lm_cache_entry);
+      e->lm = lm;
+      *link_ptr = e;
+      link_ptr = &e->next;
+
+      e->lm_buf = xmalloc (lmo->link_map_size);
+      read_memory (lm, e->lm_buf, lmo->link_map_size);
+
+      old = htab_find_with_hash (lm_cache_table, &lm, (hashval_t) lm);
+      if (old != NULL
+	  && memcmp (old->lm_buf + lmo->l_addr_offset,
+		     e->lm_buf + lmo->l_addr_offset, lmo->l_addr_size) == 0
+	  && memcmp (old->lm_buf + lmo->l_name_offset,
+		     e->lm_buf + lmo->l_name_offset, lmo->l_name_size) == 0)
+	{
+	  /* The same object as before; take its name over.  */
+	  e->name = old->name;
+	  e->name_errcode = old->name_errcode;
+	  old->name = NULL;
+	}
+      else
+	{
+	  CORE_ADDR l_name;
+	  int errcode;
+
+	  /* Assume that the address is unsigned.  */
+	  l_name = extract_unsigned_integer (e->lm_buf + lmo->l_name_offset,
+					     lmo->l_name_size);
+	  target_read_string (l_name, &e->name,
+			      SO_NAME_MAX_PATH_SIZE - 1, &errcode);
+	  if (errcode != 0)
+	    {
+	      xfree (e->name);
+	      e->name = NULL;
+	      e->name_errcode = errcode;
+	    }
+	}
+
+      /* Assume that the address is unsigned.  */
+      lm = extract_unsigned_integer (e->lm_buf + lmo->l_next_offset,
+				     lmo->l_next_size);
+    }
+
+  discard_cleanups (old_chain);
+
+  clear_lm_cache ();
+  lm_cache_chain = chain;
+  for (e = chain; e != NULL; e = e->next)
+    {
+      void **slot = htab_find_slot_with_hash (lm_cache_table, &e->lm,
+					      (hashval_t) e->lm, INSERT);
+      *slot = e;
+    }
+  lm_cache_valid = 1;
+}
+/* APPLE LOCAL end incremental link map */
+
 /* LOCAL FUNCTION
 
    current_sos -- build a list of currently loaded shared objects
@@ -582,7 +751,12 @@ open_symbol_file_object (void *from_ttyp)
 static struct so_list *
 svr4_current_sos (void)
 {
+  /* APPLE LOCAL begin incremental link map */
+  struct link_map_offsets *lmo;
+  struct lm_cache_entry *e;
   CORE_ADDR lm;
+  LONGEST state;
+  /* APPLE LOCAL end incremental link map */
   struct so_list *head = 0;
   struct so_list **link_ptr = &head;
 
@@ -598,70 +772,55 @@ svr4_current_sos (void)
 	return 0;
     }
 
-  /* Walk the inferior's link map list, and build our list of
-     `struct so_list' nodes.  */
-  lm = first_link_map_member ();  
-  while (lm)
+  /* APPLE LOCAL begin incremental link map */
+  /* While the dynamic linker is between the two halves of a dlopen or
+     dlclose, the chain is the one we read when it was last
+     consistent, or on its way to the next consistent state; either
+     way, there's nothing new to read.  */
+  state = read_r_debug (&lm);
+  if (!lm_cache_valid || state == -1 || state == SVR4_RT_CONSISTENT)
+    refresh_lm_cache (lm);
+
+  /* Build our list of `struct so_list' nodes from the cache.  */
+  lmo = svr4_fetch_link_map_offsets ();
+  for (e = lm_cache_chain; e != NULL; e = e->next)
     {
-      struct link_map_offsets *lmo = svr4_fetch_link_map_offsets ();
-      struct so_list *new
-	= (struct so_list *) xmalloc (sizeof (struct so_list));
-      struct cleanup *old_chain = make_cleanup (xfree, new);
-
-      memset (new, 0, sizeof (*new));
-
-      new->lm_info = xmalloc (sizeof (struct lm_info));
-      make_cleanup (xfree, new->lm_info);
-
-      new->lm_info->lm = xmalloc (lmo->link_map_size);
-      make_cleanup (xfree, new->lm_info->lm);
-      memset (new->lm_info->lm, 0, lmo->link_map_size);
-
-      read_memory (lm, new->lm_info->lm, lmo->link_map_size);
-
-      lm = LM_NEXT (new);
+      struct so_list *new;
 
       /* For SVR4 versions, the first entry in the link map is for the
          inferior executable, so we must ignore it.  For some versions of
          SVR4, it has no name.  For others (Solaris 2.3 for example), it
          does have a name, so we can no longer use a missing name to
          decide when to ignore it. */
-      if (IGNORE_FIRST_LINK_MAP_ENTRY (new))
-	free_so (new);
-      else
+      if (extract_unsigned_integer (e->lm_buf + lmo->l_prev_offset,
+				    lmo->l_prev_size) == 0)
+	continue;
+
+      /* If this entry has no name, or its name matches the name
+	 for the main executable, don't include it in the list.  */
+      if (e->name == NULL)
 	{
-	  int errcode;
-	  char *buffer;
+	  warning (_("Can't read pathname for load map: %s."),
+		   safe_strerror (e->name_errcode));
+	  continue;
+	}
+      if (! e->name[0] || match_main (e->name))
+	continue;
 
-	  /* Extract this shared object's name.  */
-	  target_read_string (LM_NAME (new), &buffer,
-			      SO_NAME_MAX_PATH_SIZE - 1, &errcode);
-	  if (errcode != 0)
-	    warning (_("Can't read pathname for load map: %s."),
-		     safe_strerror (errcode));
-	  else
-	    {
-	      strncpy (new->so_name, buffer, SO_NAME_MAX_PATH_SIZE - 1);
-	      new->so_name[SO_NAME_MAX_PATH_SIZE - 1] = '\0';
-	      xfree (buffer);
-	      strcpy (new->so_original_name, new->so_name);
-	    }
+      new = XZALLOC (struct so_list);
+      new->lm_info = xmalloc (sizeof (struct lm_info));
+      new->lm_info->lm = xmalloc (lmo->link_map_size);
+      memcpy (new->lm_info->lm, e->lm_buf, lmo->link_map_size);
 
-	  /* If this entry has no name, or its name matches the name
-	     for the main executable, don't include it in the list.  */
-	  if (! new->so_name[0]
-	      || match_main (new->so_name))
-	    free_so (new);
-	  else
-	    {
-	      new->next = 0;
-	      *link_ptr = new;
-	      link_ptr = &new->next;
-	    }
-	}
+      strncpy (new->so_name, e->name, SO_NAME_MAX_PATH_SIZE - 1);
+      new->so_name[SO_NAME_MAX_PATH_SIZE - 1] = '\0';
+      strcpy (new->so_original_name, new->so_name);
 
-      discard_cleanups (old_chain);
+      new->next = 0;
+      *link_ptr = new;
+      link_ptr = &new->next;
     }
+  /* APPLE LOCAL end incremental link map */
 
   return head;
 }
@@ -1232,6 +1391,8 @@ static void
 svr4_clear_solib (void)
 {
   debug_base = 0;
+  /* APPLE LOCAL incremental link map */
+  clear_lm_cache ();
 }
 
 static void
@@ -1350,10 +1511,14 @@ svr4_ilp32_fetch_link_map_offsets (void)
     {
       lmp = &lmo;
 
-      /* Everything we need is in the first 8 bytes.  */
-      lmo.r_debug_size = 8;
+      /* APPLE LOCAL begin incremental link map */
+      /* Everything we need is in the first 16 bytes.  */
+      lmo.r_debug_size = 16;
       lmo.r_map_offset = 4;
       lmo.r_map_size   = 4;
+      lmo.r_state_offset = 12;
+      lmo.r_state_size   = 4;
+      /* APPLE LOCAL end incremental link map */
 
       /* Everything we need is in the first 20 bytes.  */
       lmo.link_map_size = 20;
@@ -1383,10 +1548,14 @@ svr4_lp64_fetch_link_map_offsets (void)
     {
       lmp = &lmo;
 
-      /* Everything we need is in the first 16 bytes.  */
-      lmo.r_debug_size = 16;
+      /* APPLE LOCAL begin incremental link map */
+      /* Everything we need is in the first 28 bytes.  */
+      lmo.r_debug_size = 28;
       lmo.r_map_offset = 8;
       lmo.r_map_size   = 8;
+      lmo.r_state_offset = 24;
+      lmo.r_state_size   = 4;
+      /* APPLE LOCAL end incremental link map */
 
       /* Everything we need is in the first 40 bytes.  */
       lmo.link_map_size = 40;
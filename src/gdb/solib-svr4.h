@@ -41,6 +41,15 @@ struct link_map_offsets
     /* Size of the r_map field in struct r_debug.  */
     int r_map_size;
 
+    /* APPLE LOCAL begin incremental link map */
+    /* Offset to the r_state field in struct r_debug, or zero if
+       unknown.  */
+    int r_state_offset;
+
+    /* Size of the r_state field in struct r_debug.  */
+    int r_state_size;
+    /* APPLE LOCAL end incremental link map */
+
     /* Size of struct link_map (or equivalent), or at least enough of it
        to be able to obtain the fields below.  */
     int link_map_size;
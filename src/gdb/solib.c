@@ -46,6 +46,8 @@
 #include "solist.h"
 #include "observer.h"
 #include "readline/readline.h"
+/* APPLE LOCAL deferred solib symbols */
+#include "breakpoint.h"
 
 /* Architecture-specific operations.  */
 
@@ -381,6 +383,27 @@ master_so_list (void)
 }
 
 
+/* APPLE LOCAL begin deferred solib symbols */
+/* If non-zero, shared libraries loaded while the program runs get
+   only their minimal symbols at first; their debugging information
+   is read when the program next stops for the user, or sooner if
+   something needs it.  */
+static int solib_defer_symbols = 0;
+
+static void
+show_solib_defer_symbols (struct ui_file *file, int from_tty,
+			  struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("\
+Deferring shared library debugging information is %s.\n"),
+		    value);
+}
+
+/* Set by solib_add while symbol_add_stub should defer debugging
+   information.  */
+static int solib_deferring;
+/* APPLE LOCAL end deferred solib symbols */
+
 /* A small stub to get us past the arg-passing pinhole of catch_errors.  */
 
 static int
@@ -388,6 +411,11 @@ symbol_add_stub (void *arg)
 {
   struct so_list *so = (struct so_list *) arg;  /* catch_errs bogon */
   struct section_addr_info *sap;
+  /* APPLE LOCAL begin deferred solib symbols */
+  struct objfile *o;
+  bfd *abfd;
+  int symflags;
+  /* APPLE LOCAL end deferred solib symbols */
 
   /* Have we already loaded this shared object?  */
   ALL_OBJFILES (so->objfile)
@@ -399,10 +427,22 @@ symbol_add_stub (void *arg)
   sap = build_section_addr_info_from_section_table (so->sections,
                                                     so->sections_end);
 
-  so->objfile = symbol_file_add (so->so_name, so->from_tty,
-				 sap, 0, OBJF_SHARED);
+  /* APPLE LOCAL begin deferred solib symbols */
+  abfd = symfile_bfd_open (so->so_name, 0);
+  symflags = OBJF_SYM_ALL;
+  if (solib_deferring && symfile_can_defer_debug_info (abfd))
+    symflags &= ~OBJF_SYM_DEBUG;
+
+  so->objfile = symbol_file_add_with_addrs_or_offsets_using_objfile
+    (NULL, abfd, so->from_tty, sap, NULL, 0, 0, OBJF_SHARED, symflags,
+     0, NULL, NULL);
   free_section_addr_info (sap);
 
+  if (!(symflags & OBJF_SYM_DEBUG))
+    for (o = so->objfile; o != NULL; o = o->separate_debug_objfile)
+      o->flags |= OBJF_DEFERRED_DEBUG;
+  /* APPLE LOCAL end deferred solib symbols */
+
   return (1);
 }
 
@@ -650,6 +690,15 @@ solib_add (char *pattern, int from_tty, struct target_ops *target, int readsyms)
     int any_matches = 0;
     int loaded_any_symbols = 0;
 
+    /* APPLE LOCAL begin deferred solib symbols */
+    /* Only put off the libraries the program loads as it runs, and
+       not while a pending breakpoint might be waiting for one of
+       them: resolving it may need more than the minimal symbols.  */
+    solib_deferring = (solib_defer_symbols && pattern == NULL && !from_tty
+		       && target_has_execution
+		       && !pending_breakpoints_p ());
+    /* APPLE LOCAL end deferred solib symbols */
+
     for (gdb = so_list_head; gdb; gdb = gdb->next)
       if (! pattern || re_exec (gdb->so_name))
 	{
@@ -658,6 +707,9 @@ solib_add (char *pattern, int from_tty, struct target_ops *target, int readsyms)
 	    loaded_any_symbols = 1;
 	}
 
+    /* APPLE LOCAL deferred solib symbols */
+    solib_deferring = 0;
+
     if (from_tty && pattern && ! any_matches)
       printf_unfiltered
 	("No loaded shared libraries match the pattern `%s'.\n", pattern);
@@ -739,7 +791,13 @@ info_sharedlibrary_command (char *ignore, int from_tty)
 			           (LONGEST) so->textsection->endaddr,
 	                           addr_width - 4)
 			       : "");
-	  printf_unfiltered ("%-12s", so->symbols_loaded ? "Yes" : "No");
+	  /* APPLE LOCAL begin deferred solib symbols */
+	  printf_unfiltered ("%-12s",
+			     !so->symbols_loaded ? "No"
+			     : (so->objfile != NULL
+				&& (so->objfile->flags & OBJF_DEFERRED_DEBUG))
+			     ? "Deferred" : "Yes");
+	  /* APPLE LOCAL end deferred solib symbols */
 	  printf_unfiltered ("%s\n", so->so_name);
 	}
     }
@@ -903,7 +961,44 @@ sharedlibrary_command (char *args, int from_tty)
 {
   dont_repeat ();
   solib_add (args, from_tty, (struct target_ops *) 0, 1);
+  /* APPLE LOCAL deferred solib symbols */
+  solib_read_deferred_symbols ();
+}
+
+/* APPLE LOCAL begin deferred solib symbols */
+static int
+read_deferred_symbols_stub (void *arg)
+{
+  struct so_list *so = (struct so_list *) arg;  /* catch_errs bogon */
+
+  objfile_set_load_state (so->objfile, OBJF_SYM_ALL, 1);
+  return 1;
+}
+
+/* Read the debugging information of every shared library whose
+   debugging information was put off when it was loaded.  */
+
+void
+solib_read_deferred_symbols (void)
+{
+  struct so_list *so;
+  int read_any = 0;
+
+  for (so = so_list_head; so != NULL; so = so->next)
+    if (so->objfile != NULL && (so->objfile->flags & OBJF_DEFERRED_DEBUG))
+      {
+	catch_errors (read_deferred_symbols_stub, so,
+		      "Error while reading shared library symbols:\n",
+		      RETURN_MASK_ALL);
+	read_any = 1;
+      }
+
+  /* Getting new symbols may change our opinion about what is
+     frameless.  */
+  if (read_any)
+    reinit_frame_cache ();
 }
+/* APPLE LOCAL end deferred solib symbols */
 
 /* LOCAL FUNCTION
 
@@ -967,6 +1062,20 @@ inferior.  Otherwise, symbols must be loaded manually, using `sharedlibrary'."),
 			   show_auto_solib_add,
 			   &setlist, &showlist);
 
+  /* APPLE LOCAL begin deferred solib symbols */
+  add_setshow_boolean_cmd ("solib-defer-symbols", class_support,
+			   &solib_defer_symbols, _("\
+Set deferring of shared library debugging information."), _("\
+Show deferring of shared library debugging information."), _("\
+If \"on\", shared libraries that the program loads while it runs get only\n\
+their minimal symbols at first, so the program is held up less.  Their\n\
+debugging information is read when the program next stops, or sooner if\n\
+GDB needs it to step into or stop in one of them."),
+			   NULL,
+			   show_solib_defer_symbols,
+			   &setlist, &showlist);
+  /* APPLE LOCAL end deferred solib symbols */
+
   add_setshow_filename_cmd ("solib-absolute-prefix", class_support,
 			    &solib_absolute_prefix, _("\
 Set prefix for loading absolute shared library symbol files."), _("\
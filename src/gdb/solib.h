@@ -38,6 +38,11 @@ extern void clear_solib (void);
 extern int solib_add (char *, int, struct target_ops *, int);
 extern int solib_read_symbols (struct so_list *, int);
 
+/* APPLE LOCAL deferred solib symbols: Read the debugging information
+   that was put off while shared libraries were being loaded.  */
+
+extern void solib_read_deferred_symbols (void);
+
 /* Function to be called when the inferior starts up, to discover the
    names of shared libraries that are dynamically linked, the base
    addresses to which they are linked, and sufficient information to
@@ -37,6 +37,8 @@
 #include "breakpoint.h"
 #include "demangle.h"
 #include "inferior.h"
+/* APPLE LOCAL non-stop */
+#include "gdbthread.h"
 #include "annotate.h"
 #include "ui-out.h"
 #include "block.h"
@@ -239,6 +241,8 @@ print_frame_args (struct symbol *func, struct frame_info *fi, int num,
   if (func)
     {
       b = SYMBOL_BLOCK_VALUE (func);
+      /* APPLE LOCAL lazy function bodies  */
+      block_expand_lazy (b);
 
       ALL_BLOCK_SYMBOLS (b, iter, sym)
         {
@@ -1320,6 +1324,11 @@ frame_info (char *addr_exp, int from_tty)
 
 /* Print briefly all stack frames or just the innermost COUNT frames.  */
 
+/* APPLE LOCAL oso prefetch: How many frames at the start of a
+   backtrace we look at ahead of time to start reading their object
+   files.  */
+#define BACKTRACE_PREFETCH_FRAMES 64
+
 static void backtrace_command_1 (char *count_exp, int show_locals,
 				 int from_tty);
 static void
@@ -1394,6 +1403,41 @@ backtrace_command_1 (char *count_exp, int show_locals, int from_tty)
   else
     count = -1;
 
+  /* APPLE LOCAL begin oso prefetch */
+  /* Get the kernel started reading the object files that hold the
+     debug info for the first frames we are about to print, so that
+     expanding their psymtabs one after another below doesn't wait on
+     each file in turn.  Only programs with debug maps have such
+     files, so don't unwind ahead of time for anything else.  */
+  if (oso_objfiles_present ())
+    {
+      struct partial_symtab *seen[BACKTRACE_PREFETCH_FRAMES];
+      int nseen = 0;
+
+      i = (count == -1 || count > BACKTRACE_PREFETCH_FRAMES)
+	  ? BACKTRACE_PREFETCH_FRAMES : count;
+      for (fi = trailing;
+	   fi != NULL && i--;
+	   fi = get_prev_frame (fi))
+	{
+	  struct partial_symtab *ps;
+	  int j;
+
+	  QUIT;
+	  ps = find_pc_psymtab (get_frame_address_in_block (fi));
+	  if (ps == NULL || ps->readin)
+	    continue;
+	  for (j = 0; j < nseen; j++)
+	    if (seen[j] == ps)
+	      break;
+	  if (j < nseen)
+	    continue;
+	  seen[nseen++] = ps;
+	  oso_prefetch_psymtab (ps);
+	}
+    }
+  /* APPLE LOCAL end oso prefetch */
+
   if (info_verbose)
     {
       struct partial_symtab *ps;
@@ -1812,6 +1856,8 @@ print_frame_arg_vars (struct frame_info *fi,
     }
 
   b = SYMBOL_BLOCK_VALUE (func);
+  /* APPLE LOCAL lazy function bodies  */
+  block_expand_lazy (b);
   ALL_BLOCK_SYMBOLS (b, iter, sym)
     {
       switch (SYMBOL_CLASS (sym))
@@ -1899,6 +1945,10 @@ get_selected_block (CORE_ADDR *addr_in_block)
   if (!target_has_stack)
     return 0;
 
+  /* APPLE LOCAL non-stop: A running thread has no pc to look at.  */
+  if (is_running (inferior_ptid))
+    return 0;
+
   /* NOTE: cagney/2002-11-28: Why go to all this effort to not create
      a selected/current frame?  Perhaps this function is called,
      indirectly, by WFI in "infrun.c" where avoiding the creation of
@@ -55,6 +55,8 @@
 /* APPLE LOCAL exceptions */
 #include "exceptions.h"
 #include "exec.h"
+/* APPLE LOCAL symbol memory limit */
+#include "varobj.h"
 #include "macosx/macosx-nat-inferior.h"
 #include "macosx/macosx-nat-utils.h" /* For macosx_filename_in_bundle.  */
 #include "mach-o.h"
@@ -335,6 +337,20 @@ decrement_reading_symtab (void *dummy)
   currently_reading_symtab--;
 }
 
+/* APPLE LOCAL begin symbol memory limit */
+/* The most memory, in megabytes, that the symbols of all objfiles
+   together may use before enforce_symbol_memory_limit throws away
+   the expanded symbol tables of the least recently used ones.
+   UINT_MAX means there is no limit.  */
+
+static unsigned int symbol_memory_limit = UINT_MAX;
+
+/* Counts the requests for full symbol tables; each objfile's
+   last_used is the count at its most recent request.  */
+
+static unsigned long symtab_use_tick;
+/* APPLE LOCAL end symbol memory limit */
+
 /* Get the symbol table that corresponds to a partial_symtab.
    This is fast after the first time you do it.  In fact, there
    is an even faster macro PSYMTAB_TO_SYMTAB that does the fast
@@ -346,6 +362,18 @@ psymtab_to_symtab (struct partial_symtab *pst)
   /* APPLE LOCAL: This is the psymtab to symtab timer.  */
   static int timer = -1;
 
+  /* APPLE LOCAL begin symbol memory limit */
+  /* The symbols of a separate debug objfile are thrown away along
+     with those of the objfile it belongs to.  */
+  pst->objfile->last_used = ++symtab_use_tick;
+  if (pst->objfile->separate_debug_objfile_backlink != NULL)
+    pst->objfile->separate_debug_objfile_backlink->last_used
+      = symtab_use_tick;
+  if (symbol_memory_limit != UINT_MAX
+      && pst->symtab == NULL && pst->objfile->symtabs == NULL)
+    pst->objfile->symtab_base_memory = objfile_memory_used (pst->objfile);
+  /* APPLE LOCAL end symbol memory limit */
+
   /* If it's been looked up before, return it. */
   if (pst->symtab)
     return pst->symtab;
@@ -2329,6 +2357,23 @@ find_sym_fns (struct objfile *objfile)
   error (_("I'm sorry, Dave, I can't do that.  Symbol format `%s' unknown."),
 	 bfd_get_target (objfile->obfd));
 }
+
+/* APPLE LOCAL begin deferred solib symbols */
+/* Return non-zero if the symbol reader for ABFD can read its
+   debugging information separately, after its minimal symbols.  */
+
+int
+symfile_can_defer_debug_info (bfd *abfd)
+{
+  struct sym_fns *sf;
+  enum bfd_flavour our_flavour = bfd_get_flavour (abfd);
+
+  for (sf = symtab_fns; sf != NULL; sf = sf->next)
+    if (our_flavour == sf->sym_flavour)
+      return sf->sym_read_psymtabs != NULL;
+  return 0;
+}
+/* APPLE LOCAL end deferred solib symbols */
 
 /* This function runs the load command of our current target.  */
 
@@ -3136,6 +3181,458 @@ add_shared_symbol_files_command (char *args, int from_tty)
 #endif
 }
 
+/* APPLE LOCAL begin symbol memory limit */
+/* Throw away all the symbols of OBJFILE and read them again from its
+   file, the way reread_symbols does for a file that has changed.
+   NEW_MODTIME becomes the objfile's modification time.  If this
+   fails, OBJFILE is freed.  Whatever else pointed into its symbols
+   is the caller's to clean up.  */
+
+static void
+reread_objfile (struct objfile *objfile, long new_modtime)
+{
+  struct cleanup *old_cleanups;
+  struct section_offsets *offsets;
+  int num_offsets;
+  char *obfd_filename;
+
+  /* There are various functions like symbol_file_add,
+     symfile_bfd_open, syms_from_objfile, etc., which might
+     appear to do what we want.  But they have various other
+     effects which we *don't* want.  So we just do stuff
+     ourselves.  We don't worry about mapped files (for one thing,
+     any mapped file will be out of date).  */
+
+  /* If we get an error, blow away this objfile (not sure if
+     that is the correct response for things like shared
+     libraries).  */
+  old_cleanups = make_cleanup_free_objfile (objfile);
+
+  /* If this objfile has a separate debug objfile, clear it
+     out here.  */
+  if (objfile->separate_debug_objfile != NULL)
+    {
+      free_objfile (objfile->separate_debug_objfile);
+      objfile->separate_debug_objfile = NULL;
+    }
+
+  /* APPLE LOCAL: Before we clean up any state, tell the
+     breakpoint system that this objfile has changed so it
+     can clear the set state on any breakpoints in this
+     objfile. */
+
+  tell_breakpoints_objfile_changed (objfile);
+  tell_objc_msgsend_cacher_objfile_changed (objfile);
+
+  /* APPLE LOCAL cache lookup values for improved performance  */
+  symtab_clear_cached_lookup_values ();
+  /* APPLE LOCAL: Remove it's obj_sections from the 
+     ordered_section list.  */
+  objfile_delete_from_ordered_sections (objfile);
+
+  /* Clean up any state BFD has sitting around.  We don't need
+     to close the descriptor but BFD lacks a way of closing the
+     BFD without closing the descriptor.  */
+  obfd_filename = bfd_get_filename (objfile->obfd);
+
+  /* APPLE LOCAL: Remember to remove its sections from the 
+     target "to_sections".  Normally this is done in 
+     free_objfile, but here we're remaking the objfile
+     "in place" so we have to do it by hand.  */
+  remove_target_sections (objfile->obfd);
+
+  if (!bfd_close (objfile->obfd))
+    error (_("Can't close BFD for %s: %s"), objfile->name,
+	   bfd_errmsg (bfd_get_error ()));
+  objfile->obfd = bfd_openr (obfd_filename, gnutarget);
+  if (objfile->obfd == NULL)
+    error (_("Can't open %s to read symbols."), objfile->name);
+  /* bfd_openr sets cacheable to true, which is what we want.  */
+
+  /* APPLE LOCAL: If the file is an archive file (i.e. fat
+     binary), look for sub-files that match the current
+     osabi. */
+
+  if (bfd_check_format (objfile->obfd, bfd_archive))
+    {
+      bfd *tmp_bfd;
+      tmp_bfd = open_bfd_matching_arch (objfile->obfd, bfd_object);
+      if (tmp_bfd != NULL)
+	objfile->obfd = tmp_bfd;
+    }
+
+  if (!bfd_check_format (objfile->obfd, bfd_object))
+    error (_("Can't read symbols from %s: %s."), objfile->name,
+	   bfd_errmsg (bfd_get_error ()));
+
+  /* Save the offsets, we will nuke them with the rest of the
+     objfile_obstack.  */
+  num_offsets = objfile->num_sections;
+  offsets = ((struct section_offsets *)
+	     alloca (SIZEOF_N_SECTION_OFFSETS (num_offsets)));
+  memcpy (offsets, objfile->section_offsets,
+	  SIZEOF_N_SECTION_OFFSETS (num_offsets));
+
+  /* Nuke all the state that we will re-read.  Much of the following
+     code which sets things to NULL really is necessary to tell
+     other parts of GDB that there is nothing currently there.  */
+
+  /* FIXME: Do we have to free a whole linked list, or is this
+     enough?  */
+  if (objfile->global_psymbols.list)
+    xfree (objfile->global_psymbols.list);
+  memset (&objfile->global_psymbols, 0,
+	  sizeof (objfile->global_psymbols));
+  if (objfile->static_psymbols.list)
+    xfree (objfile->static_psymbols.list);
+  memset (&objfile->static_psymbols, 0,
+	  sizeof (objfile->static_psymbols));
+
+  /* Free the obstacks for non-reusable objfiles */
+  bcache_xfree (objfile->psymbol_cache);
+  objfile->psymbol_cache = bcache_xmalloc (NULL);
+  bcache_xfree (objfile->macro_cache);
+  objfile->macro_cache = bcache_xmalloc (NULL);
+  /* APPLE LOCAL: Also delete the table of equivalent symbols.  */
+  equivalence_table_delete (objfile);
+  /* END APPLE LOCAL */
+  if (objfile->demangled_names_hash != NULL)
+    {
+      htab_delete (objfile->demangled_names_hash);
+      objfile->demangled_names_hash = NULL;
+    }
+  obstack_free (&objfile->objfile_obstack, 0);
+  objfile->sections = NULL;
+  objfile->symtabs = NULL;
+  objfile->psymtabs = NULL;
+  objfile->free_psymtabs = NULL;
+  objfile->cp_namespace_symtab = NULL;
+  objfile->msymbols = NULL;
+  objfile->deprecated_sym_private = NULL;
+  objfile->minimal_symbol_count = 0;
+  memset (&objfile->msymbol_hash, 0,
+	  sizeof (objfile->msymbol_hash));
+  memset (&objfile->msymbol_demangled_hash, 0,
+	  sizeof (objfile->msymbol_demangled_hash));
+  objfile->minimal_symbols_demangled = 0;
+  objfile->fundamental_types = NULL;
+  clear_objfile_data (objfile);
+  if (objfile->sf != NULL)
+    {
+      (*objfile->sf->sym_finish) (objfile);
+    }
+
+  /* We never make this a mapped file.  */
+  objfile->md = NULL;
+  objfile->psymbol_cache = bcache_xmalloc (NULL);
+  objfile->macro_cache = bcache_xmalloc (NULL);
+  /* obstack_init also initializes the obstack so it is
+     empty.  We could use obstack_specify_allocation but
+     gdb_obstack.h specifies the alloc/dealloc
+     functions.  */
+  obstack_init (&objfile->objfile_obstack);
+  if (build_objfile_section_table (objfile))
+    {
+      error (_("Can't find the file sections in `%s': %s"),
+	     objfile->name, bfd_errmsg (bfd_get_error ()));
+    }
+  terminate_minimal_symbol_table (objfile);
+
+  /* We use the same section offsets as from last time.  I'm not
+     sure whether that is always correct for shared libraries.  */
+  objfile->section_offsets = (struct section_offsets *)
+    obstack_alloc (&objfile->objfile_obstack,
+		   SIZEOF_N_SECTION_OFFSETS (num_offsets));
+
+  /* APPLE LOCAL: instead of just stuffing the section offsets
+     back into the objfile structure, set the new objfile offsets to
+     0 and then relocate the objfile with the original offsets.  If the
+     original offsets were 0, this is a low-cost operation, because
+     relocate_objfile checks for no change.  
+     We have to do this because, at least on Mac OS X, the way
+     we would have gotten non-zero section offsets to begin with is 
+     that the objfile got relocated by the dyld layer when the library
+     was actually loaded.  However the dyld layer now thinks this 
+     objfile is correctly slid (it has its own copy of this information, 
+     and doesn't look at anything in the objfile to figure this out.
+     So IT won't apply the slide again and we have to do it here.  */
+  memset (objfile->section_offsets, 0, SIZEOF_N_SECTION_OFFSETS (num_offsets));
+
+  objfile->num_sections = num_offsets;
+  init_entry_point_info (objfile);
+
+  objfile_relocate (objfile, offsets);
+
+  /* What the hell is sym_new_init for, anyway?  The concept of
+     distinguishing between the main file and additional files
+     in this way seems rather dubious.  */
+  if (objfile == symfile_objfile)
+    {
+      (*objfile->sf->sym_new_init) (objfile);
+    }
+
+  /* If the mtime has changed between the time we set new_modtime
+     and now, we *want* this to be out of date, so don't call stat
+     again now.  */
+  objfile->mtime = new_modtime;
+  reread_separate_symbols (objfile);
+
+  (*objfile->sf->sym_init) (objfile);
+  clear_complaints (&symfile_complaints, 1, 1);
+  /* The "mainline" parameter is a hideous hack; I think leaving it
+     zero is OK since dbxread.c also does what it needs to do if
+     objfile->global_psymbols.size is 0.  */
+  if ((objfile->symflags & ~OBJF_SYM_CONTAINER) & OBJF_SYM_LEVELS_MASK)
+    (*objfile->sf->sym_read) (objfile, 0);
+  /* APPLE LOCAL don't complain about lack of symbols */
+  objfile->flags |= OBJF_SYMS;
+
+  /* We're done reading the symbol file; finish off complaints.  */
+  clear_complaints (&symfile_complaints, 0, 1);
+
+  /* Getting new symbols may change our opinion about what is
+     frameless.  */
+
+  reinit_frame_cache ();
+
+  /* Discard cleanups as symbol reading was successful.  */
+  discard_cleanups (old_cleanups);
+
+  /* APPLE LOCAL begin breakpoints */
+  /* Finally, remember to call breakpoint_re_set with this
+     objfile, so it will get on the change list.  */
+  breakpoint_re_set (objfile);
+  /* Also re-initialize the objc trampoline data in case it's the
+     objc library that's either just been read in or has changed.  */
+  if (objfile == find_libobjc_objfile ())
+    objc_init_trampoline_observer ();
+  /* APPLE LOCAL end breakpoints */
+}
+/* APPLE LOCAL end symbol memory limit */
+
+/* APPLE LOCAL begin symbol memory limit */
+/* Return non-zero if S is one of the symbol tables of OBJFILE or of
+   its separate debug objfile.  */
+
+static int
+symtab_of_objfile_p (struct symtab *s, struct objfile *objfile)
+{
+  return (s != NULL
+	  && (s->objfile == objfile
+	      || (s->objfile != NULL
+		  && s->objfile == objfile->separate_debug_objfile)));
+}
+
+/* Return non-zero if anything the user can get back to points into
+   the symbols of OBJFILE: the value history, the convenience
+   variables, the auto-display expressions, the breakpoint conditions
+   and watchpoint expressions, the current source file or the default
+   breakpoint location.  */
+
+static int
+objfile_has_users_p (struct objfile *objfile)
+{
+  struct objfile *debug = objfile->separate_debug_objfile;
+
+  if (symtab_of_objfile_p (get_current_source_symtab_and_line ().symtab,
+			   objfile)
+      || symtab_of_objfile_p (get_default_breakpoint_symtab (), objfile))
+    return 1;
+
+  if (values_use_objfile (objfile) || displays_use_objfile (objfile)
+      || breakpoints_use_objfile (objfile))
+    return 1;
+  if (debug != NULL
+      && (values_use_objfile (debug) || displays_use_objfile (debug)
+	  || breakpoints_use_objfile (debug)))
+    return 1;
+
+  return 0;
+}
+
+/* Return how many bytes throwing away the full symbol tables of
+   OBJFILE, and of its separate debug objfile, is expected to give
+   back.  */
+
+static unsigned long
+objfile_symtab_memory (struct objfile *objfile)
+{
+  unsigned long total = 0;
+  struct objfile *o;
+
+  for (o = objfile; o != NULL; o = o->separate_debug_objfile)
+    {
+      unsigned long used = objfile_memory_used (o);
+
+      if (used > o->symtab_base_memory)
+	total += used - o->symtab_base_memory;
+    }
+  return total;
+}
+
+/* Return non-zero if enforce_symbol_memory_limit may throw away the
+   symbols of OBJFILE.  CURRENT is the objfile the program is stopped
+   in, if any; its symbols would only be read right back.  */
+
+static int
+objfile_evictable_p (struct objfile *objfile, struct objfile *current)
+{
+  struct objfile *debug = objfile->separate_debug_objfile;
+  struct stat buf;
+
+  /* A separate debug objfile is reread with its parent.  */
+  if (objfile->separate_debug_objfile_backlink != NULL)
+    return 0;
+  if (objfile == current || (debug != NULL && debug == current))
+    return 0;
+  if (objfile->symflags & OBJF_SYM_DONT_CHANGE)
+    return 0;
+
+  /* There is nothing to gain unless some symbol tables have been
+     expanded.  */
+  if (objfile->symtabs == NULL && (debug == NULL || debug->symtabs == NULL))
+    return 0;
+
+  /* Only evict what we can read back from the same file: not
+     objfiles read from target memory, and not files that have
+     changed (reread_symbols deals with those).  */
+  if (objfile->obfd == NULL
+      || stat (objfile->obfd->filename, &buf) != 0
+      || buf.st_mtime != objfile->mtime)
+    return 0;
+
+  return !objfile_has_users_p (objfile);
+}
+
+static int
+reread_objfile_stub (void *arg)
+{
+  struct objfile *objfile = (struct objfile *) arg;
+  struct objfile *o;
+
+  reread_objfile (objfile, objfile->mtime);
+
+  /* Whatever is left is what a later eviction can't free.  */
+  for (o = objfile; o != NULL; o = o->separate_debug_objfile)
+    o->symtab_base_memory = objfile_memory_used (o);
+  return 1;
+}
+
+/* While the symbols of all objfiles use more memory than
+   symbol_memory_limit allows, throw away the full symbol tables of
+   the objfile whose symbols were least recently asked for, leaving
+   it with its minimal and partial symbols as when it was first read.
+
+   Objfiles that anything the user can get back to points into are
+   left alone, so the value history, the auto-display expressions, the
+   convenience variables and the breakpoint conditions survive.  Minimal and partial symbols
+   can't be thrown away; if the rest can't bring the total under the
+   limit, nothing is thrown away at all.  The caller must make sure
+   this only runs between commands the user types.  */
+
+void
+enforce_symbol_memory_limit (void)
+{
+  struct objfile *objfile, *victim, *current = NULL;
+  struct obj_section *osect;
+  struct varobj **varobjs;
+  struct frame_id selected_id = null_frame_id;
+  struct frame_info *fi;
+  ULONGEST limit, used, reclaimable, last_used;
+  int evicted = 0;
+
+  if (symbol_memory_limit == UINT_MAX)
+    return;
+
+  limit = (ULONGEST) symbol_memory_limit * 1024 * 1024;
+  used = 0;
+  ALL_OBJFILES (objfile)
+    used += objfile_memory_used (objfile);
+  if (used <= limit)
+    return;
+
+  /* We have no way to tell an MI front end that the types and
+     values of its variable objects went away.  */
+  if (varobj_list (&varobjs) > 0)
+    {
+      xfree (varobjs);
+      return;
+    }
+  xfree (varobjs);
+
+  if (target_has_execution)
+    {
+      osect = find_pc_section (stop_pc);
+      if (osect != NULL)
+	current = osect->objfile;
+    }
+
+  reclaimable = 0;
+  ALL_OBJFILES (objfile)
+    if (objfile_evictable_p (objfile, current))
+      reclaimable += objfile_symtab_memory (objfile);
+  if (used - reclaimable > limit)
+    return;
+
+  if (deprecated_selected_frame != NULL)
+    selected_id = get_frame_id (deprecated_selected_frame);
+
+  last_used = used + 1;
+  while (used > limit && used < last_used)
+    {
+      victim = NULL;
+      ALL_OBJFILES (objfile)
+	if (objfile_evictable_p (objfile, current)
+	    && objfile_symtab_memory (objfile) > 0
+	    && (victim == NULL || objfile->last_used < victim->last_used))
+	  victim = objfile;
+      if (victim == NULL)
+	break;
+
+      if (info_verbose)
+	printf_unfiltered (_("Discarding symbol tables of `%s'.\n"),
+			   victim->name);
+      catch_errors (reread_objfile_stub, victim,
+		    "Error while discarding symbol tables:\n",
+		    RETURN_MASK_ALL);
+      evicted = 1;
+
+      last_used = used;
+      used = 0;
+      ALL_OBJFILES (objfile)
+	used += objfile_memory_used (objfile);
+    }
+
+  if (evicted)
+    {
+      /* Only the caches that point into symbols need to go; unlike
+	 clear_symtab_users, leave everything the user set alone.  */
+      clear_pc_function_cache ();
+      if (deprecated_target_new_objfile_hook)
+	deprecated_target_new_objfile_hook (NULL);
+
+      /* reread_objfile flushed the frame cache; go back to the frame
+	 the user had selected.  */
+      if (frame_id_p (selected_id)
+	  && (fi = frame_find_by_id (selected_id)) != NULL)
+	select_frame (fi);
+    }
+}
+
+static void
+show_symbol_memory_limit (struct ui_file *file, int from_tty,
+			  struct cmd_list_element *c, const char *value)
+{
+  if (symbol_memory_limit == UINT_MAX)
+    fprintf_filtered (file, _("\
+There is no memory limit for symbol tables.\n"));
+  else
+    fprintf_filtered (file, _("\
+The memory limit for symbol tables is %s megabytes.\n"),
+		      value);
+}
+/* APPLE LOCAL end symbol memory limit */
+
 /* Re-read symbols if a symbol-file has changed.  */
 void
 reread_symbols (void)
@@ -3143,6 +3640,8 @@ reread_symbols (void)
   struct objfile *objfile, *next;
   long new_modtime;
   int reread_one = 0;
+  /* APPLE LOCAL symbol memory limit */
+  struct cleanup *clear_chain;
 
   /* With the addition of shared libraries, this should be modified,
      the load time should be saved in the partial symbol tables, since
@@ -3202,234 +3701,23 @@ reread_symbols (void)
 	    }
 	  else if (new_modtime != objfile->mtime)
 	    {
-	      struct cleanup *old_cleanups;
-	      struct section_offsets *offsets;
-	      int num_offsets;
-	      char *obfd_filename;
-
 	      printf_unfiltered (_("`%s' has changed; re-reading symbols.\n"),
 			       objfile->name);
 
-	      /* There are various functions like symbol_file_add,
-	         symfile_bfd_open, syms_from_objfile, etc., which might
-	         appear to do what we want.  But they have various other
-	         effects which we *don't* want.  So we just do stuff
-	         ourselves.  We don't worry about mapped files (for one thing,
-	         any mapped file will be out of date).  */
-
-	      /* If we get an error, blow away this objfile (not sure if
-	         that is the correct response for things like shared
-	         libraries).  */
-	      old_cleanups = make_cleanup_free_objfile (objfile);
-	      /* We need to do this whenever any symbols go away.  */
-	      make_cleanup (clear_symtab_users_cleanup, 0 /*ignore*/);
-
-
-	      /* If this objfile has a separate debug objfile, clear it
-		 out here.  */
-	      if (objfile->separate_debug_objfile != NULL)
-		{
-		  /* ALL_OBJFILES_SAFE isn't actually safe if you delete
-		     the NEXT objfile...  */
-		  if (objfile->separate_debug_objfile == next)
-		    next = objfile_get_next (next);
-
-		  free_objfile (objfile->separate_debug_objfile);
-		  objfile->separate_debug_objfile = NULL;
-		}
-
-	      /* APPLE LOCAL: Before we clean up any state, tell the
-		 breakpoint system that this objfile has changed so it
-		 can clear the set state on any breakpoints in this
-		 objfile. */
-
-	      tell_breakpoints_objfile_changed (objfile);
-	      tell_objc_msgsend_cacher_objfile_changed (objfile);
-
-	      /* APPLE LOCAL cache lookup values for improved performance  */
-	      symtab_clear_cached_lookup_values ();
-	      /* APPLE LOCAL: Remove it's obj_sections from the 
-		 ordered_section list.  */
-	      objfile_delete_from_ordered_sections (objfile);
-
-	      /* Clean up any state BFD has sitting around.  We don't need
-	         to close the descriptor but BFD lacks a way of closing the
-	         BFD without closing the descriptor.  */
-	      obfd_filename = bfd_get_filename (objfile->obfd);
-
-	      /* APPLE LOCAL: Remember to remove its sections from the 
-		 target "to_sections".  Normally this is done in 
-		 free_objfile, but here we're remaking the objfile
-	         "in place" so we have to do it by hand.  */
-	      remove_target_sections (objfile->obfd);
-
-	      if (!bfd_close (objfile->obfd))
-		error (_("Can't close BFD for %s: %s"), objfile->name,
-		       bfd_errmsg (bfd_get_error ()));
-	      objfile->obfd = bfd_openr (obfd_filename, gnutarget);
-	      if (objfile->obfd == NULL)
-		error (_("Can't open %s to read symbols."), objfile->name);
-	      /* bfd_openr sets cacheable to true, which is what we want.  */
-
-	      /* APPLE LOCAL: If the file is an archive file (i.e. fat
-		 binary), look for sub-files that match the current
-		 osabi. */
-
-	      if (bfd_check_format (objfile->obfd, bfd_archive))
-		{
-		  bfd *tmp_bfd;
-		  tmp_bfd = open_bfd_matching_arch (objfile->obfd, bfd_object);
-		  if (tmp_bfd != NULL)
-		    objfile->obfd = tmp_bfd;
-		}
-
-	      if (!bfd_check_format (objfile->obfd, bfd_object))
-		error (_("Can't read symbols from %s: %s."), objfile->name,
-		       bfd_errmsg (bfd_get_error ()));
-
-	      /* Save the offsets, we will nuke them with the rest of the
-	         objfile_obstack.  */
-	      num_offsets = objfile->num_sections;
-	      offsets = ((struct section_offsets *)
-			 alloca (SIZEOF_N_SECTION_OFFSETS (num_offsets)));
-	      memcpy (offsets, objfile->section_offsets,
-		      SIZEOF_N_SECTION_OFFSETS (num_offsets));
-
-	      /* Nuke all the state that we will re-read.  Much of the following
-	         code which sets things to NULL really is necessary to tell
-	         other parts of GDB that there is nothing currently there.  */
-
-	      /* FIXME: Do we have to free a whole linked list, or is this
-	         enough?  */
-	      if (objfile->global_psymbols.list)
-		xfree (objfile->global_psymbols.list);
-	      memset (&objfile->global_psymbols, 0,
-		      sizeof (objfile->global_psymbols));
-	      if (objfile->static_psymbols.list)
-		xfree (objfile->static_psymbols.list);
-	      memset (&objfile->static_psymbols, 0,
-		      sizeof (objfile->static_psymbols));
-
-	      /* Free the obstacks for non-reusable objfiles */
-	      bcache_xfree (objfile->psymbol_cache);
-	      objfile->psymbol_cache = bcache_xmalloc (NULL);
-	      bcache_xfree (objfile->macro_cache);
-	      objfile->macro_cache = bcache_xmalloc (NULL);
-	      /* APPLE LOCAL: Also delete the table of equivalent symbols.  */
-	      equivalence_table_delete (objfile);
-	      /* END APPLE LOCAL */
-	      if (objfile->demangled_names_hash != NULL)
-		{
-		  htab_delete (objfile->demangled_names_hash);
-		  objfile->demangled_names_hash = NULL;
-		}
-	      obstack_free (&objfile->objfile_obstack, 0);
-	      objfile->sections = NULL;
-	      objfile->symtabs = NULL;
-	      objfile->psymtabs = NULL;
-	      objfile->free_psymtabs = NULL;
-	      objfile->cp_namespace_symtab = NULL;
-	      objfile->msymbols = NULL;
-	      objfile->deprecated_sym_private = NULL;
-	      objfile->minimal_symbol_count = 0;
-	      memset (&objfile->msymbol_hash, 0,
-		      sizeof (objfile->msymbol_hash));
-	      memset (&objfile->msymbol_demangled_hash, 0,
-		      sizeof (objfile->msymbol_demangled_hash));
-	      objfile->minimal_symbols_demangled = 0;
-	      objfile->fundamental_types = NULL;
-	      clear_objfile_data (objfile);
-	      if (objfile->sf != NULL)
-		{
-		  (*objfile->sf->sym_finish) (objfile);
-		}
+	      /* ALL_OBJFILES_SAFE isn't actually safe if you delete
+		 the NEXT objfile...  */
+	      if (objfile->separate_debug_objfile != NULL
+		  && objfile->separate_debug_objfile == next)
+		next = objfile_get_next (next);
 
-	      /* We never make this a mapped file.  */
-	      objfile->md = NULL;
-	      objfile->psymbol_cache = bcache_xmalloc (NULL);
-	      objfile->macro_cache = bcache_xmalloc (NULL);
-	      /* obstack_init also initializes the obstack so it is
-	         empty.  We could use obstack_specify_allocation but
-	         gdb_obstack.h specifies the alloc/dealloc
-	         functions.  */
-	      obstack_init (&objfile->objfile_obstack);
-	      if (build_objfile_section_table (objfile))
-		{
-		  error (_("Can't find the file sections in `%s': %s"),
-			 objfile->name, bfd_errmsg (bfd_get_error ()));
-		}
-              terminate_minimal_symbol_table (objfile);
-
-	      /* We use the same section offsets as from last time.  I'm not
-	         sure whether that is always correct for shared libraries.  */
-	      objfile->section_offsets = (struct section_offsets *)
-		obstack_alloc (&objfile->objfile_obstack,
-			       SIZEOF_N_SECTION_OFFSETS (num_offsets));
-
- 	      /* APPLE LOCAL: instead of just stuffing the section offsets
- 		 back into the objfile structure, set the new objfile offsets to
- 		 0 and then relocate the objfile with the original offsets.  If the
- 		 original offsets were 0, this is a low-cost operation, because
- 		 relocate_objfile checks for no change.  
- 		 We have to do this because, at least on Mac OS X, the way
- 		 we would have gotten non-zero section offsets to begin with is 
- 		 that the objfile got relocated by the dyld layer when the library
- 		 was actually loaded.  However the dyld layer now thinks this 
- 		 objfile is correctly slid (it has its own copy of this information, 
- 		 and doesn't look at anything in the objfile to figure this out.
- 		 So IT won't apply the slide again and we have to do it here.  */
- 	      memset (objfile->section_offsets, 0, SIZEOF_N_SECTION_OFFSETS (num_offsets));
-
-	      objfile->num_sections = num_offsets;
-	      init_entry_point_info (objfile);
-
- 	      objfile_relocate (objfile, offsets);
-
-	      /* What the hell is sym_new_init for, anyway?  The concept of
-	         distinguishing between the main file and additional files
-	         in this way seems rather dubious.  */
-	      if (objfile == symfile_objfile)
-		{
-		  (*objfile->sf->sym_new_init) (objfile);
-		}
-
-	      /* If the mtime has changed between the time we set new_modtime
-	         and now, we *want* this to be out of date, so don't call stat
-	         again now.  */
-	      objfile->mtime = new_modtime;
+	      /* APPLE LOCAL begin symbol memory limit */
+	      /* We need to do this whenever any symbols go away.  */
+	      clear_chain = make_cleanup (clear_symtab_users_cleanup,
+					  0 /*ignore*/);
+	      reread_objfile (objfile, new_modtime);
+	      discard_cleanups (clear_chain);
+	      /* APPLE LOCAL end symbol memory limit */
 	      reread_one = 1;
-              reread_separate_symbols (objfile);
-
-	      (*objfile->sf->sym_init) (objfile);
-	      clear_complaints (&symfile_complaints, 1, 1);
-	      /* The "mainline" parameter is a hideous hack; I think leaving it
-	         zero is OK since dbxread.c also does what it needs to do if
-	         objfile->global_psymbols.size is 0.  */
-	      if ((objfile->symflags & ~OBJF_SYM_CONTAINER) & OBJF_SYM_LEVELS_MASK)
-		(*objfile->sf->sym_read) (objfile, 0);
-	      /* APPLE LOCAL don't complain about lack of symbols */
-	      objfile->flags |= OBJF_SYMS;
-
-	      /* We're done reading the symbol file; finish off complaints.  */
-	      clear_complaints (&symfile_complaints, 0, 1);
-
-	      /* Getting new symbols may change our opinion about what is
-	         frameless.  */
-
-	      reinit_frame_cache ();
-
-	      /* Discard cleanups as symbol reading was successful.  */
-	      discard_cleanups (old_cleanups);
-
-	      /* APPLE LOCAL begin breakpoints */
-	      /* Finally, remember to call breakpoint_re_set with this
-		 objfile, so it will get on the change list.  */
-	      breakpoint_re_set (objfile);
-	      /* Also re-initialize the objc trampoline data in case it's the
-		 objc library that's either just been read in or has changed.  */
-	      if (objfile == find_libobjc_objfile ())
-		objc_init_trampoline_observer ();
-	      /* APPLE LOCAL end breakpoints */
 	    }
 	}
     }
@@ -3864,6 +4152,8 @@ allocate_psymtab (char *filename, struct objfile *objfile)
   psymtab->objfile = objfile;
   psymtab->next = objfile->psymtabs;
   objfile->psymtabs = psymtab;
+  /* APPLE LOCAL transparent type cache */
+  objfile_generation++;
 #if 0
   {
     struct partial_symtab **prev_pst;
@@ -3910,6 +4200,8 @@ discard_psymtab (struct partial_symtab *pst)
 
   pst->next = pst->objfile->free_psymtabs;
   pst->objfile->free_psymtabs = pst;
+  /* APPLE LOCAL transparent type cache */
+  objfile_generation++;
 }
 
 
@@ -5509,6 +5801,22 @@ bundle and dSYM in another location."),
 				     NULL,
 				     &setlist, &showlist);
 
+  /* APPLE LOCAL begin symbol memory limit */
+  add_setshow_uinteger_cmd ("symbol-memory-limit", class_support,
+			    &symbol_memory_limit, _("\
+Set the memory limit, in megabytes, for symbol tables."), _("\
+Show the memory limit, in megabytes, for symbol tables."), _("\
+When the symbols of all object files use more memory than this, GDB\n\
+throws away the full symbol tables of the least recently used object\n\
+files, and reads them again if they are needed.  Object files that\n\
+the value history, the auto-display expressions, the convenience\n\
+variables or the breakpoint conditions and watchpoint expressions\n\
+refer to are kept.  A value of zero means no limit."),
+			    NULL,
+			    show_symbol_memory_limit,
+			    &setlist, &showlist);
+  /* APPLE LOCAL end symbol memory limit */
+
   debug_file_directory = xstrdup (DEBUGDIR);
   add_setshow_optional_filename_cmd ("debug-file-directory", class_support,
 				     &debug_file_directory, _("\
@@ -134,6 +134,15 @@ struct sym_fns
 
   void (*sym_offsets) (struct objfile *, struct section_addr_info *);
 
+  /* APPLE LOCAL begin deferred solib symbols */
+  /* sym_read_psymtabs (objfile) Reads the debugging information of
+     an objfile whose sym_read was called without OBJF_SYM_DEBUG in
+     its symflags, which should be set by the time this is called.
+     NULL if the reader can only read everything in sym_read.  */
+
+  void (*sym_read_psymtabs) (struct objfile *);
+  /* APPLE LOCAL end deferred solib symbols */
+
   /* Finds the next struct sym_fns.  They are allocated and
      initialized in whatever module implements the functions pointed
      to; an initializer calls add_symtab_fns to add them to the global
@@ -355,6 +364,10 @@ extern void dwarf2_scan_inlined_section_for_psymbols (struct partial_symtab *,
 extern struct bfd *open_bfd_from_oso (struct partial_symtab *pst, int *cached);
 extern void clear_containing_archive_cache (void);
 extern void close_bfd_or_archive (bfd *abfd);
+/* APPLE LOCAL begin oso prefetch */
+extern int oso_objfiles_present (void);
+extern void oso_prefetch_psymtab (struct partial_symtab *pst);
+/* APPLE LOCAL end oso prefetch */
 
 struct nlist_rec 
 {
@@ -387,6 +400,10 @@ extern void elfmdebug_build_psymtabs (struct objfile *,
 
 extern bfd *symfile_bfd_open_safe (const char *filename, int mainline);
 
+/* APPLE LOCAL deferred solib symbols: Return non-zero if the reader
+   for ABFD can read its debugging information after the rest.  */
+extern int symfile_can_defer_debug_info (bfd *abfd);
+
 extern struct objfile *symbol_file_add_bfd_safe
 (bfd *abfd, int from_tty, struct section_addr_info *addrs, struct section_offsets *offsets,
  int mainline, int flags, int symflags, CORE_ADDR mapaddr, const char *prefix,
@@ -240,6 +240,12 @@ print_objfile_statistics (void)
 		     bcache_memory_used (objfile->psymbol_cache));
     printf_filtered (_("  Total memory used for macro cache: %d\n"),
 		     bcache_memory_used (objfile->macro_cache));
+    /* APPLE LOCAL demangle cache */
+    printf_filtered (_("  Total memory used for demangled name cache: %lu\n"),
+		     demangle_cache_memory_used (objfile));
+    /* APPLE LOCAL symbol memory limit */
+    printf_filtered (_("  Total memory used for symbols: %lu\n"),
+		     objfile_memory_used (objfile));
   }
   immediate_quit--;
 }
@@ -439,18 +445,90 @@ dump_psymtab (struct objfile *objfile, struct partial_symtab *psymtab,
   fprintf_filtered (outfile, "\n");
 }
 
+/* APPLE LOCAL begin lazy function bodies  */
+/* Print block B, number I in its blockvector, and its symbols to
+   OUTFILE.  */
+
+static void
+dump_block (struct block *b, int i, struct ui_file *outfile)
+{
+  struct dict_iterator iter;
+  struct symbol *sym;
+  int depth;
+
+  depth = block_depth (b) * 2;
+  print_spaces (depth, outfile);
+  fprintf_filtered (outfile, "block #%03d, object at ", i);
+  gdb_print_host_address (b, outfile);
+  if (BLOCK_SUPERBLOCK (b))
+    {
+      fprintf_filtered (outfile, " under ");
+      gdb_print_host_address (BLOCK_SUPERBLOCK (b), outfile);
+    }
+  /* drow/2002-07-10: We could save the total symbols count
+     even if we're using a hashtable, but nothing else but this message
+     wants it.  */
+  fprintf_filtered (outfile, ", %d syms/buckets in ",
+		    dict_size (BLOCK_DICT (b)));
+
+  if (!BLOCK_RANGES (b))
+    {
+      deprecated_print_address_numeric (BLOCK_START (b), 1, outfile);
+      fprintf_filtered (outfile, "..");
+      deprecated_print_address_numeric (BLOCK_END (b), 1, outfile);
+    }
+  else
+    {
+      int j;
+      for (j = 0; j < BLOCK_RANGES (b)->nelts; j++)
+	{
+	  if (j > 0)
+	    fprintf_filtered (outfile, "\n");
+	  deprecated_print_address_numeric (BLOCK_RANGE_START (b, j), 1,
+					    outfile);
+	  fprintf_filtered (outfile, "..");
+	  deprecated_print_address_numeric (BLOCK_RANGE_END (b, j), 1,
+					    outfile);
+	}
+    }
+
+  if (BLOCK_FUNCTION (b))
+    {
+      fprintf_filtered (outfile, ", function %s", DEPRECATED_SYMBOL_NAME (BLOCK_FUNCTION (b)));
+      if (SYMBOL_DEMANGLED_NAME (BLOCK_FUNCTION (b)) != NULL)
+	{
+	  fprintf_filtered (outfile, ", %s",
+			SYMBOL_DEMANGLED_NAME (BLOCK_FUNCTION (b)));
+	}
+    }
+  if (BLOCK_GCC_COMPILED (b))
+    fprintf_filtered (outfile, ", compiled with gcc%d", BLOCK_GCC_COMPILED (b));
+  fprintf_filtered (outfile, "\n");
+  /* Now print each symbol in this block (in no particular order, if
+     we're using a hashtable).  */
+  ALL_BLOCK_SYMBOLS (b, iter, sym)
+    {
+      struct print_symbol_args s;
+      s.symbol = sym;
+      s.depth = depth + 1;
+      s.outfile = outfile;
+      catch_errors (print_symbol, &s, "Error printing symbol:\n",
+		    RETURN_MASK_ALL);
+    }
+}
+/* APPLE LOCAL end lazy function bodies  */
+
 static void
 dump_symtab_1 (struct objfile *objfile, struct symtab *symtab,
 	       struct ui_file *outfile)
 {
   int i;
-  struct dict_iterator iter;
+  /* APPLE LOCAL lazy function bodies  */
+  int j;
   int len;
   struct linetable *l;
   struct blockvector *bv;
-  struct symbol *sym;
   struct block *b;
-  int depth;
 
   fprintf_filtered (outfile, "\nSymtab for file %s\n", symtab->filename);
   if (symtab->dirname)
@@ -484,67 +562,15 @@ dump_symtab_1 (struct objfile *objfile, struct symtab *symtab,
       for (i = 0; i < len; i++)
 	{
 	  b = BLOCKVECTOR_BLOCK (bv, i);
-	  depth = block_depth (b) * 2;
-	  print_spaces (depth, outfile);
-	  fprintf_filtered (outfile, "block #%03d, object at ", i);
-	  gdb_print_host_address (b, outfile);
-	  if (BLOCK_SUPERBLOCK (b))
-	    {
-	      fprintf_filtered (outfile, " under ");
-	      gdb_print_host_address (BLOCK_SUPERBLOCK (b), outfile);
-	    }
-	  /* drow/2002-07-10: We could save the total symbols count
-	     even if we're using a hashtable, but nothing else but this message
-	     wants it.  */
-	  fprintf_filtered (outfile, ", %d syms/buckets in ",
-			    dict_size (BLOCK_DICT (b)));
-
-	  /* APPLE LOCAL begin address ranges  */
-	  if (!BLOCK_RANGES (b))
-	    {
-	      deprecated_print_address_numeric (BLOCK_START (b), 1, outfile);
-	      fprintf_filtered (outfile, "..");
-	      deprecated_print_address_numeric (BLOCK_END (b), 1, outfile);
-	    }
-	  else
-	    {
-	      int j;
-	      for (j = 0; j < BLOCK_RANGES (b)->nelts; j++)
-		{
-		  if (j > 0)
-		    fprintf_filtered (outfile, "\n");
-		  deprecated_print_address_numeric (BLOCK_RANGE_START (b, j), 1,
-						    outfile);
-		  fprintf_filtered (outfile, "..");
-		  deprecated_print_address_numeric (BLOCK_RANGE_END (b, j), 1,
-						    outfile);
-		}
-	    }
-	  /* APPLE LOCAL end address ranges  */
-
-	  if (BLOCK_FUNCTION (b))
-	    {
-	      fprintf_filtered (outfile, ", function %s", DEPRECATED_SYMBOL_NAME (BLOCK_FUNCTION (b)));
-	      if (SYMBOL_DEMANGLED_NAME (BLOCK_FUNCTION (b)) != NULL)
-		{
-		  fprintf_filtered (outfile, ", %s",
-				SYMBOL_DEMANGLED_NAME (BLOCK_FUNCTION (b)));
-		}
-	    }
-	  if (BLOCK_GCC_COMPILED (b))
-	    fprintf_filtered (outfile, ", compiled with gcc%d", BLOCK_GCC_COMPILED (b));
-	  fprintf_filtered (outfile, "\n");
-	  /* Now print each symbol in this block (in no particular order, if
-	     we're using a hashtable).  */
-	  ALL_BLOCK_SYMBOLS (b, iter, sym)
-	    {
-	      struct print_symbol_args s;
-	      s.symbol = sym;
-	      s.depth = depth + 1;
-	      s.outfile = outfile;
-	      catch_errors (print_symbol, &s, "Error printing symbol:\n",
-			    RETURN_MASK_ALL);
-	    }
+	  /* APPLE LOCAL begin lazy function bodies  */
+	  dump_block (b, i, outfile);
+	  /* The blocks inside a function whose body was read in later
+	     are only in the function's own blockvector.  */
+	  if (BLOCK_NESTED (b) != NULL)
+	    for (j = FIRST_LOCAL_BLOCK + 1;
+		 j < BLOCKVECTOR_NBLOCKS (BLOCK_NESTED (b)); j++)
+	      dump_block (BLOCKVECTOR_BLOCK (BLOCK_NESTED (b), j), j, outfile);
+	  /* APPLE LOCAL end lazy function bodies  */
 	}
       fprintf_filtered (outfile, "\n");
     }
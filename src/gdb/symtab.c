@@ -38,6 +38,8 @@
 #include "demangle.h"
 #include "inferior.h"
 #include "linespec.h"
+/* APPLE LOCAL max-completions */
+#include "completer.h"
 #include "source.h"
 #include "filenames.h"		/* for FILENAME_CMP */
 #include "objc-lang.h"
@@ -781,23 +783,210 @@ create_demangled_names_hash (struct objfile *objfile)
      The hash table code will round this up to the next prime number. 
      Choosing a much larger table size wastes memory, and saves only about
      1% in symbol reading.  */
+  long size = 256;
+
+  /* APPLE LOCAL begin demangle cache */
+  /* But every name in the objfile's symbol table ends up in here, so
+     make room for them all at once rather than growing the table
+     again and again.  Leave the table no more than 3/4 full, as the
+     hash table code would.  */
+  if (objfile->obfd != NULL
+      && (bfd_get_file_flags (objfile->obfd) & HAS_SYMS))
+    {
+      long upper = bfd_get_symtab_upper_bound (objfile->obfd);
+
+      if (upper > 0 && upper / (long) sizeof (asymbol *) * 4 / 3 > size)
+	size = upper / (long) sizeof (asymbol *) * 4 / 3;
+    }
+  /* APPLE LOCAL end demangle cache */
 
   objfile->demangled_names_hash = htab_create_alloc
-    (256, htab_hash_string, (int (*) (const void *, const void *)) streq,
+    (size, htab_hash_string, (int (*) (const void *, const void *)) streq,
      NULL, xcalloc, xfree);
 }
 
+/* APPLE LOCAL begin demangle cache */
+/* Demangling C++ names is one of the most expensive parts of reading
+   symbols, and the same names turn up again and again: in the minimal,
+   partial and full symbols of an objfile, and in each library that
+   instantiates the same templates.  So we keep what cplus_demangle
+   made of each V3 ABI name.  Each entry belongs to the objfile whose
+   symbols first needed it, and goes away when that objfile is freed
+   or its symbols are thrown away; its size counts towards the
+   objfile's memory use.  */
+
+struct cplus_demangle_cache_entry
+{
+  /* The objfile this entry belongs to.  */
+  struct objfile *objfile;
+
+  /* What cplus_demangle returned for MANGLED, or NULL.  When not
+     NULL, this points just past MANGLED's terminating null.  */
+  char *demangled;
+
+  /* The mangled name, followed by the demangled one.  */
+  char mangled[1];
+};
+
+static htab_t cplus_demangle_cache;
+
+/* How many bytes of cplus_demangle_cache entries an objfile owns.
+   This is the objfile's data for cplus_demangle_cache_key.  */
+
+struct cplus_demangle_cache_usage
+{
+  unsigned long bytes;
+};
+
+static const struct objfile_data *cplus_demangle_cache_key;
+
+static hashval_t
+hash_cplus_demangle_cache_entry (const void *p)
+{
+  const struct cplus_demangle_cache_entry *entry = p;
+
+  return htab_hash_string (entry->mangled);
+}
+
+static int
+eq_cplus_demangle_cache_entry (const void *p, const void *mangled)
+{
+  const struct cplus_demangle_cache_entry *entry = p;
+
+  return strcmp (entry->mangled, mangled) == 0;
+}
+
+/* Remove the entry in SLOT from the cache if it belongs to the
+   objfile OBJFILE_PTR.  */
+
+static int
+free_cplus_demangle_cache_entry (void **slot, void *objfile_ptr)
+{
+  struct cplus_demangle_cache_entry *entry = *slot;
+
+  if (entry->objfile == objfile_ptr)
+    {
+      htab_clear_slot (cplus_demangle_cache, slot);
+      xfree (entry);
+    }
+  return 1;
+}
+
+/* Throw away the cache entries of OBJFILE, whose usage is ARG.  */
+
+static void
+free_cplus_demangle_cache_usage (struct objfile *objfile, void *arg)
+{
+  if (cplus_demangle_cache != NULL)
+    htab_traverse_noresize (cplus_demangle_cache,
+			    free_cplus_demangle_cache_entry, objfile);
+  xfree (arg);
+}
+
+/* Return the number of bytes of demangled names OBJFILE keeps in the
+   cache.  */
+
+unsigned long
+demangle_cache_memory_used (struct objfile *objfile)
+{
+  struct cplus_demangle_cache_usage *usage;
+
+  usage = objfile_data (objfile, cplus_demangle_cache_key);
+  return usage != NULL ? usage->bytes : 0;
+}
+
+/* Return what cplus_demangle (MANGLED, DMGL_PARAMS | DMGL_ANSI) would
+   for a symbol of OBJFILE.  The result usually lives in the cache and
+   must not be freed; when it doesn't, *TO_FREE is set to it as well,
+   and the caller must xfree it.  */
+
+static const char *
+cached_cplus_demangle (const char *mangled, struct objfile *objfile,
+		       char **to_free)
+{
+  struct cplus_demangle_cache_entry *entry;
+  struct cplus_demangle_cache_usage *usage;
+  void **slot;
+  char *demangled;
+  size_t size;
+  int len, demangled_len;
+
+  /* Other styles demangle these names differently, and other names
+     aren't worth keeping.  Without an objfile there is no one for
+     the entry to belong to.  */
+  if (objfile == NULL
+      || !(mangled[0] == '_'
+	   && (mangled[1] == 'Z' || (mangled[1] == '_' && mangled[2] == 'Z')))
+      || (current_demangling_style != auto_demangling
+	  && current_demangling_style != gnu_v3_demangling))
+    {
+      *to_free = cplus_demangle (mangled, DMGL_PARAMS | DMGL_ANSI);
+      return *to_free;
+    }
+
+  if (cplus_demangle_cache == NULL)
+    cplus_demangle_cache = htab_create_alloc
+      (1024, hash_cplus_demangle_cache_entry, eq_cplus_demangle_cache_entry,
+       NULL, xcalloc, xfree);
+
+  *to_free = NULL;
+  slot = htab_find_slot_with_hash (cplus_demangle_cache, mangled,
+				   htab_hash_string (mangled), INSERT);
+  if (*slot != NULL)
+    {
+      entry = *slot;
+      return entry->demangled;
+    }
+
+  demangled = cplus_demangle (mangled, DMGL_PARAMS | DMGL_ANSI);
+  len = strlen (mangled);
+  demangled_len = demangled != NULL ? strlen (demangled) : 0;
+
+  size = sizeof (struct cplus_demangle_cache_entry) + len + demangled_len + 1;
+  entry = xmalloc (size);
+  entry->objfile = objfile;
+  memcpy (entry->mangled, mangled, len + 1);
+  if (demangled != NULL)
+    {
+      entry->demangled = entry->mangled + len + 1;
+      memcpy (entry->demangled, demangled, demangled_len + 1);
+      xfree (demangled);
+    }
+  else
+    entry->demangled = NULL;
+  *slot = entry;
+
+  usage = objfile_data (objfile, cplus_demangle_cache_key);
+  if (usage == NULL)
+    {
+      usage = XMALLOC (struct cplus_demangle_cache_usage);
+      usage->bytes = 0;
+      set_objfile_data (objfile, cplus_demangle_cache_key, usage);
+    }
+  usage->bytes += size;
+
+  return entry->demangled;
+}
+/* APPLE LOCAL end demangle cache */
+
 /* Try to determine the demangled name for a symbol, based on the
    language of that symbol.  If the language is set to language_auto,
    it will attempt to find any demangling algorithm that works and
-   then set the language appropriately.  The returned name is allocated
-   by the demangler and should be xfree'd.  */
+   then set the language appropriately.  APPLE LOCAL demangle cache:
+   OBJFILE is the objfile the symbol belongs to, or NULL.  When the
+   returned name was allocated by the demangler, *TO_FREE is set to it
+   and should be xfree'd; otherwise *TO_FREE is set to NULL.  */
 
-static char *
+static const char *
 symbol_find_demangled_name (struct general_symbol_info *gsymbol,
-			    const char *mangled)
+			    const char *mangled, struct objfile *objfile,
+			    char **to_free)
 {
   char *demangled = NULL;
+  /* APPLE LOCAL demangle cache */
+  const char *cached;
+
+  *to_free = NULL;
 
   if (gsymbol->language == language_unknown)
     gsymbol->language = language_auto;
@@ -812,6 +1001,8 @@ symbol_find_demangled_name (struct general_symbol_info *gsymbol,
       if (demangled != NULL)
 	{
 	  gsymbol->language = language_objc;
+	  /* APPLE LOCAL demangle cache */
+	  *to_free = demangled;
 	  return demangled;
 	}
     }
@@ -820,17 +1011,17 @@ symbol_find_demangled_name (struct general_symbol_info *gsymbol,
       || gsymbol->language == language_objcplus
       || gsymbol->language == language_auto)
     {
-      demangled =
-        cplus_demangle (mangled, DMGL_PARAMS | DMGL_ANSI);
+      /* APPLE LOCAL demangle cache */
+      cached = cached_cplus_demangle (mangled, objfile, to_free);
 
       /* APPLE LOCAL: N.B. We are forcing the language to
 	 C++ even for ObjC++ here.  This is so we will know
 	 how to treat the function when we land in it without
 	 having to try the demangling again every time.  */
-      if (demangled != NULL)
+      if (cached != NULL)
 	{
 	  gsymbol->language = language_cplus;
-	  return demangled;
+	  return cached;
 	}
     }
   if (gsymbol->language == language_java)
@@ -841,6 +1032,8 @@ symbol_find_demangled_name (struct general_symbol_info *gsymbol,
       if (demangled != NULL)
 	{
 	  gsymbol->language = language_java;
+	  /* APPLE LOCAL demangle cache */
+	  *to_free = demangled;
 	  return demangled;
 	}
     }
@@ -929,8 +1122,12 @@ symbol_set_names (struct general_symbol_info *gsymbol,
   /* If this name is not in the hash table, add it.  */
   if (*slot == NULL)
     {
-      char *demangled_name = symbol_find_demangled_name (gsymbol,
-							 linkage_name_copy);
+      /* APPLE LOCAL begin demangle cache */
+      char *to_free;
+      const char *demangled_name
+	= symbol_find_demangled_name (gsymbol, linkage_name_copy, objfile,
+				      &to_free);
+      /* APPLE LOCAL end demangle cache */
       int demangled_len = demangled_name ? strlen (demangled_name) : 0;
 
       /* If there is a demangled name, place it right after the mangled name.
@@ -942,7 +1139,8 @@ symbol_set_names (struct general_symbol_info *gsymbol,
       if (demangled_name != NULL)
 	{
 	  memcpy (*slot + lookup_len + 1, demangled_name, demangled_len + 1);
-	  xfree (demangled_name);
+	  /* APPLE LOCAL demangle cache */
+	  xfree (to_free);
 	}
       else
 	(*slot)[lookup_len + 1] = '\0';
@@ -951,7 +1149,13 @@ symbol_set_names (struct general_symbol_info *gsymbol,
     {
       /* APPLE LOCAL: We already have this name in the demangled name hash
          but we still need to set the language in the minsym.  */
-      xfree (symbol_find_demangled_name (gsymbol, linkage_name_copy));
+      /* APPLE LOCAL begin demangle cache */
+      char *to_free;
+
+      symbol_find_demangled_name (gsymbol, linkage_name_copy, objfile,
+				  &to_free);
+      xfree (to_free);
+      /* APPLE LOCAL end demangle cache */
     }
 
   gsymbol->name = *slot + lookup_len - len;
@@ -972,9 +1176,14 @@ symbol_init_demangled_name (struct general_symbol_info *gsymbol,
                             struct obstack *obstack)
 {
   char *mangled = gsymbol->name;
-  char *demangled = NULL;
-
-  demangled = symbol_find_demangled_name (gsymbol, mangled);
+  /* APPLE LOCAL begin demangle cache */
+  const char *demangled = NULL;
+  char *to_free;
+
+  /* There is no objfile to charge a cache entry to, so this
+     demangles afresh.  */
+  demangled = symbol_find_demangled_name (gsymbol, mangled, NULL, &to_free);
+  /* APPLE LOCAL end demangle cache */
   if (gsymbol->language == language_cplus
       || gsymbol->language == language_java
       /* APPLE LOCAL Objective-C++ */
@@ -982,20 +1191,13 @@ symbol_init_demangled_name (struct general_symbol_info *gsymbol,
       || gsymbol->language == language_objcplus)
     {
       if (demangled)
-	{
-	  gsymbol->language_specific.cplus_specific.demangled_name
-	    = obsavestring (demangled, strlen (demangled), obstack);
-	  xfree (demangled);
-	}
+	gsymbol->language_specific.cplus_specific.demangled_name
+	  = obsavestring (demangled, strlen (demangled), obstack);
       else
 	gsymbol->language_specific.cplus_specific.demangled_name = NULL;
     }
-  else
-    {
-      /* Unknown language; just clean up quietly.  */
-      if (demangled)
-	xfree (demangled);
-    }
+  /* APPLE LOCAL demangle cache */
+  xfree (to_free);
 }
 
 /* Return the source code name of a symbol.  In languages where
@@ -2589,14 +2791,106 @@ lookup_transparent_type (const char *name)
   return current_language->la_lookup_transparent_type (name);
 }
 
-/* The standard implementation of lookup_transparent_type.  This code
-   was modeled on lookup_symbol -- the parts not relevant to looking
+/* APPLE LOCAL begin transparent type cache */
+/* check_typedef looks up the full type of an opaque struct each time
+   it meets one, and printing a big structure meets a great many.  So
+   remember what basic_lookup_transparent_type found for each name,
+   including that it found nothing, until symbols are added to or
+   taken away from some objfile.  */
+
+struct transparent_type_entry
+{
+  char *name;
+  /* NULL if there is no transparent type with this name.  */
+  struct type *type;
+};
+
+static htab_t transparent_type_cache;
+
+/* The value of objfile_generation when transparent_type_cache was
+   last emptied.  */
+static unsigned int transparent_type_cache_generation;
+
+static hashval_t
+hash_transparent_type_entry (const void *p)
+{
+  const struct transparent_type_entry *e = p;
+
+  return htab_hash_string (e->name);
+}
+
+static int
+eq_transparent_type_entry (const void *a, const void *b)
+{
+  const struct transparent_type_entry *ea = a;
+  const struct transparent_type_entry *eb = b;
+
+  return strcmp (ea->name, eb->name) == 0;
+}
+
+static void
+free_transparent_type_entry (void *p)
+{
+  struct transparent_type_entry *e = p;
+
+  xfree (e->name);
+  xfree (e);
+}
+
+static struct type *basic_lookup_transparent_type_1 (const char *name);
+
+struct type *
+basic_lookup_transparent_type (const char *name)
+{
+  struct transparent_type_entry key, *e;
+  struct type *type;
+  unsigned int generation;
+  void **slot;
+
+  /* A restricted search may find what an unrestricted one wouldn't,
+     or the other way around.  */
+  if (objfile_search_restricted ())
+    return basic_lookup_transparent_type_1 (name);
+
+  if (transparent_type_cache == NULL)
+    transparent_type_cache
+      = htab_create_alloc (256, hash_transparent_type_entry,
+			   eq_transparent_type_entry,
+			   free_transparent_type_entry, xcalloc, xfree);
+  else if (transparent_type_cache_generation != objfile_generation)
+    htab_empty (transparent_type_cache);
+  transparent_type_cache_generation = objfile_generation;
+
+  key.name = (char *) name;
+  e = htab_find (transparent_type_cache, &key);
+  if (e != NULL)
+    return e->type;
+
+  /* The lookup may read in symtabs, or even whole objfiles; only
+     remember the answer if it didn't change what there is to find.  */
+  generation = objfile_generation;
+  type = basic_lookup_transparent_type_1 (name);
+  if (generation != objfile_generation)
+    return type;
+
+  slot = htab_find_slot (transparent_type_cache, &key, INSERT);
+  e = xmalloc (sizeof (struct transparent_type_entry));
+  e->name = xstrdup (name);
+  e->type = type;
+  *slot = e;
+  return type;
+}
+/* APPLE LOCAL end transparent type cache */
+
+/* The standard implementation of lookup_transparent_type,
+   without the cache.  This
+   code was modeled on lookup_symbol -- the parts not relevant to looking
    up types were just left out.  In particular it's assumed here that
    types are available in struct_domain and only at file-static or
    global blocks.  */
 
-struct type *
-basic_lookup_transparent_type (const char *name)
+static struct type *
+basic_lookup_transparent_type_1 (const char *name)
 {
   struct symbol *sym;
   struct symtab *s = NULL;
@@ -2849,6 +3143,9 @@ lookup_block_symbol (const struct block *block, const char *name,
 
       struct symbol *sym_found = NULL;
 
+      /* APPLE LOCAL lazy function bodies  */
+      block_expand_lazy ((struct block *) block);
+
       for (sym = dict_iter_name_first (BLOCK_DICT (block), name, &iter);
 	   sym != NULL;
 	   sym = dict_iter_name_next (name, &iter))
@@ -4423,6 +4720,184 @@ sort_search_symbols (struct symbol_search *prevtail, int nfound)
   return symp;
 }
 
+/* APPLE LOCAL begin search regexp */
+/* A regular expression that search_symbols matches names against.
+   It has its own pattern buffer rather than using re_comp's, since
+   reading symbols in the middle of a search may compile other
+   expressions.  And most expressions people search for have a run of
+   plain characters that every matching name has to contain, like
+   "Foo" in "^Foo.*Bar"; looking for that first rules out most names
+   without running the matcher at all.  */
+
+struct search_regexp
+{
+  struct re_pattern_buffer pattern;
+
+  /* A string every matching name contains, or NULL.  */
+  char *literal;
+  int literal_len;
+
+  /* Non-zero if every matching name starts with LITERAL.  */
+  int anchored;
+
+  /* Non-zero if containing LITERAL (or starting with it, if
+     ANCHORED) is all it takes to match.  */
+  int literal_only;
+};
+
+/* Return non-zero if C can be part of a literal run of a regexp in
+   any of the syntaxes re_syntax_options may select.  */
+
+static int
+search_regexp_literal_char_p (int c)
+{
+  return isalnum ((unsigned char) c) || c == '_';
+}
+
+/* Find the longest run of plain characters in REGEXP that any string
+   it matches has to contain, and save it in RE.  Leave RE->literal
+   NULL if there is no such run, or if REGEXP may have alternatives,
+   since a run is then only needed by one of them.  */
+
+static void
+search_regexp_find_literal (struct search_regexp *re, const char *regexp)
+{
+  const char *p = regexp;
+  const char *best = NULL;
+  int best_len = 0;
+  int depth = 0;
+  int len;
+
+  if (strchr (regexp, '|') != NULL || strchr (regexp, '\n') != NULL)
+    return;
+
+  while (*p != '\0')
+    {
+      if (depth == 0 && search_regexp_literal_char_p (*p))
+	{
+	  const char *start = p;
+
+	  while (search_regexp_literal_char_p (*p))
+	    p++;
+	  len = p - start;
+
+	  /* The last character of a run may be repeated zero times.  */
+	  if (*p == '*' || *p == '?' || *p == '+' || *p == '{' || *p == '\\')
+	    len--;
+	  if (len > best_len)
+	    {
+	      best = start;
+	      best_len = len;
+	    }
+	  continue;
+	}
+
+      /* Anything in a group may be optional; whether a parenthesis
+	 starts a group or is a plain character depends on the syntax,
+	 so take it as a group either way.  */
+      if (*p == '\\')
+	{
+	  p++;
+	  if (*p == '\0')
+	    break;
+	}
+      if (*p == '(')
+	depth++;
+      else if (*p == ')' && depth > 0)
+	depth--;
+      else if (*p == '[')
+	{
+	  /* Skip a bracket expression; a `]' right after the opening
+	     `[' or `[^' is part of it.  */
+	  p++;
+	  if (*p == '^')
+	    p++;
+	  if (*p == ']')
+	    p++;
+	  while (*p != '\0' && *p != ']')
+	    p++;
+	  if (*p == '\0')
+	    break;
+	}
+      else if (*p == '{')
+	{
+	  /* Skip an interval such as `\{2,5\}'; its digits are a repeat
+	     count, not characters to match.  Whether an interval is
+	     written with or without backslashes depends on the syntax,
+	     so take a brace as an interval either way.  */
+	  while (*p != '\0' && *p != '}')
+	    p++;
+	  if (*p == '\0')
+	    break;
+	}
+      p++;
+    }
+
+  if (best == NULL)
+    return;
+
+  re->literal = savestring (best, best_len);
+  re->literal_len = best_len;
+  re->anchored = (best == regexp + 1 && regexp[0] == '^');
+  re->literal_only = (best[best_len] == '\0'
+		      && (best == regexp || re->anchored));
+}
+
+/* Compile REGEXP into RE, or report an error.  */
+
+static void
+search_regexp_compile (struct search_regexp *re, const char *regexp)
+{
+  const char *val;
+
+  memset (re, 0, sizeof (*re));
+  re->pattern.fastmap = xmalloc (256);
+  val = re_compile_pattern (regexp, strlen (regexp), &re->pattern);
+  if (val != NULL)
+    {
+      regfree (&re->pattern);
+      error (_("Invalid regexp (%s): %s"), val, regexp);
+    }
+
+  search_regexp_find_literal (re, regexp);
+}
+
+static void
+search_regexp_free (void *arg)
+{
+  struct search_regexp *re = (struct search_regexp *) arg;
+
+  regfree (&re->pattern);
+  if (re->literal != NULL)
+    xfree (re->literal);
+}
+
+/* Return non-zero if NAME matches RE.  */
+
+static int
+search_regexp_matches (struct search_regexp *re, const char *name)
+{
+  int len;
+
+  if (re->literal != NULL)
+    {
+      if (re->anchored)
+	{
+	  if (strncmp (name, re->literal, re->literal_len) != 0)
+	    return 0;
+	}
+      else if (strstr (name, re->literal) == NULL)
+	return 0;
+
+      if (re->literal_only)
+	return 1;
+    }
+
+  len = strlen (name);
+  return re_search (&re->pattern, name, len, 0, len, NULL) >= 0;
+}
+/* APPLE LOCAL end search regexp */
+
 /* Search the symbol table for matches to the regular expression REGEXP,
    returning the results in *MATCHES.
 
@@ -4453,7 +4928,6 @@ search_symbols (char *regexp, domain_enum kind, int nfiles, char *files[],
   struct partial_symbol **psym;
   struct objfile *objfile;
   struct minimal_symbol *msymbol;
-  char *val;
   int found_misc = 0;
   static enum minimal_symbol_type types[]
   =
@@ -4475,6 +4949,10 @@ search_symbols (char *regexp, domain_enum kind, int nfiles, char *files[],
   struct symbol_search *psr;
   struct symbol_search *tail;
   struct cleanup *old_chain = NULL;
+  /* APPLE LOCAL begin search regexp */
+  struct search_regexp re;
+  struct cleanup *re_chain;
+  /* APPLE LOCAL end search regexp */
 
   if (kind < VARIABLES_DOMAIN)
     error (_("must search on specific domain"));
@@ -4519,9 +4997,13 @@ search_symbols (char *regexp, domain_enum kind, int nfiles, char *files[],
 	    }
 	}
 
-      if (0 != (val = re_comp (regexp)))
-	error (_("Invalid regexp (%s): %s"), val, regexp);
+      /* APPLE LOCAL begin search regexp */
+      search_regexp_compile (&re, regexp);
+      re_chain = make_cleanup (search_regexp_free, &re);
     }
+  else
+    re_chain = make_cleanup (null_cleanup, NULL);
+  /* APPLE LOCAL end search regexp */
 
   /* Search through the partial symtabs *first* for all symbols
      matching the regexp.  That way we don't have to reproduce all of
@@ -4563,7 +5045,7 @@ search_symbols (char *regexp, domain_enum kind, int nfiles, char *files[],
 	       load the file and go on to the next one */
 	    if (file_matches (ps->filename, files, nfiles)
 		&& ((regexp == NULL
-		     || re_exec (SYMBOL_NATURAL_NAME (*psym)) != 0)
+		     || search_regexp_matches (&re, SYMBOL_NATURAL_NAME (*psym)))
 		    && ((kind == VARIABLES_DOMAIN && SYMBOL_CLASS (*psym) != LOC_TYPEDEF
 			 && SYMBOL_CLASS (*psym) != LOC_BLOCK)
 			|| (kind == FUNCTIONS_DOMAIN && SYMBOL_CLASS (*psym) == LOC_BLOCK)
@@ -4600,7 +5082,7 @@ search_symbols (char *regexp, domain_enum kind, int nfiles, char *files[],
 	          MSYMBOL_TYPE (msymbol) == ourtype4)
 	        {
 	          if (regexp == NULL
-                       || re_exec (SYMBOL_NATURAL_NAME (msymbol)) != 0)
+                       || search_regexp_matches (&re, SYMBOL_NATURAL_NAME (msymbol)))
                     {
                       objfile_set_load_state (objfile, OBJF_SYM_ALL, 1);
                       /* On to the next objfile.  */
@@ -4646,7 +5128,7 @@ search_symbols (char *regexp, domain_enum kind, int nfiles, char *files[],
               continue;
 
 	    if (regexp == NULL
-		|| re_exec (SYMBOL_NATURAL_NAME (msymbol)) != 0)
+		|| search_regexp_matches (&re, SYMBOL_NATURAL_NAME (msymbol)))
 	      {
 		if (0 == find_pc_symtab (SYMBOL_VALUE_ADDRESS (msymbol)))
 		  {
@@ -4700,7 +5182,7 @@ search_symbols (char *regexp, domain_enum kind, int nfiles, char *files[],
 
 	      if (file_matches (s->filename, files, nfiles)
 		  && ((regexp == NULL
-		       || re_exec (SYMBOL_NATURAL_NAME (sym)) != 0)
+		       || search_regexp_matches (&re, SYMBOL_NATURAL_NAME (sym)))
 		      && ((kind == VARIABLES_DOMAIN && SYMBOL_CLASS (sym) != LOC_TYPEDEF
 			   && SYMBOL_CLASS (sym) != LOC_BLOCK
 			   && SYMBOL_CLASS (sym) != LOC_CONST)
@@ -4761,7 +5243,7 @@ search_symbols (char *regexp, domain_enum kind, int nfiles, char *files[],
 	    MSYMBOL_TYPE (msymbol) == ourtype4)
 	  {
 	    if (regexp == NULL
-		|| re_exec (SYMBOL_NATURAL_NAME (msymbol)) != 0)
+		|| search_regexp_matches (&re, SYMBOL_NATURAL_NAME (msymbol)))
 	      {
 		/* Functions:  Look up by address. */
 		if (kind != FUNCTIONS_DOMAIN ||
@@ -4800,6 +5282,8 @@ search_symbols (char *regexp, domain_enum kind, int nfiles, char *files[],
   *matches = sr;
   if (sr != NULL)
     discard_cleanups (old_chain);
+  /* APPLE LOCAL search regexp */
+  do_cleanups (re_chain);
 }
 
 /* Helper function for symtab_symbol_info, this function uses
@@ -5075,6 +5559,197 @@ static char **return_val;
       completion_list_add_name \
 	(SYMBOL_NATURAL_NAME (symbol), (sym_text), (len), (text), (word))
 
+/* APPLE LOCAL begin completion name index */
+/* The most names a completion list may hold; UINT_MAX means no
+   limit.  */
+static unsigned int max_completions = UINT_MAX;
+
+/* Non-zero once the completion list holds max_completions names.  */
+#define COMPLETION_LIST_FULL() \
+  ((unsigned int) return_val_index >= max_completions)
+
+/* Non-zero once a name has been left out of the completion list
+   because it was full; there is no point looking for more.  */
+static int return_val_truncated;
+
+/* The names of the minimal, partial and full symbols of an objfile,
+   sorted and without duplicates, so that completion can find the
+   ones with a given prefix by binary search instead of looking at
+   them all.  */
+
+struct completion_name_index
+{
+  /* How many minimal, global partial and static partial symbols, and
+     how many symtabs, the objfile had when the index was made.
+     Reading more symbols for the objfile changes these, and the
+     index is made again in the same space.  */
+  int msymbol_count;
+  int global_psymbol_count;
+  int static_psymbol_count;
+  int symtab_count;
+
+  int n_names;
+  int max_names;
+  char **names;
+};
+
+static const struct objfile_data *completion_name_index_key;
+
+static void
+free_completion_name_index (struct objfile *objfile, void *arg)
+{
+  struct completion_name_index *index = arg;
+
+  xfree (index->names);
+  xfree (index);
+}
+
+static int
+compare_completion_names (const void *a, const void *b)
+{
+  return strcmp (*(char **) a, *(char **) b);
+}
+
+/* Add the names of the symbols of block B to INDEX, making room for
+   them as need be.  */
+
+static void
+completion_name_index_add_block (struct completion_name_index *index,
+				 struct block *b)
+{
+  struct dict_iterator iter;
+  struct symbol *sym;
+
+  ALL_BLOCK_SYMBOLS (b, iter, sym)
+    {
+      if (index->n_names == index->max_names)
+	{
+	  index->max_names = index->max_names * 2 + 64;
+	  index->names = xrealloc (index->names,
+				   index->max_names * sizeof (char *));
+	}
+      index->names[index->n_names++] = SYMBOL_NATURAL_NAME (sym);
+    }
+}
+
+/* Return the completion name index of OBJFILE, making it if need be.
+   The names of a full symtab are only looked at once, when the index
+   is made after the symtab has been read in.  */
+
+static struct completion_name_index *
+get_completion_name_index (struct objfile *objfile)
+{
+  struct completion_name_index *index;
+  struct minimal_symbol *msymbol;
+  struct partial_symbol **psym;
+  struct symtab *s;
+  int global_count, static_count, symtab_count;
+  int n, i;
+
+  index = objfile_data (objfile, completion_name_index_key);
+  global_count = objfile->global_psymbols.next - objfile->global_psymbols.list;
+  static_count = objfile->static_psymbols.next - objfile->static_psymbols.list;
+  symtab_count = 0;
+  ALL_OBJFILE_SYMTABS (objfile, s)
+    symtab_count++;
+  if (index != NULL
+      && index->msymbol_count == objfile->minimal_symbol_count
+      && index->global_psymbol_count == global_count
+      && index->static_psymbol_count == static_count
+      && index->symtab_count == symtab_count)
+    return index;
+
+  n = objfile->minimal_symbol_count + global_count + static_count;
+  if (index == NULL)
+    {
+      index = XMALLOC (struct completion_name_index);
+      index->max_names = 0;
+      index->names = NULL;
+      set_objfile_data (objfile, completion_name_index_key, index);
+    }
+  if (n > index->max_names)
+    {
+      index->max_names = n;
+      index->names = xrealloc (index->names, n * sizeof (char *));
+    }
+  index->msymbol_count = objfile->minimal_symbol_count;
+  index->global_psymbol_count = global_count;
+  index->static_psymbol_count = static_count;
+  index->symtab_count = symtab_count;
+
+  index->n_names = 0;
+  ALL_OBJFILE_MSYMBOLS (objfile, msymbol)
+    index->names[index->n_names++] = SYMBOL_NATURAL_NAME (msymbol);
+  for (psym = objfile->global_psymbols.list;
+       psym < objfile->global_psymbols.next;
+       psym++)
+    index->names[index->n_names++] = SYMBOL_NATURAL_NAME (*psym);
+  for (psym = objfile->static_psymbols.list;
+       psym < objfile->static_psymbols.next;
+       psym++)
+    index->names[index->n_names++] = SYMBOL_NATURAL_NAME (*psym);
+  /* Symtabs that are not primary share the blockvector of one that
+     is.  */
+  ALL_OBJFILE_SYMTABS (objfile, s)
+    if (s->primary)
+      {
+	struct blockvector *bv = BLOCKVECTOR (s);
+
+	completion_name_index_add_block (index,
+					 BLOCKVECTOR_BLOCK (bv, GLOBAL_BLOCK));
+	completion_name_index_add_block (index,
+					 BLOCKVECTOR_BLOCK (bv, STATIC_BLOCK));
+      }
+  n = index->n_names;
+
+  qsort (index->names, n, sizeof (char *), compare_completion_names);
+
+  /* Drop the duplicates.  */
+  if (n > 0)
+    {
+      int j = 0;
+
+      for (i = 1; i < n; i++)
+	if (strcmp (index->names[i], index->names[j]) != 0)
+	  index->names[++j] = index->names[i];
+      n = j + 1;
+    }
+  index->n_names = n;
+
+  return index;
+}
+
+static void
+show_max_completions (struct ui_file *file, int from_tty,
+		      struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("\
+The maximum number of symbol names offered for completion is %s.\n"),
+		    value);
+}
+
+/* Return the position in INDEX of the first name that is not less
+   than PREFIX; the names starting with PREFIX, if any, follow it.  */
+
+static int
+completion_name_index_lower_bound (struct completion_name_index *index,
+				   const char *prefix)
+{
+  int lo = 0, hi = index->n_names;
+
+  while (lo < hi)
+    {
+      int mid = lo + (hi - lo) / 2;
+
+      if (strcmp (index->names[mid], prefix) < 0)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  return lo;
+}
+/* APPLE LOCAL end completion name index */
+
 /*  Test to see if the symbol specified by SYMNAME (which is already
    demangled for C++ symbols) matches SYM_TEXT in the first SYM_TEXT_LEN
    characters.  If so, add it to the current completion list. */
@@ -5092,6 +5767,15 @@ completion_list_add_name (char *symname, char *sym_text, int sym_text_len,
       return;
     }
 
+  /* APPLE LOCAL begin completion name index */
+  if (COMPLETION_LIST_FULL ())
+    {
+      return_val_truncated = 1;
+      max_completions_reached = 1;
+      return;
+    }
+  /* APPLE LOCAL end completion name index */
+
   /* We have a match for a completion, so add SYMNAME to the current list
      of matches. Note that the name is moved to freshly malloc'd space. */
 
@@ -5130,17 +5814,18 @@ completion_list_add_name (char *symname, char *sym_text, int sym_text_len,
 /* ObjC: In case we are completing on a selector, look as the msymbol
    again and feed all the selectors into the mill.  */
 
+/* APPLE LOCAL completion name index: Take the name of the symbol
+   rather than the msymbol, since we find it in the name index.  */
+
 static void
-completion_list_objc_symbol (struct minimal_symbol *msymbol, char *sym_text,
+completion_list_objc_symbol (char *method, char *sym_text,
 			     int sym_text_len, char *text, char *word)
 {
   static char *tmp = NULL;
   static unsigned int tmplen = 0;
     
-  char *method, *category, *selector;
+  char *category, *selector;
   char *tmp2 = NULL;
-    
-  method = SYMBOL_NATURAL_NAME (msymbol);
 
   /* Is it a method?  */
   if ((method[0] != '-') && (method[0] != '+'))
@@ -5244,14 +5929,10 @@ char **
 make_symbol_completion_list (char *text, char *word)
 {
   struct symbol *sym;
-  struct symtab *s;
-  struct partial_symtab *ps;
-  struct minimal_symbol *msymbol;
   struct objfile *objfile;
-  struct block *b, *surrounding_static_block = 0;
+  struct block *b;
   struct dict_iterator iter;
   int j;
-  struct partial_symbol **psym;
   /* The symbol we are completing on.  Points in same buffer as text.  */
   char *sym_text;
   /* Length of sym_text.  */
@@ -5312,6 +5993,8 @@ make_symbol_completion_list (char *text, char *word)
 
   return_val_size = 100;
   return_val_index = 0;
+  /* APPLE LOCAL completion name index */
+  return_val_truncated = 0;
   return_val = (char **) xmalloc ((return_val_size + 1) * sizeof (char *));
   return_val[0] = NULL;
 
@@ -5320,62 +6003,60 @@ make_symbol_completion_list (char *text, char *word)
 
   sym_text_len = strlen (sym_text);
 
-  ALL_PSYMTABS (objfile, ps)
+  /* APPLE LOCAL begin completion name index */
+  /* Look up SYM_TEXT in the sorted names of the minimal, partial and
+     full symbols of each objfile; these cover the global and static
+     blocks of every symtab, so those need not be walked here.  The
+     duplicates between them are weeded out when the index is
+     made.  */
+
+  ALL_OBJFILES (objfile)
   {
-    /* If the psymtab's been read in we'll get it when we search
-       through the blockvector.  */
-    if (ps->readin)
-      continue;
+    struct completion_name_index *index;
+    int i;
 
-    for (psym = objfile->global_psymbols.list + ps->globals_offset;
-	 psym < (objfile->global_psymbols.list + ps->globals_offset
-		 + ps->n_global_syms);
-	 psym++)
-      {
-	/* If interrupted, then quit. */
-	QUIT;
-	COMPLETION_LIST_ADD_SYMBOL (*psym, sym_text, sym_text_len, text, word);
-      }
+    QUIT;
+    if (return_val_truncated)
+      break;
 
-    for (psym = objfile->static_psymbols.list + ps->statics_offset;
-	 psym < (objfile->static_psymbols.list + ps->statics_offset
-		 + ps->n_static_syms);
-	 psym++)
+    index = get_completion_name_index (objfile);
+    for (i = completion_name_index_lower_bound (index, sym_text);
+	 i < index->n_names && !return_val_truncated
+	   && strncmp (index->names[i], sym_text, sym_text_len) == 0;
+	 i++)
+      completion_list_add_name (index->names[i], sym_text, sym_text_len,
+				text, word);
+
+    /* ObjC: Methods are named "-[Class selector]" or "+[...]", and
+       can be completed on by their selectors too.  */
+    for (j = 0; j < 2; j++)
       {
-	QUIT;
-	COMPLETION_LIST_ADD_SYMBOL (*psym, sym_text, sym_text_len, text, word);
+	const char *kind = j == 0 ? "+" : "-";
+
+	for (i = completion_name_index_lower_bound (index, kind);
+	     i < index->n_names && !return_val_truncated
+	       && index->names[i][0] == kind[0];
+	     i++)
+	  completion_list_objc_symbol (index->names[i], sym_text,
+				       sym_text_len, text, word);
       }
   }
-
-  /* At this point scan through the misc symbol vectors and add each
-     symbol you find to the list.  Eventually we want to ignore
-     anything that isn't a text symbol (everything else will be
-     handled by the psymtab code above).  */
-
-  ALL_MSYMBOLS (objfile, msymbol)
-  {
-    QUIT;
-    COMPLETION_LIST_ADD_SYMBOL (msymbol, sym_text, sym_text_len, text, word);
-
-    completion_list_objc_symbol (msymbol, sym_text, sym_text_len, text, word);
-  }
+  /* APPLE LOCAL end completion name index */
 
   /* Search upwards from currently selected frame (so that we can
      complete on local vars.  */
 
   for (b = get_selected_block (0); b != NULL; b = BLOCK_SUPERBLOCK (b))
     {
-      if (!BLOCK_SUPERBLOCK (b))
-	{
-	  surrounding_static_block = b;		/* For elmin of dups */
-	}
-
       /* Also catch fields of types defined in this places which match our
          text string.  Only complete on types visible from current context. */
 
       ALL_BLOCK_SYMBOLS (b, iter, sym)
 	{
 	  QUIT;
+	  /* APPLE LOCAL completion name index */
+	  if (return_val_truncated)
+	    break;
 	  COMPLETION_LIST_ADD_SYMBOL (sym, sym_text, sym_text_len, text, word);
 	  if (SYMBOL_CLASS (sym) == LOC_TYPEDEF)
 	    {
@@ -5397,32 +6078,6 @@ make_symbol_completion_list (char *text, char *word)
 	}
     }
 
-  /* Go through the symtabs and check the externs and statics for
-     symbols which match.  */
-
-  ALL_SYMTABS (objfile, s)
-  {
-    QUIT;
-    b = BLOCKVECTOR_BLOCK (BLOCKVECTOR (s), GLOBAL_BLOCK);
-    ALL_BLOCK_SYMBOLS (b, iter, sym)
-      {
-	COMPLETION_LIST_ADD_SYMBOL (sym, sym_text, sym_text_len, text, word);
-      }
-  }
-
-  ALL_SYMTABS (objfile, s)
-  {
-    QUIT;
-    b = BLOCKVECTOR_BLOCK (BLOCKVECTOR (s), STATIC_BLOCK);
-    /* Don't do this block twice.  */
-    if (b == surrounding_static_block)
-      continue;
-    ALL_BLOCK_SYMBOLS (b, iter, sym)
-      {
-	COMPLETION_LIST_ADD_SYMBOL (sym, sym_text, sym_text_len, text, word);
-      }
-  }
-
   return (return_val);
 }
 
@@ -5488,6 +6143,8 @@ make_file_symbol_completion_list (char *text, char *word, char *srcfile)
 
   return_val_size = 10;
   return_val_index = 0;
+  /* APPLE LOCAL completion name index */
+  return_val_truncated = 0;
   return_val = (char **) xmalloc ((return_val_size + 1) * sizeof (char *));
   return_val[0] = NULL;
 
@@ -5970,6 +6627,26 @@ All global and static variable names, or those matching REGEXP."));
 All global and static variable names, or those matching REGEXP."));
     }
 
+  /* APPLE LOCAL demangle cache */
+  cplus_demangle_cache_key
+    = register_objfile_data_with_cleanup (free_cplus_demangle_cache_usage);
+
+  /* APPLE LOCAL begin completion name index */
+  completion_name_index_key
+    = register_objfile_data_with_cleanup (free_completion_name_index);
+
+  add_setshow_uinteger_cmd ("max-completions", no_class,
+			    &max_completions, _("\
+Set the maximum number of symbol names to offer for completion."), _("\
+Show the maximum number of symbol names to offer for completion."), _("\
+Completing a symbol name stops collecting candidates once it has\n\
+this many, and says that the list may be truncated.  A value of zero\n\
+means no limit."),
+			    NULL,
+			    show_max_completions,
+			    &setlist, &showlist);
+  /* APPLE LOCAL end completion name index */
+
   /* Initialize the one built-in type that isn't language dependent... */
   builtin_type_error = init_type (TYPE_CODE_ERROR, 0, 0,
 				  "<unknown type>", (struct objfile *) NULL);
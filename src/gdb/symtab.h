@@ -196,6 +196,10 @@ extern void symbol_init_language_specific (struct general_symbol_info *symbol,
 extern void symbol_init_demangled_name (struct general_symbol_info *symbol,
 					struct obstack *obstack);
 
+/* APPLE LOCAL demangle cache: Return the number of bytes of demangled
+   names an objfile keeps in the demangler's cache.  */
+extern unsigned long demangle_cache_memory_used (struct objfile *);
+
 #define SYMBOL_SET_NAMES(symbol,linkage_name,len,objfile) \
   symbol_set_names (&(symbol)->ginfo, linkage_name, len, objfile)
 extern void symbol_set_names (struct general_symbol_info *symbol,
@@ -1322,6 +1326,11 @@ extern int find_pc_line_pc_range (CORE_ADDR, CORE_ADDR *, CORE_ADDR *);
 
 extern void reread_symbols (void);
 
+/* APPLE LOCAL symbol memory limit: Throw away the symbol tables of
+   the least recently used objfiles while the symbols of all objfiles
+   use more memory than "set symbol-memory-limit" allows.  */
+extern void enforce_symbol_memory_limit (void);
+
 extern struct type *lookup_transparent_type (const char *);
 extern struct type *basic_lookup_transparent_type (const char *);
 
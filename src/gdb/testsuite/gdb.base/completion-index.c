@@ -0,0 +1,39 @@
+/* Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+   Please email any bugs, comments, and/or additions to this file to:
+   bug-gdb@prep.ai.mit.edu  */
+
+/* Names for GDB to complete on, from the global and static blocks and
+   from a function's own block.  */
+
+int cidx_alpha = 1;
+int cidx_beta = 2;
+static int cidx_gamma = 3;
+
+int
+cidx_func (int x)
+{
+  return x + cidx_gamma;
+}
+
+int
+main (void)
+{
+  int cidx_local = cidx_alpha + cidx_beta;
+
+  return cidx_func (cidx_local) == 0;
+}
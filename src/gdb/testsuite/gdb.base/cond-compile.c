@@ -0,0 +1,51 @@
+/* Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+   Please email any bugs, comments, and/or additions to this file to:
+   bug-gdb@prep.ai.mit.edu  */
+
+struct point
+{
+  int x;
+  unsigned char y;
+};
+
+struct point points[100];
+int total;
+
+int
+visit (struct point *p, int n)
+{
+  int local = n * 3;
+
+  total += p->x + local;	/* visit breakpoint */
+  return total;
+}
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < 100; i++)
+    {
+      points[i].x = i - 50;
+      points[i].y = i * 7;
+    }
+  for (i = 0; i < 100; i++)
+    visit (&points[i], i);
+  return 0;
+}
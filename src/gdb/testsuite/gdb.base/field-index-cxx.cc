@@ -0,0 +1,70 @@
+/* Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+   Please email any bugs, comments, and/or additions to this file to:
+   bug-gdb@prep.ai.mit.edu  */
+
+/* Classes with enough fields that GDB looks their members up through
+   a hash index of the field names, with the members of the base
+   classes found by searching them in turn.  */
+
+class Base
+{
+public:
+  int b00, b01, b02, b03, b04, b05, b06, b07, b08, b09;
+  int b10, b11, b12, b13, b14, b15, b16, b17;
+  int shadowed;
+};
+
+class Other
+{
+public:
+  int o00;
+};
+
+class Derived : public Base, public Other
+{
+public:
+  int d00, d01, d02, d03, d04, d05, d06, d07, d08, d09;
+  int d10, d11, d12, d13, d14, d15, d16, d17;
+  int shadowed;
+};
+
+class Virtual
+{
+public:
+  virtual ~Virtual () {}
+  int v00, v01, v02, v03, v04, v05, v06, v07, v08, v09;
+  int v10, v11, v12, v13, v14, v15, v16, v17;
+};
+
+Derived d;
+Virtual v;
+
+int
+main (void)
+{
+  d.b03 = 403;
+  d.b17 = 417;
+  d.Base::shadowed = 418;
+  d.o00 = 430;
+  d.d00 = 500;
+  d.d17 = 517;
+  d.shadowed = 518;
+  v.v00 = 600;
+  v.v17 = 617;
+  return 0;  /* set breakpoint here */
+}
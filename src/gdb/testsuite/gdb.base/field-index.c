@@ -0,0 +1,69 @@
+/* Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+   Please email any bugs, comments, and/or additions to this file to:
+   bug-gdb@prep.ai.mit.edu  */
+
+/* Structs with enough fields that GDB looks their members up through
+   a hash index of the field names.  */
+
+struct wide
+{
+  int f00, f01, f02, f03, f04, f05, f06, f07, f08, f09;
+  int f10, f11, f12, f13, f14, f15, f16, f17, f18, f19;
+};
+
+typedef struct wide wide_t;
+
+struct wide_anon
+{
+  int a00, a01, a02, a03, a04, a05, a06, a07, a08, a09;
+  int a10, a11, a12, a13, a14, a15, a16, a17;
+  union
+  {
+    int u_int;
+    char u_char;
+  };
+  struct
+  {
+    int s_first;
+    int s_second;
+  };
+  int last;
+};
+
+struct wide w;
+wide_t tw;
+struct wide *wp = &w;
+struct wide_anon wa;
+
+int
+main (void)
+{
+  w.f00 = 100;
+  w.f07 = 107;
+  w.f15 = 115;
+  w.f16 = 116;
+  w.f19 = 119;
+  tw.f03 = 203;
+  tw.f18 = 218;
+  wa.a00 = 300;
+  wa.a17 = 317;
+  wa.u_int = 320;
+  wa.s_second = 322;
+  wa.last = 323;
+  return 0;  /* set breakpoint here */
+}
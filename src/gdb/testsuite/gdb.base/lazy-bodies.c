@@ -0,0 +1,44 @@
+/* Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+   Please email any bugs, comments, and/or additions to this file to:
+   bug-gdb@prep.ai.mit.edu  */
+
+int
+compute (int count, int scale)
+{
+  int total = 0;
+  int i;
+
+  for (i = 0; i < count; i++)
+    {
+      int step = i * scale;
+
+      total += step;
+      if (i == count - 1)
+	return total;  /* break here */
+    }
+  return total;
+}
+
+int
+main (void)
+{
+  int result;
+
+  result = compute (4, 3);
+  return result == 18 ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+/* Page-protection watchpoint test program.
+   Copyright 2026
+   Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330,
+   Boston, MA 02111-1307, USA.  */
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* BIG is too wide for the debug registers.  Its neighbours share its
+   pages, so the loop's stores to them fault without touching BIG.  */
+
+struct big
+{
+  int words[64];
+};
+
+int before[256];
+struct big big;
+int after[256];
+
+/* Watching the 256 bytes either side of the boundary between SPAN's
+   two pages protects both, and a single unaligned store to STRADDLE
+   writes to both.  */
+
+char span[2 * 4096] __attribute__ ((aligned (4096)));
+
+struct straddle
+{
+  long long value;
+} __attribute__ ((packed));
+
+/* Set if a child forked while BIG was watched could store to it.  */
+
+int child_stored;
+
+void
+marker (void)
+{
+}
+
+int
+main (void)
+{
+  int i, j, status;
+  pid_t pid;
+
+  marker ();
+
+  for (j = 0; j < 10; j++)
+    for (i = 0; i < 256; i++)
+      {
+	before[i] += j;
+	after[i] -= j;
+      }
+
+  big.words[40] = 42;	/* store-big */
+
+  ((struct straddle *) &span[4092])->value = 0x0101010101010101LL;	/* store-span */
+
+  pid = fork ();
+  if (pid == 0)
+    {
+      big.words[1] = 7;
+      _exit (big.words[1] == 7 ? 0 : 1);
+    }
+  waitpid (pid, &status, 0);
+  child_stored = WIFEXITED (status) && WEXITSTATUS (status) == 0;
+
+  big.words[2] = 43;	/* store-after-fork */
+
+  for (i = 0; i < 256; i++)
+    after[i] = 0;
+
+  return 0;	/* done */
+}
@@ -0,0 +1,52 @@
+/* Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+   Please email any bugs, comments, and/or additions to this file to:
+   bug-gdb@prep.ai.mit.edu  */
+
+#include <string.h>
+
+struct entry
+{
+  const char *name;
+  int value;
+  char *note;
+};
+
+static const char beta[] = "beta";
+
+const char *names[] = {
+  "alpha", beta, "gamma", beta, beta, beta, beta, beta,
+  beta, beta, beta, beta, beta, 0, "delta"
+};
+
+struct entry entries[3] = {
+  { "first", 1, 0 },
+  { "second", 2, "a note" },
+  { "third", 3, "another note" }
+};
+
+char long_string[300];
+
+struct entry *entryp = &entries[1];
+char *long_ptr = long_string;
+
+int
+main (void)
+{
+  memset (long_string, 'x', sizeof (long_string) - 1);
+  return 0;  /* print here */
+}
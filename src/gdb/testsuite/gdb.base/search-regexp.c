@@ -0,0 +1,43 @@
+/* Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+   Please email any bugs, comments, and/or additions to this file to:
+   bug-gdb@prep.ai.mit.edu  */
+
+/* Functions for search-regexp.exp to find with "info functions".  */
+
+int xxxxxxxxxx (void) { return 10; }
+int xxxxx (void) { return 5; }
+int alpha_search_one (void) { return 1; }
+int beta_alpha_search (void) { return 2; }
+int gamma_tail (void) { return 3; }
+int gamma_tail_not (void) { return 4; }
+int delta_fn (void) { return 5; }
+int deltA_fn (void) { return 6; }
+int deltb_fn (void) { return 7; }
+int omega_fn (void) { return 8; }
+int pre_omega_fn (void) { return 9; }
+int epsiln_fn (void) { return 10; }
+int epsilon_fn (void) { return 11; }
+
+int
+main (void)
+{
+  return (xxxxxxxxxx () + xxxxx () + alpha_search_one ()
+	  + beta_alpha_search () + gamma_tail () + gamma_tail_not ()
+	  + delta_fn () + deltA_fn () + deltb_fn () + omega_fn ()
+	  + pre_omega_fn () + epsiln_fn () + epsilon_fn ());
+}
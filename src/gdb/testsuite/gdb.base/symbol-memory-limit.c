@@ -0,0 +1,52 @@
+/* Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+   Please email any bugs, comments, and/or additions to this file to:
+   bug-gdb@prep.ai.mit.edu  */
+
+/* Enough struct types, each with enough fields, that the full symbol
+   table of this file takes several megabytes while its partial
+   symbols stay small.  */
+
+#define FIELDS10(p) \
+  int p##0, p##1, p##2, p##3, p##4, p##5, p##6, p##7, p##8, p##9;
+#define FIELDS100(p) \
+  FIELDS10 (p##0) FIELDS10 (p##1) FIELDS10 (p##2) FIELDS10 (p##3) \
+  FIELDS10 (p##4) FIELDS10 (p##5) FIELDS10 (p##6) FIELDS10 (p##7) \
+  FIELDS10 (p##8) FIELDS10 (p##9)
+
+#define STRUCT(n) struct s##n { FIELDS100 (f) } v##n;
+#define STRUCTS10(n) \
+  STRUCT (n##0) STRUCT (n##1) STRUCT (n##2) STRUCT (n##3) STRUCT (n##4) \
+  STRUCT (n##5) STRUCT (n##6) STRUCT (n##7) STRUCT (n##8) STRUCT (n##9)
+#define STRUCTS100(n) \
+  STRUCTS10 (n##0) STRUCTS10 (n##1) STRUCTS10 (n##2) STRUCTS10 (n##3) \
+  STRUCTS10 (n##4) STRUCTS10 (n##5) STRUCTS10 (n##6) STRUCTS10 (n##7) \
+  STRUCTS10 (n##8) STRUCTS10 (n##9)
+
+STRUCTS100 (1)
+STRUCTS100 (2)
+STRUCTS100 (3)
+STRUCTS100 (4)
+STRUCTS100 (5)
+
+int
+main (void)
+{
+  v100.f00 = 1;
+  v500.f99 = 2;
+  return 0;
+}
@@ -0,0 +1,56 @@
+/* Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+   Please email any bugs, comments, and/or additions to this file to:
+   bug-gdb@prep.ai.mit.edu  */
+
+/* Functions with mangled names for GDB to demangle.  */
+
+namespace dc
+{
+  int
+  dcache_add (int a, int b)
+  {
+    return a + b;
+  }
+
+  template <typename T> T
+  dcache_twice (T x)
+  {
+    return x + x;
+  }
+
+  struct dcache_counter
+  {
+    int count;
+
+    void
+    bump ()
+    {
+      count++;
+    }
+  };
+}
+
+int
+main ()
+{
+  dc::dcache_counter counter = { 0 };
+
+  counter.bump ();
+  return dc::dcache_add (dc::dcache_twice (1), dc::dcache_twice (2L))
+	 - 6 + counter.count - 1;
+}
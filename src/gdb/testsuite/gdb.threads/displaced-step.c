@@ -0,0 +1,77 @@
+/* Displaced stepping test program.
+   Copyright 2026
+   Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330,
+   Boston, MA 02111-1307, USA.  */
+
+#include <pthread.h>
+#include <stdio.h>
+
+/* Several threads call work over and over.  The test puts a
+   breakpoint whose condition is never true in work, so every call is
+   a step over a breakpoint; if any of those steps goes wrong the
+   total will be off, or the program will crash.  main calls work once
+   before there are any other threads, for the test to step over the
+   breakpoint by hand.  */
+
+#define NTHREADS 4
+#define ITERATIONS 200
+
+volatile int counter;
+volatile int last_id = -1;
+
+void
+work (int id)
+{
+  __sync_fetch_and_add (&counter, 1);	/* work-body */
+  last_id = id;
+}
+
+void *
+thread_function (void *arg)
+{
+  int id = (int) (long) arg;
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    work (id);
+
+  return NULL;
+}
+
+void
+all_done (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_t threads[NTHREADS];
+  long i;
+
+  work (-5);
+
+  for (i = 0; i < NTHREADS; i++)
+    pthread_create (&threads[i], NULL, thread_function, (void *) i);
+  for (i = 0; i < NTHREADS; i++)
+    pthread_join (threads[i], NULL);
+
+  all_done ();
+  return 0;
+}
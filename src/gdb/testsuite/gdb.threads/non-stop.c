@@ -0,0 +1,64 @@
+/* Non-stop mode test program.
+   Copyright 2026
+   Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330,
+   Boston, MA 02111-1307, USA.  */
+
+#include <pthread.h>
+
+/* One thread spins until told to finish; another stops at a
+   breakpoint.  In non-stop mode the spinner keeps going while the
+   other is stopped.  */
+
+volatile int done;
+volatile unsigned long spins;
+
+void *
+spinner (void *arg)
+{
+  while (!done)
+    spins++;
+  return NULL;
+}
+
+void
+stop_here (void)
+{
+}
+
+void *
+stopper (void *arg)
+{
+  stop_here ();
+  return NULL;
+}
+
+int
+main (void)
+{
+  pthread_t spin_thread, stop_thread;
+
+  pthread_create (&spin_thread, NULL, spinner, NULL);
+  pthread_create (&stop_thread, NULL, stopper, NULL);
+
+  pthread_join (stop_thread, NULL);
+  done = 1;
+  pthread_join (spin_thread, NULL);
+
+  return 0;
+}
@@ -0,0 +1,80 @@
+/* Stop/resume latency benchmark program.
+   Copyright 2026
+   Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+   
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330,
+   Boston, MA 02111-1307, USA.  */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <limits.h>
+
+/* Start ARGV[1] threads that do nothing but sleep, then call tick
+   every few milliseconds, forever.  The test attaches to us and
+   times how long it takes to run from one call of tick to the next,
+   which is dominated by resuming and stopping all the threads.  */
+
+volatile int ticks;
+
+void *
+thread_function (void *arg)
+{
+  while (1)
+    usleep (100000);
+
+  return NULL;
+}
+
+void
+tick (void)
+{
+  ticks++;
+}
+
+int 
+main (int argc, char **argv)
+{
+  pthread_attr_t attr;
+  pthread_t thread;
+  int nthreads = 100;
+  int i;
+
+  if (argc > 1)
+    nthreads = atoi (argv[1]);
+
+  pthread_attr_init (&attr);
+  pthread_attr_setstacksize (&attr, PTHREAD_STACK_MIN);
+
+  for (i = 0; i < nthreads; ++i) 
+    if (pthread_create (&thread, &attr, thread_function, NULL) != 0)
+      {
+	fprintf (stderr, "Could only create %d threads\n", i);
+	break;
+      }
+
+  pthread_attr_destroy (&attr);
+
+  while (1)
+    {
+      tick ();
+      usleep (10000);
+    }
+
+  return 0;
+}
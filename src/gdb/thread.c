@@ -37,6 +37,8 @@
 #include "gdb.h"
 #include "gdb_string.h"
 #include "wrapper.h"
+/* APPLE LOCAL thread hash */
+#include "hashtab.h"
 
 #include <ctype.h>
 #include <sys/types.h>
@@ -72,6 +74,131 @@ static void restore_current_thread (ptid_t, int);
 static void prune_threads (void);
 */
 
+/* APPLE LOCAL begin thread hash */
+/* Besides being on THREAD_LIST, every thread is entered in two hash
+   tables, one keyed by ptid and one by GDB thread number, so that
+   the lookups done for every stop don't walk the whole list.  The
+   list still owns the threads and keeps the order "info threads"
+   prints them in.
+
+   If a ptid is added twice, the newer thread shadows the older one
+   in the ptid table, just as it used to be found first on the list.
+   SHADOWED_THREAD_COUNT counts such threads, so that we only go
+   looking for one to unshadow when there may be one.  */
+
+static htab_t thread_ptid_table;
+static htab_t thread_num_table;
+static int shadowed_thread_count;
+
+static hashval_t
+hash_ptid (ptid_t ptid)
+{
+  return (((hashval_t) ptid_get_pid (ptid) * 31
+	   + (hashval_t) ptid_get_lwp (ptid)) * 31
+	  + (hashval_t) ptid_get_tid (ptid));
+}
+
+static hashval_t
+hash_thread_ptid (const void *p)
+{
+  const struct thread_info *tp = p;
+  return hash_ptid (tp->hashed_ptid);
+}
+
+static int
+eq_thread_ptid (const void *p, const void *key)
+{
+  const struct thread_info *tp = p;
+  return ptid_equal (tp->hashed_ptid, *(const ptid_t *) key);
+}
+
+static hashval_t
+hash_thread_num (const void *p)
+{
+  const struct thread_info *tp = p;
+  return (hashval_t) tp->num;
+}
+
+static int
+eq_thread_num (const void *p, const void *key)
+{
+  const struct thread_info *tp = p;
+  return tp->num == *(const int *) key;
+}
+
+static void
+hash_thread (struct thread_info *tp)
+{
+  void **slot;
+
+  if (thread_ptid_table == NULL)
+    {
+      thread_ptid_table = htab_create_alloc (64, hash_thread_ptid,
+					     eq_thread_ptid, NULL,
+					     xcalloc, xfree);
+      thread_num_table = htab_create_alloc (64, hash_thread_num,
+					    eq_thread_num, NULL,
+					    xcalloc, xfree);
+    }
+
+  tp->hashed_ptid = tp->ptid;
+  slot = htab_find_slot_with_hash (thread_ptid_table, &tp->hashed_ptid,
+				   hash_ptid (tp->hashed_ptid), INSERT);
+  if (*slot != NULL)
+    shadowed_thread_count++;
+  *slot = tp;
+
+  slot = htab_find_slot_with_hash (thread_num_table, &tp->num,
+				   (hashval_t) tp->num, INSERT);
+  *slot = tp;
+}
+
+static void
+unhash_thread (struct thread_info *tp)
+{
+  void **slot;
+
+  if (thread_ptid_table == NULL)
+    return;
+
+  slot = htab_find_slot_with_hash (thread_num_table, &tp->num,
+				   (hashval_t) tp->num, NO_INSERT);
+  if (slot != NULL && *slot == tp)
+    htab_clear_slot (thread_num_table, slot);
+
+  slot = htab_find_slot_with_hash (thread_ptid_table, &tp->hashed_ptid,
+				   hash_ptid (tp->hashed_ptid), NO_INSERT);
+  if (slot == NULL || *slot != tp)
+    {
+      /* TP was shadowed by a newer thread with the same ptid.  */
+      if (slot != NULL && shadowed_thread_count > 0)
+	shadowed_thread_count--;
+      return;
+    }
+  htab_clear_slot (thread_ptid_table, slot);
+
+  /* If TP was shadowing an older thread, that one is visible again.
+     THREAD_LIST is newest first, so the first match is the one the
+     list walk would have found.  */
+  if (shadowed_thread_count > 0)
+    {
+      struct thread_info *older;
+
+      for (older = thread_list; older; older = older->next)
+	if (older != tp && ptid_equal (older->hashed_ptid, tp->hashed_ptid))
+	  {
+	    slot = htab_find_slot_with_hash (thread_ptid_table,
+					     &older->hashed_ptid,
+					     hash_ptid (older->hashed_ptid),
+					     INSERT);
+	    *slot = older;
+	    shadowed_thread_count--;
+	    break;
+	  }
+    }
+}
+/* APPLE LOCAL end thread hash */
+
 void
 delete_step_resume_breakpoint (void *arg)
 {
@@ -111,6 +238,14 @@ init_thread_list (void)
   struct thread_info *tp, *tpnext;
 
   highest_thread_num = 0;
+  /* APPLE LOCAL begin thread hash */
+  if (thread_ptid_table != NULL)
+    {
+      htab_empty (thread_ptid_table);
+      htab_empty (thread_num_table);
+    }
+  shadowed_thread_count = 0;
+  /* APPLE LOCAL end thread hash */
   if (!thread_list)
     return;
 
@@ -137,9 +272,28 @@ add_thread (ptid_t ptid)
   tp->num = ++highest_thread_num; 
   tp->next = thread_list; 
   thread_list = tp; 
+  /* APPLE LOCAL thread hash */
+  hash_thread (tp);
   return tp; 
 }
 
+/* APPLE LOCAL begin thread hash */
+/* Unlink TP, whose predecessor on THREAD_LIST is TPPREV, and free it.  */
+
+static void
+delete_thread_1 (struct thread_info *tp, struct thread_info *tpprev)
+{
+  unhash_thread (tp);
+
+  if (tpprev)
+    tpprev->next = tp->next;
+  else
+    thread_list = tp->next;
+
+  free_thread (tp);
+}
+/* APPLE LOCAL end thread hash */
+
 void
 delete_thread (ptid_t ptid)
 {
@@ -154,24 +308,17 @@ delete_thread (ptid_t ptid)
   if (!tp)
     return;
 
-  if (tpprev)
-    tpprev->next = tp->next;
-  else
-    thread_list = tp->next;
-
-  free_thread (tp);
+  /* APPLE LOCAL thread hash */
+  delete_thread_1 (tp, tpprev);
 }
 
+/* APPLE LOCAL begin thread hash */
 struct thread_info *
 find_thread_id (int num)
 {
-  struct thread_info *tp;
-
-  for (tp = thread_list; tp; tp = tp->next)
-    if (tp->num == num)
-      return tp;
-
-  return NULL;
+  if (thread_num_table == NULL)
+    return NULL;
+  return htab_find_with_hash (thread_num_table, &num, (hashval_t) num);
 }
 
 /* Find a thread_info by matching PTID.  */
@@ -180,12 +327,18 @@ find_thread_pid (ptid_t ptid)
 {
   struct thread_info *tp;
 
-  for (tp = thread_list; tp; tp = tp->next)
-    if (ptid_equal (tp->ptid, ptid))
-      return tp;
+  if (thread_ptid_table == NULL)
+    return NULL;
 
-  return NULL;
+  tp = htab_find_with_hash (thread_ptid_table, &ptid, hash_ptid (ptid));
+
+  /* A thread whose ptid has since been overwritten - say, to mark it
+     dead - is no longer found under its old ptid.  */
+  if (tp != NULL && !ptid_equal (tp->ptid, ptid))
+    return NULL;
+  return tp;
 }
+/* APPLE LOCAL end thread hash */
 
 /*
  * Thread iterator function.
@@ -217,23 +370,19 @@ iterate_over_threads (int (*callback) (struct thread_info *, void *),
 int
 valid_thread_id (int num)
 {
-  struct thread_info *tp;
-
-  for (tp = thread_list; tp; tp = tp->next)
-    if (tp->num == num)
-      return 1;
-
-  return 0;
+  /* APPLE LOCAL thread hash */
+  return find_thread_id (num) != NULL;
 }
 
 int
 pid_to_thread_id (ptid_t ptid)
 {
-  struct thread_info *tp;
+  /* APPLE LOCAL begin thread hash */
+  struct thread_info *tp = find_thread_pid (ptid);
 
-  for (tp = thread_list; tp; tp = tp->next)
-    if (ptid_equal (tp->ptid, ptid))
-      return tp->num;
+  if (tp != NULL)
+    return tp->num;
+  /* APPLE LOCAL end thread hash */
 
   return 0;
 }
@@ -250,15 +399,48 @@ thread_id_to_pid (int num)
 
 int
 in_thread_list (ptid_t ptid)
+{
+  /* APPLE LOCAL thread hash */
+  return find_thread_pid (ptid) != NULL;
+}
+
+/* APPLE LOCAL begin non-stop */
+void
+set_running (ptid_t ptid, int running)
+{
+  struct thread_info *tp;
+
+  if (ptid_equal (ptid, minus_one_ptid))
+    {
+      for (tp = thread_list; tp; tp = tp->next)
+	tp->running = running;
+      return;
+    }
+
+  tp = find_thread_pid (ptid);
+  if (tp != NULL)
+    tp->running = running;
+}
+
+int
+is_running (ptid_t ptid)
+{
+  struct thread_info *tp = find_thread_pid (ptid);
+
+  return tp != NULL && tp->running;
+}
+
+int
+any_running (void)
 {
   struct thread_info *tp;
 
   for (tp = thread_list; tp; tp = tp->next)
-    if (ptid_equal (tp->ptid, ptid))
+    if (tp->running)
       return 1;
-
-  return 0;			/* Never heard of 'im */
+  return 0;
 }
+/* APPLE LOCAL end non-stop */
 
 /* Print a list of thread ids currently known, and the total number of
    threads. To be used from within catch_errors. */
@@ -424,14 +606,21 @@ thread_alive (struct thread_info *tp)
 void
 prune_threads (void)
 {
-  struct thread_info *tp, *next;
+  /* APPLE LOCAL begin thread hash */
+  struct thread_info *tp, *next, *tpprev;
 
+  /* Unlink dead threads as we go, rather than looking each one up
+     again with delete_thread.  */
+  tpprev = NULL;
   for (tp = thread_list; tp; tp = next)
     {
       next = tp->next;
       if (!thread_alive (tp))
-	delete_thread (tp->ptid);
+	delete_thread_1 (tp, tpprev);
+      else
+	tpprev = tp;
     }
+  /* APPLE LOCAL end thread hash */
 }
 
 /* Print information about currently known threads 
@@ -447,7 +636,10 @@ info_threads_command (char *arg, int from_tty)
   struct thread_info *tp;
   ptid_t current_ptid;
   struct frame_info *cur_frame;
-  struct frame_id saved_frame_id = get_frame_id (get_selected_frame (NULL));
+  /* APPLE LOCAL non-stop: A running thread has no frames to save.  */
+  struct frame_id saved_frame_id
+    = is_running (inferior_ptid) ? null_frame_id
+				 : get_frame_id (get_selected_frame (NULL));
   char *extra_info;
   int longest_threadname = 0;
   int longest_portnum = 0;
@@ -546,6 +738,14 @@ info_threads_command (char *arg, int from_tty)
           ui_out_text (uiout, " ");
 	}
 
+      /* APPLE LOCAL begin non-stop */
+      if (tp->running)
+	{
+	  ui_out_text (uiout, "(running)\n");
+	  continue;
+	}
+      /* APPLE LOCAL end non-stop */
+
       switch_to_thread (tp->ptid);
       print_stack_frame (get_selected_frame (NULL), 0, LOCATION);
       /* APPLE LOCAL begin subroutine inlining  */
@@ -555,6 +755,10 @@ info_threads_command (char *arg, int from_tty)
 
   switch_to_thread (current_ptid);
 
+  /* APPLE LOCAL non-stop */
+  if (is_running (current_ptid))
+    return;
+
   /* Restores the frame set by the user before the "info threads"
      command.  We have finished the info-threads display by switching
      back to the current thread.  That switch has put us at the top of
@@ -603,6 +807,17 @@ switch_to_thread (ptid_t ptid)
   inferior_ptid = ptid;
   flush_cached_frames ();
   registers_changed ();
+
+  /* APPLE LOCAL begin non-stop */
+  /* A running thread's registers can't be read; there is no frame to
+     select until it stops.  */
+  if (is_running (ptid))
+    {
+      stop_pc = ~(CORE_ADDR) 0;
+      return;
+    }
+  /* APPLE LOCAL end non-stop */
+
   stop_pc = read_pc ();
   restore_thread_inlined_call_stack (inferior_ptid);
   /* APPLE LOCAL begin subroutine inlining  */
@@ -856,6 +1071,14 @@ do_captured_thread_select (struct ui_out *uiout,
         }
       ui_out_text (uiout, "]\n");
 
+      /* APPLE LOCAL begin non-stop */
+      if (is_running (inferior_ptid))
+	{
+	  ui_out_text (uiout, "(running)\n");
+	  return GDB_RC_OK;
+	}
+      /* APPLE LOCAL end non-stop */
+
       /* APPLE LOCAL begin subroutine inlining  */
       /* If we're inside an inlined function, we may have gotten there
 	 via a 'step' from the call site, which automatically flushes
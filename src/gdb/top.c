@@ -608,6 +608,11 @@ command_loop (void)
 #endif
 	}
 
+      /* APPLE LOCAL symbol memory limit: Not while reading a command
+         file; only between the commands the user types.  */
+      if (instream == stdin)
+        enforce_symbol_memory_limit ();
+
       execute_command (command, instream == stdin);
       /* Do any commands attached to breakpoint we stopped at.  */
       bpstat_do_actions (&stop_bpstat);
@@ -1377,12 +1377,33 @@ search_struct_field (char *name, struct value *arg1, int offset,
 		     struct type *type, int looking_for_baseclass)
 {
   int i;
-  int nbases = TYPE_N_BASECLASSES (type);
+  int nbases;
+  /* APPLE LOCAL begin struct field index */
+  int first_field, last_field;
+  /* APPLE LOCAL end struct field index */
 
   CHECK_TYPEDEF (type);
+  nbases = TYPE_N_BASECLASSES (type);
+
+  /* APPLE LOCAL begin struct field index */
+  first_field = nbases;
+  last_field = TYPE_NFIELDS (type) - 1;
+
+  /* If TYPE's field names are indexed, look only at the field that
+     has NAME, if there is one.  */
+  if (!looking_for_baseclass
+      && lookup_struct_field_index (type, name, 1, &i))
+    {
+      if (i < 0)
+	last_field = first_field - 1;
+      else
+	first_field = last_field = i;
+    }
+  /* APPLE LOCAL end struct field index */
 
   if (!looking_for_baseclass)
-    for (i = TYPE_NFIELDS (type) - 1; i >= nbases; i--)
+    /* APPLE LOCAL struct field index */
+    for (i = last_field; i >= first_field; i--)
       {
 	char *t_field_name = TYPE_FIELD_NAME (type, i);
 
@@ -2877,6 +2898,8 @@ value_of_local (const char *name, int complain)
     }
 
   b = SYMBOL_BLOCK_VALUE (func);
+  /* APPLE LOCAL lazy function bodies  */
+  block_expand_lazy (b);
   if (dict_empty (BLOCK_DICT (b)))
     {
       if (complain)
@@ -171,6 +171,324 @@ show_addressprint (struct ui_file *file, int from_tty,
 }
 
 
+/* APPLE LOCAL begin print prefetch */
+/* If nonzero, val_print reads the strings that the value it is about
+   to print points to in a few large reads, before printing any of
+   it.  */
+
+static int print_prefetch = 1;
+static void
+show_print_prefetch (struct ui_file *file, int from_tty,
+		     struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("\
+Prefetching of strings pointed to by printed values is %s.\n"),
+		    value);
+}
+
+/* The most bytes we prefetch for any one string; strings that are
+   longer are read the usual way once we run past the prefetched
+   part.  */
+#define PREFETCH_STRING_MAX 200
+
+/* Strings less than this many bytes apart are read together.  */
+#define PREFETCH_GAP 64
+
+/* The largest single read we will issue.  */
+#define PREFETCH_BLOCK_MAX 4096
+
+/* Don't let a string's prefetch run into the next of these, in case
+   that is where the string's readable memory ends.  */
+#define PREFETCH_PAGE_SIZE 4096
+
+/* Don't look for string pointers in more than this many nested
+   arrays and structs.  */
+#define PREFETCH_MAX_DEPTH 8
+
+/* A range of inferior memory: the extent of a string we expect to
+   print, and later a block of memory we have read.  */
+
+struct prefetch_range
+{
+  CORE_ADDR addr;
+  int len;
+  gdb_byte *contents;
+};
+
+/* The blocks read for the value val_print is printing, if any.  */
+
+static struct prefetch_range *prefetch_blocks;
+static int prefetch_nblocks;
+static int prefetch_active;
+
+/* The string extents we are collecting, while we plan a print.  */
+
+static struct prefetch_range *prefetch_plan;
+static int prefetch_plan_len;
+static int prefetch_plan_size;
+
+/* Return non-zero if TYPE is a pointer that c_val_print and friends
+   would print the string it points to for.  */
+
+static int
+string_pointer_type_p (struct type *type)
+{
+  struct type *target;
+
+  if (TYPE_CODE (type) != TYPE_CODE_PTR)
+    return 0;
+  target = check_typedef (TYPE_TARGET_TYPE (type));
+  return (TYPE_LENGTH (target) == 1 && TYPE_CODE (target) == TYPE_CODE_INT);
+}
+
+/* Return non-zero if a value of TYPE could contain a string pointer
+   that prefetch_collect would find.  */
+
+static int
+prefetch_type_p (struct type *type, int depth)
+{
+  int i;
+
+  type = check_typedef (type);
+  if (depth > PREFETCH_MAX_DEPTH)
+    return 0;
+
+  switch (TYPE_CODE (type))
+    {
+    case TYPE_CODE_PTR:
+      return string_pointer_type_p (type);
+
+    case TYPE_CODE_ARRAY:
+      return prefetch_type_p (TYPE_TARGET_TYPE (type), depth + 1);
+
+    case TYPE_CODE_STRUCT:
+    case TYPE_CODE_UNION:
+      for (i = 0; i < TYPE_NFIELDS (type); i++)
+	if (!TYPE_FIELD_STATIC (type, i)
+	    && TYPE_FIELD_BITSIZE (type, i) == 0
+	    && !(i < TYPE_N_BASECLASSES (type)
+		 && BASETYPE_VIA_VIRTUAL (type, i))
+	    && prefetch_type_p (TYPE_FIELD_TYPE (type, i), depth + 1))
+	  return 1;
+      return 0;
+
+    default:
+      return 0;
+    }
+}
+
+/* Record the extent of the string that the pointer at VALADDR, of
+   type TYPE, points to.  */
+
+static void
+prefetch_add_string (struct type *type, const gdb_byte *valaddr)
+{
+  CORE_ADDR addr = unpack_pointer (type, valaddr);
+  CORE_ADDR page_end;
+  int len;
+
+  if (addr == 0)
+    return;
+
+  /* val_print_string reads up to print_max characters, and then
+     peeks at one more.  */
+  len = PREFETCH_STRING_MAX;
+  if (print_max < PREFETCH_STRING_MAX)
+    len = print_max + 1;
+  page_end = (addr | (PREFETCH_PAGE_SIZE - 1)) + 1;
+  if (page_end != 0 && addr + len > page_end)
+    len = page_end - addr;
+
+  if (prefetch_plan_len == prefetch_plan_size)
+    {
+      prefetch_plan_size = prefetch_plan_size ? 2 * prefetch_plan_size : 64;
+      prefetch_plan = xrealloc (prefetch_plan,
+				prefetch_plan_size * sizeof (*prefetch_plan));
+    }
+  prefetch_plan[prefetch_plan_len].addr = addr;
+  prefetch_plan[prefetch_plan_len].len = len;
+  prefetch_plan[prefetch_plan_len].contents = NULL;
+  prefetch_plan_len++;
+}
+
+/* Collect the extents of the strings that printing the value of type
+   TYPE at VALADDR will print, as far as the "print elements" limit
+   lets us see.  */
+
+static void
+prefetch_collect (struct type *type, const gdb_byte *valaddr, int depth)
+{
+  int i;
+
+  type = check_typedef (type);
+  if (!prefetch_type_p (type, depth))
+    return;
+
+  switch (TYPE_CODE (type))
+    {
+    case TYPE_CODE_PTR:
+      prefetch_add_string (type, valaddr);
+      break;
+
+    case TYPE_CODE_ARRAY:
+      {
+	struct type *elttype = check_typedef (TYPE_TARGET_TYPE (type));
+	unsigned int eltlen = TYPE_LENGTH (elttype);
+	unsigned int len;
+
+	if (eltlen == 0)
+	  break;
+	len = TYPE_LENGTH (type) / eltlen;
+	if (len > print_max)
+	  len = print_max;
+	for (i = 0; i < len; i++)
+	  {
+	    /* A run of repeated elements is printed once.  */
+	    if (i > 0 && memcmp (valaddr + (i - 1) * eltlen,
+				 valaddr + i * eltlen, eltlen) == 0)
+	      continue;
+	    prefetch_collect (elttype, valaddr + i * eltlen, depth + 1);
+	  }
+      }
+      break;
+
+    case TYPE_CODE_STRUCT:
+    case TYPE_CODE_UNION:
+      for (i = 0; i < TYPE_NFIELDS (type); i++)
+	if (!TYPE_FIELD_STATIC (type, i)
+	    && TYPE_FIELD_BITSIZE (type, i) == 0
+	    && !(i < TYPE_N_BASECLASSES (type)
+		 && BASETYPE_VIA_VIRTUAL (type, i))
+	    && TYPE_FIELD_BITPOS (type, i) / 8
+	       + TYPE_LENGTH (check_typedef (TYPE_FIELD_TYPE (type, i)))
+	       <= TYPE_LENGTH (type))
+	  prefetch_collect (TYPE_FIELD_TYPE (type, i),
+			    valaddr + TYPE_FIELD_BITPOS (type, i) / 8,
+			    depth + 1);
+      break;
+
+    default:
+      break;
+    }
+}
+
+static int
+compare_prefetch_ranges (const void *a, const void *b)
+{
+  const struct prefetch_range *ra = a;
+  const struct prefetch_range *rb = b;
+
+  if (ra->addr < rb->addr)
+    return -1;
+  if (ra->addr > rb->addr)
+    return 1;
+  return 0;
+}
+
+/* Free the prefetched blocks.  */
+
+static void
+prefetch_cleanup (void *ignore)
+{
+  int i;
+
+  for (i = 0; i < prefetch_nblocks; i++)
+    xfree (prefetch_blocks[i].contents);
+  xfree (prefetch_blocks);
+  prefetch_blocks = NULL;
+  prefetch_nblocks = 0;
+  prefetch_plan_len = 0;
+  prefetch_active = 0;
+}
+
+/* Read the strings that printing the value of type TYPE at VALADDR
+   will print, merging nearby ones into a single read.  A block that
+   can't be read is dropped, and its strings are read the usual way
+   when they are printed.  The blocks stay around until the returned
+   cleanup is run.  */
+
+static struct cleanup *
+prefetch_for_print (struct type *type, const gdb_byte *valaddr)
+{
+  struct cleanup *cleanup;
+  int i, j;
+
+  prefetch_active = 1;
+  cleanup = make_cleanup (prefetch_cleanup, NULL);
+
+  prefetch_plan_len = 0;
+  prefetch_collect (type, valaddr, 0);
+  if (prefetch_plan_len == 0)
+    return cleanup;
+
+  qsort (prefetch_plan, prefetch_plan_len, sizeof (*prefetch_plan),
+	 compare_prefetch_ranges);
+
+  prefetch_blocks = xmalloc (prefetch_plan_len * sizeof (*prefetch_blocks));
+  for (i = 0; i < prefetch_plan_len; i = j)
+    {
+      CORE_ADDR start = prefetch_plan[i].addr;
+      CORE_ADDR end = start + prefetch_plan[i].len;
+      struct prefetch_range *block;
+
+      for (j = i + 1; j < prefetch_plan_len; j++)
+	{
+	  CORE_ADDR next_end = prefetch_plan[j].addr + prefetch_plan[j].len;
+
+	  if (prefetch_plan[j].addr > end + PREFETCH_GAP)
+	    break;
+	  if (next_end > end)
+	    {
+	      if (next_end - start > PREFETCH_BLOCK_MAX)
+		break;
+	      end = next_end;
+	    }
+	}
+
+      block = &prefetch_blocks[prefetch_nblocks];
+      block->addr = start;
+      block->len = end - start;
+      block->contents = xmalloc (block->len);
+      if (target_read_memory (start, block->contents, block->len) == 0)
+	prefetch_nblocks++;
+      else
+	xfree (block->contents);
+    }
+
+  return cleanup;
+}
+
+/* If the LEN bytes at MEMADDR were prefetched, copy them to MYADDR
+   and return non-zero.  */
+
+static int
+prefetched_memory_read (CORE_ADDR memaddr, gdb_byte *myaddr, int len)
+{
+  int lo = 0;
+  int hi = prefetch_nblocks;
+
+  /* Find the last block that starts at or before MEMADDR.  */
+  while (lo < hi)
+    {
+      int mid = (lo + hi) / 2;
+
+      if (prefetch_blocks[mid].addr <= memaddr)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  if (lo == 0)
+    return 0;
+  lo--;
+
+  if (memaddr + len > prefetch_blocks[lo].addr + prefetch_blocks[lo].len)
+    return 0;
+  memcpy (myaddr, prefetch_blocks[lo].contents
+		  + (memaddr - prefetch_blocks[lo].addr), len);
+  return 1;
+}
+/* APPLE LOCAL end print prefetch */
+
 /* Print data of type TYPE located at VALADDR (within GDB), which came from
    the inferior at address ADDRESS, onto stdio stream STREAM according to
    FORMAT (a letter, or 0 for natural format using TYPE).
@@ -215,6 +533,24 @@ val_print (struct type *type, const gdb_byte *valaddr, int embedded_offset,
       return (0);
     }
 
+  /* APPLE LOCAL begin print prefetch */
+  /* Read everything the strings in this value will need up front,
+     rather than a few bytes at a time as each string is printed.  */
+  if (print_prefetch && !prefetch_active
+      && (format == 0 || format == 's')
+      && prefetch_type_p (real_type, 0))
+    {
+      struct cleanup *cleanup;
+      int ret;
+
+      cleanup = prefetch_for_print (real_type, valaddr + embedded_offset);
+      ret = LA_VAL_PRINT (type, valaddr, embedded_offset, address,
+			  stream, format, deref_ref, recurse, pretty);
+      do_cleanups (cleanup);
+      return ret;
+    }
+  /* APPLE LOCAL end print prefetch */
+
   return (LA_VAL_PRINT (type, valaddr, embedded_offset, address,
 			stream, format, deref_ref, recurse, pretty));
 }
@@ -1114,6 +1450,15 @@ partial_memory_read (CORE_ADDR memaddr, char *myaddr, int len, int *errnoptr)
   int nread;			/* Number of bytes actually read. */
   int errcode;			/* Error from last read. */
 
+  /* APPLE LOCAL begin print prefetch */
+  if (prefetch_nblocks > 0 && prefetched_memory_read (memaddr, myaddr, len))
+    {
+      if (errnoptr != NULL)
+	*errnoptr = 0;
+      return len;
+    }
+  /* APPLE LOCAL end print prefetch */
+
   /* First try a complete read. */
   errcode = target_read_memory (memaddr, myaddr, len);
   if (errcode == 0)
@@ -1275,7 +1620,9 @@ val_print_string (CORE_ADDR addr, int len, int width, struct ui_file *stream)
 
       peekbuf = (char *) alloca (width);
 
-      if (target_read_memory (addr, peekbuf, width) == 0
+      /* APPLE LOCAL print prefetch */
+      if ((prefetched_memory_read (addr, peekbuf, width)
+	   || target_read_memory (addr, peekbuf, width) == 0)
 	  && extract_unsigned_integer (peekbuf, width) != 0)
 	force_ellipsis = 1;
     }
@@ -1525,6 +1872,18 @@ Show printing of addresses."), NULL,
 			   show_addressprint,
 			   &setprintlist, &showprintlist);
 
+  /* APPLE LOCAL begin print prefetch */
+  add_setshow_boolean_cmd ("prefetch", class_support, &print_prefetch, _("\
+Set prefetching of strings pointed to by printed values."), _("\
+Show prefetching of strings pointed to by printed values."), _("\
+When on, printing an array or structure first reads the strings its\n\
+character pointers point to, merging nearby strings into one read,\n\
+instead of reading each string a few bytes at a time as it is printed."),
+			   NULL,
+			   show_print_prefetch,
+			   &setprintlist, &showprintlist);
+  /* APPLE LOCAL end print prefetch */
+
   add_setshow_uinteger_cmd ("input-radix", class_support, &input_radix, _("\
 Set default input radix for entering numbers."), _("\
 Show default input radix for entering numbers."), NULL,
@@ -154,6 +154,13 @@ struct value
      reset, be sure to consider this use as well!  */
   char lazy;
 
+  /* APPLE LOCAL begin value free list */
+  /* Non-zero if this value's storage has room for VALUE_SMALL_CONTENTS
+     bytes of contents, so it can be put on the free list and reused
+     for any small value.  */
+  char recyclable;
+  /* APPLE LOCAL end value free list */
+
   /* APPLE LOCAL begin variable opt states.  */
   /* Value represents what happened to a variable whose value is currently
      unavailable for some reason.  */
@@ -231,6 +238,8 @@ lookup_cached_function (struct cached_value *cval)
 {
   struct value *val = NULL;
   struct value *next = NULL;
+  /* APPLE LOCAL value free list */
+  int recyclable;
 
   if (cval->generation != symbol_generation)
     {
@@ -251,8 +260,12 @@ lookup_cached_function (struct cached_value *cval)
 
   val = allocate_value (cval->val.type);
   next = val->next;
+  /* APPLE LOCAL value free list */
+  recyclable = val->recyclable;
   *val = cval->val;
   val->next = next;
+  /* APPLE LOCAL value free list */
+  val->recyclable = recyclable;
 
   return val;
 }
@@ -263,6 +276,9 @@ static void show_values (char *, int);
 
 static void show_convenience (char *, int);
 
+/* APPLE LOCAL value history spill */
+static void enforce_value_history_limit (struct value *keep);
+
 
 /* The value-history records all the values printed
    by print commands during this session.  Each chunk
@@ -276,6 +292,14 @@ struct value_history_chunk
   {
     struct value_history_chunk *next;
     struct value *values[VALUE_HISTORY_CHUNK];
+    /* APPLE LOCAL begin value history spill */
+    /* Where in value_history_spill_file each value's contents are,
+       or -1 if they are still in memory.  */
+    long spill_offset[VALUE_HISTORY_CHUNK];
+    /* When each value was last recorded or accessed, in
+       value_history_tick units.  */
+    unsigned long last_use[VALUE_HISTORY_CHUNK];
+    /* APPLE LOCAL end value history spill */
   };
 
 /* Chain of chunks now in use.  */
@@ -283,6 +307,47 @@ struct value_history_chunk
 static struct value_history_chunk *value_history_chain;
 
 static int value_history_count;	/* Abs number of last entry stored */
+
+/* APPLE LOCAL begin value history spill */
+/* Values in the history at least this large are candidates for
+   having their contents written out to a spill file.  */
+
+#define VALUE_HISTORY_SPILL_MIN (64 * 1024)
+
+/* The most bytes of contents of such large values to keep in memory,
+   or UINT_MAX for no limit.  Past that, the least recently used ones
+   are spilled.  */
+
+static unsigned int value_history_limit = 64 * 1024 * 1024;
+static void
+show_value_history_limit (struct ui_file *file, int from_tty,
+			  struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("\
+Limit on the memory used by large values in the value history is %s.\n"),
+		    value);
+}
+
+static void
+set_value_history_limit (char *args, int from_tty, struct cmd_list_element *c)
+{
+  enforce_value_history_limit (NULL);
+}
+
+/* The bytes of contents of large history values now in memory.  */
+
+static ULONGEST value_history_resident;
+
+/* The file spilled contents are written to, created when first
+   needed, and the offset of its end.  */
+
+static FILE *value_history_spill_file;
+static long value_history_spill_end;
+
+/* Counts recordings of and accesses to the value history.  */
+
+static unsigned long value_history_tick;
+/* APPLE LOCAL end value history spill */
 
 /* List of all value objects currently allocated
    (except for those released by calls to release_value)
@@ -290,6 +355,37 @@ static int value_history_count;	/* Abs number of last entry stored */
 
 static struct value *all_values;
 
+/* APPLE LOCAL begin value free list */
+/* Evaluating an expression makes and frees many values, nearly all
+   of them scalars.  Rather than go to malloc for each one, values
+   whose contents fit in VALUE_SMALL_CONTENTS bytes all get storage
+   of that size, and value_free keeps up to VALUE_FREE_LIST_MAX of
+   them on a free list, chained through their NEXT fields, for
+   allocate_value to reuse.  */
+
+#define VALUE_SMALL_CONTENTS 16
+#define VALUE_FREE_LIST_MAX 1024
+
+static struct value *value_free_list;
+static int value_free_list_length;
+
+/* The number of values allocate_value has made, and how many of
+   those it had to get from malloc.  */
+
+static unsigned long value_allocations;
+static unsigned long value_heap_allocations;
+
+/* Store in *VALUES the number of values allocated so far, and in
+   *HEAP how many of them needed a fresh block of memory.  */
+
+void
+value_allocation_counts (unsigned long *values, unsigned long *heap)
+{
+  *values = value_allocations;
+  *heap = value_heap_allocations;
+}
+/* APPLE LOCAL end value free list */
+
 /* Allocate a  value  that has the correct length for type TYPE.  */
 
 struct value *
@@ -298,7 +394,32 @@ allocate_value (struct type *type)
   struct value *val;
   struct type *atype = check_typedef (type);
 
-  val = (struct value *) xzalloc (sizeof (struct value) + TYPE_LENGTH (atype));
+  /* APPLE LOCAL begin value free list */
+  value_allocations++;
+  if (TYPE_LENGTH (atype) <= VALUE_SMALL_CONTENTS)
+    {
+      if (value_free_list != NULL)
+	{
+	  val = value_free_list;
+	  value_free_list = val->next;
+	  value_free_list_length--;
+	  memset (val, 0, sizeof (struct value) + VALUE_SMALL_CONTENTS);
+	}
+      else
+	{
+	  value_heap_allocations++;
+	  val = (struct value *) xzalloc (sizeof (struct value)
+					  + VALUE_SMALL_CONTENTS);
+	}
+      val->recyclable = 1;
+    }
+  else
+    {
+      value_heap_allocations++;
+      val = (struct value *) xzalloc (sizeof (struct value)
+				      + TYPE_LENGTH (atype));
+    }
+  /* APPLE LOCAL end value free list */
   val->next = all_values;
   all_values = val;
   val->type = type;
@@ -572,6 +693,16 @@ value_free_to_mark (struct value *mark)
 void
 value_free (struct value *val)
 {
+  /* APPLE LOCAL begin value free list */
+  if (val != NULL && val->recyclable
+      && value_free_list_length < VALUE_FREE_LIST_MAX)
+    {
+      val->next = value_free_list;
+      value_free_list = val;
+      value_free_list_length++;
+      return;
+    }
+  /* APPLE LOCAL end value free list */
   xfree (val);
 }
 
@@ -668,6 +799,77 @@ value_copy (struct value *arg)
 
 /* Access to the value history.  */
 
+/* APPLE LOCAL begin value history spill */
+/* Write the contents of value I of CHUNK to the spill file, and
+   shrink the value to just its header.  The value is marked lazy,
+   since its contents are no longer there.  Return non-zero if that
+   worked; otherwise leave the value alone.  */
+
+static int
+spill_value_history_entry (struct value_history_chunk *chunk, int i)
+{
+  struct value *val = chunk->values[i];
+  int len = TYPE_LENGTH (value_enclosing_type (val));
+
+  if (value_history_spill_file == NULL)
+    {
+      value_history_spill_file = tmpfile ();
+      if (value_history_spill_file == NULL)
+	return 0;
+      value_history_spill_end = 0;
+    }
+
+  if (fseek (value_history_spill_file, value_history_spill_end, SEEK_SET) != 0
+      || fwrite (value_contents_all_raw (val), 1, len,
+		 value_history_spill_file) != len)
+    return 0;
+
+  chunk->spill_offset[i] = value_history_spill_end;
+  value_history_spill_end += len;
+  value_history_resident -= len;
+
+  val = (struct value *) xrealloc (val, sizeof (struct value));
+  val->lazy = 1;
+  chunk->values[i] = val;
+  return 1;
+}
+
+/* Spill the least recently used large values in the history until
+   the ones left in memory fit in value_history_limit.  Never spill
+   KEEP, if it is not NULL: that is the value being recorded, which
+   the caller still has a pointer to and goes on to print.  */
+
+static void
+enforce_value_history_limit (struct value *keep)
+{
+  while (value_history_resident > value_history_limit)
+    {
+      struct value_history_chunk *chunk;
+      struct value_history_chunk *lru_chunk = NULL;
+      int lru_index = 0;
+      int i;
+
+      for (chunk = value_history_chain; chunk != NULL; chunk = chunk->next)
+	for (i = 0; i < VALUE_HISTORY_CHUNK; i++)
+	  if (chunk->values[i] != NULL
+	      && chunk->values[i] != keep
+	      && chunk->spill_offset[i] < 0
+	      && (TYPE_LENGTH (value_enclosing_type (chunk->values[i]))
+		  >= VALUE_HISTORY_SPILL_MIN)
+	      && (lru_chunk == NULL
+		  || chunk->last_use[i] < lru_chunk->last_use[lru_index]))
+	    {
+	      lru_chunk = chunk;
+	      lru_index = i;
+	    }
+
+      if (lru_chunk == NULL
+	  || !spill_value_history_entry (lru_chunk, lru_index))
+	return;
+    }
+}
+/* APPLE LOCAL end value history spill */
+
 /* Record a new value in the value history.
    Returns the absolute history index of the entry.
    Result of -1 indicates the value was not saved; otherwise it is the
@@ -706,6 +908,16 @@ record_latest_value (struct value *val)
 
   value_history_chain->values[i] = val;
 
+  /* APPLE LOCAL begin value history spill */
+  value_history_chain->spill_offset[i] = -1;
+  value_history_chain->last_use[i] = ++value_history_tick;
+  if (TYPE_LENGTH (value_enclosing_type (val)) >= VALUE_HISTORY_SPILL_MIN)
+    {
+      value_history_resident += TYPE_LENGTH (value_enclosing_type (val));
+      enforce_value_history_limit (val);
+    }
+  /* APPLE LOCAL end value history spill */
+
   /* Now we regard value_history_count as origin-one
      and applying to the value just stored.  */
 
@@ -720,6 +932,8 @@ access_value_history (int num)
   struct value_history_chunk *chunk;
   int i;
   int absnum = num;
+  /* APPLE LOCAL value history spill */
+  struct value *val;
 
   if (absnum <= 0)
     absnum += value_history_count;
@@ -745,7 +959,26 @@ access_value_history (int num)
        i > 0; i--)
     chunk = chunk->next;
 
-  return value_copy (chunk->values[absnum % VALUE_HISTORY_CHUNK]);
+  /* APPLE LOCAL begin value history spill */
+  i = absnum % VALUE_HISTORY_CHUNK;
+  chunk->last_use[i] = ++value_history_tick;
+  val = value_copy (chunk->values[i]);
+  if (chunk->spill_offset[i] >= 0)
+    {
+      /* Read the contents back into the copy; the history entry
+	 itself stays spilled.  */
+      int len = TYPE_LENGTH (value_enclosing_type (val));
+
+      if (fseek (value_history_spill_file, chunk->spill_offset[i],
+		 SEEK_SET) != 0
+	  || fread (value_contents_all_raw (val), 1, len,
+		    value_history_spill_file) != len)
+	error (_("Couldn't read $%d back from the value history spill file."),
+	       absnum + 1);
+      val->lazy = 0;
+    }
+  return val;
+  /* APPLE LOCAL end value history spill */
 }
 
 /* Clear the value history entirely.
@@ -769,6 +1002,15 @@ clear_value_history (void)
       value_history_chain = next;
     }
   value_history_count = 0;
+
+  /* APPLE LOCAL begin value history spill */
+  value_history_resident = 0;
+  if (value_history_spill_file != NULL)
+    {
+      fclose (value_history_spill_file);
+      value_history_spill_file = NULL;
+    }
+  /* APPLE LOCAL end value history spill */
 }
 
 static void
@@ -922,6 +1164,54 @@ clear_internalvars (void)
     }
 }
 
+/* APPLE LOCAL begin symbol memory limit */
+/* Return non-zero if TYPE, or a type it is derived from, belongs to
+   OBJFILE.  */
+
+static int
+type_uses_objfile (struct type *type, struct objfile *objfile)
+{
+  for (; type != NULL; type = TYPE_TARGET_TYPE (type))
+    if (TYPE_OBJFILE (type) == objfile)
+      return 1;
+  return 0;
+}
+
+/* Return non-zero if VAL has a type belonging to OBJFILE.  */
+
+int
+value_uses_objfile (struct value *val, struct objfile *objfile)
+{
+  return (type_uses_objfile (val->type, objfile)
+	  || type_uses_objfile (val->enclosing_type, objfile));
+}
+
+/* Return non-zero if a value in the history or in a convenience
+   variable has a type belonging to OBJFILE, and so would be left
+   pointing at freed memory if the symbols of OBJFILE went away.  */
+
+int
+values_use_objfile (struct objfile *objfile)
+{
+  struct value_history_chunk *chunk;
+  struct internalvar *var;
+  struct value *val;
+  int i;
+
+  for (chunk = value_history_chain; chunk != NULL; chunk = chunk->next)
+    for (i = 0; i < VALUE_HISTORY_CHUNK; i++)
+      if ((val = chunk->values[i]) != NULL
+	  && value_uses_objfile (val, objfile))
+	return 1;
+
+  for (var = internalvars; var != NULL; var = var->next)
+    if (value_uses_objfile (var->value, objfile))
+      return 1;
+
+  return 0;
+}
+/* APPLE LOCAL end symbol memory limit */
+
 static void
 show_convenience (char *ignore, int from_tty)
 {
@@ -1281,13 +1571,18 @@ value_change_enclosing_type (struct value *val, struct type *new_encl_type)
       new_val = (struct value *) xrealloc (val, sizeof (struct value) + TYPE_LENGTH (new_encl_type));
 
       new_val->enclosing_type = new_encl_type;
+      /* APPLE LOCAL value free list */
+      new_val->recyclable = 0;
  
       /* We have to make sure this ends up in the same place in the value
 	 chain as the original copy, so it's clean-up behavior is the same. 
 	 If the value has been released, this is a waste of time, but there
 	 is no way to tell that in advance, so... */
       
-      if (val != all_values) 
+      /* APPLE LOCAL: Keep all_values pointing at the new copy too.  */
+      if (val == all_values)
+	all_values = new_val;
+      else
 	{
 	  for (prev = all_values; prev != NULL; prev = prev->next)
 	    {
@@ -1772,4 +2067,17 @@ A few convenience variables are given values automatically:\n\
   add_cmd ("values", no_class, show_values,
 	   _("Elements of value history around item number IDX (or last ten)."),
 	   &showlist);
+
+  /* APPLE LOCAL begin value history spill */
+  add_setshow_uinteger_cmd ("value-limit", no_class, &value_history_limit, _("\
+Set the memory kept for large values in the value history."), _("\
+Show the memory kept for large values in the value history."), _("\
+Values of 64K or more that are recorded in the value history count\n\
+towards this many bytes.  Past that, the contents of the least recently\n\
+used ones are moved to a temporary file and read back when they are\n\
+needed.  \"set history value-limit 0\" removes the limit."),
+			    set_value_history_limit,
+			    show_value_history_limit,
+			    &sethistlist, &showhistlist);
+  /* APPLE LOCAL end value history spill */
 }
@@ -488,6 +488,10 @@ extern void value_free (struct value *);
 
 extern void free_all_values (void);
 
+/* APPLE LOCAL value free list */
+extern void value_allocation_counts (unsigned long *values,
+				     unsigned long *heap);
+
 extern void release_value (struct value *val);
 
 extern int record_latest_value (struct value *val);
@@ -555,6 +559,12 @@ extern void clear_value_history (void);
 
 extern void clear_internalvars (void);
 
+/* APPLE LOCAL begin symbol memory limit */
+extern int value_uses_objfile (struct value *val, struct objfile *objfile);
+
+extern int values_use_objfile (struct objfile *objfile);
+/* APPLE LOCAL end symbol memory limit */
+
 /* From values.c */
 
 extern struct value *value_copy (struct value *);